@@ -0,0 +1,157 @@
+/*
+    PcmConvertTest.cpp - TEMPORARY / PROTOTYPE
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* ============================================================================================== */
+/* ================ 10/26 The SSE2 sample conversion must match the plain one =================== */
+
+// the kernels are internal to this translation unit, thus included directly;
+// compile with -fno-fast-math, as set for PcmConvert.cpp in src/CMakeLists.txt
+#include "MusicIO/PcmConvert.cpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+using std::string;
+using std::vector;
+using std::cout;
+using std::endl;
+
+
+#define CHECK(COND) \
+    if (not (COND)) {\
+        cout << "FAIL: Line "<<__LINE__<<": " #COND <<endl; \
+        std::terminate();\
+    }
+
+
+namespace {
+    const int BITS[] = {16, 24, 32};
+
+    /* samples the converter must handle: in range, beyond full scale, and not finite */
+    vector<float> makeSamples(size_t cnt, std::mt19937& rand)
+    {
+        const float INF = std::numeric_limits<float>::infinity();
+        const float NaN = std::numeric_limits<float>::quiet_NaN();
+        const float special[] = {0.0f, -0.0f, 1.0f, -1.0f, 1.0666f, -1.0667f, 1.5f, -1.5f,
+                                 1e30f, -1e30f, INF, -INF, NaN, -NaN,
+                                 std::numeric_limits<float>::denorm_min(),
+                                 std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                                 0.5f / 0x7800, 1.5f / 0x7800, -2.5f / 0x7800};  // ties, for round to nearest
+        std::uniform_real_distribution<float> wide{-2.0f, 2.0f};
+        std::uniform_int_distribution<size_t> pick{0, sizeof(special) / sizeof(float) - 1};
+        vector<float> smps(cnt);
+        for (size_t i = 0; i < cnt; ++i)
+            smps[i] = (i % 5 == 0)? special[pick(rand)] : wide(rand);
+        return smps;
+    }
+}
+
+
+void run_PcmConvertTest()
+{
+    cout << "\n■□■□■□■□■□■□■□■□◆•Pcm-Convert-Test•◆□■□■□■□■□■□■□■□■\n"<<endl;
+#ifndef HAVE_SSE2_KERNEL
+    cout << "no SSE2 kernel on this platform, nothing to compare" <<endl;
+#else
+    std::mt19937 rand{0x5EED};
+
+    // =============================================== NaN is silence on both paths
+    for (int bits : BITS)
+    {
+        Format format{bits, true};
+        size_t bytes = 2 * format.sampleBytes();
+        float nan[4] = {NAN, NAN, NAN, NAN};
+        vector<uint8_t> viaSSE(4 * bytes, 0xAA), viaPlain(4 * bytes, 0xAA), zero(4 * bytes, 0);
+        CHECK(interleaveSSE2(nan, nan, viaSSE.data(), 4, format) == 4);
+        interleavePlain(nan, nan, viaPlain.data(), 4, bytes, format);
+        CHECK(viaSSE == zero);
+        CHECK(viaPlain == zero);
+    }
+
+    // =============================================== saturation at both ends
+    for (int bits : BITS)
+    {
+        Format format{bits, true};
+        size_t bytes = 2 * format.sampleBytes();
+        float high[4] = {2.0f, 2.0f, 2.0f, 2.0f};
+        float low[4]  = {-2.0f, -2.0f, -2.0f, -2.0f};
+        vector<uint8_t> viaSSE(4 * bytes), viaPlain(4 * bytes);
+        interleaveSSE2(high, low, viaSSE.data(), 4, format);
+        interleavePlain(high, low, viaPlain.data(), 4, bytes, format);
+        CHECK(viaSSE == viaPlain);
+        int32_t left = 0, right = 0;
+        memcpy(&left, &viaPlain[0], format.sampleBytes());
+        memcpy(&right, &viaPlain[format.sampleBytes()], format.sampleBytes());
+        if (bits == 16)
+        {
+            CHECK(int16_t(left) == 32767);
+            CHECK(int16_t(right) == -32768);
+        }
+        else if (bits == 24)
+        {
+            CHECK(left == 0x7fffff);
+            CHECK(right == 0x800000);   // -2^23, as 3 bytes
+        }
+        else
+        {
+            CHECK(left == int32_t(MAX32));
+            CHECK(right == int32_t(-MAX32 - 1));
+        }
+    }
+
+    // =============================================== random buffers, all formats, bit by bit
+    size_t rounds = 0;
+    for (int bits : BITS)
+        for (int round = 0; round < 1000; ++round, ++rounds)
+        {
+            Format format{bits, true};
+            size_t frames = std::uniform_int_distribution<size_t>{1, 1024}(rand);
+            vector<float> left = makeSamples(frames, rand);
+            vector<float> right = makeSamples(frames, rand);
+            size_t bytes = 2 * format.sampleBytes();
+            vector<uint8_t> viaSSE(frames * bytes), viaPlain(frames * bytes), viaApi(frames * bytes);
+
+            size_t done = interleaveSSE2(left.data(), right.data(), viaSSE.data(), frames, format);
+            CHECK(done == frames - frames % 4);
+            interleavePlain(left.data() + done, right.data() + done, viaSSE.data() + done * bytes,
+                            frames - done, bytes, format);
+            interleavePlain(left.data(), right.data(), viaPlain.data(), frames, bytes, format);
+            pcm::interleave(left.data(), right.data(), viaApi.data(), frames, bytes, format);
+            if (viaSSE != viaPlain)
+            {
+                size_t pos = 0;
+                while (viaSSE[pos] == viaPlain[pos])
+                    ++pos;
+                size_t frame = pos / bytes;
+                cout << bits << " bit, frame " << frame << " of " << frames
+                     << ": left " << left[frame] << " right " << right[frame] << endl;
+            }
+            CHECK(viaSSE == viaPlain);
+            CHECK(viaApi == viaPlain);
+        }
+    cout << "compared " << rounds << " buffers" <<endl;
+#endif
+    cout << "Bye Cruel World..." <<endl;
+}
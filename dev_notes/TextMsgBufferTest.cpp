@@ -0,0 +1,208 @@
+/*
+    TextMsgBufferTest.cpp - TEMPORARY / PROTOTYPE
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* ============================================================================================== */
+/* ================ 10/26 Stress test: many threads pushing to the TextMsgBuffer ================ */
+
+#include "Misc/TextMsgBuffer.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <utility>
+
+using std::string;
+using std::cout;
+using std::endl;
+
+
+#define CHECK(COND) \
+    if (not (COND)) {\
+        cout << "FAIL: Line "<<__LINE__<<": " #COND <<endl; \
+        std::terminate();\
+    }
+
+
+namespace {
+    const size_t PRODUCERS   = 8;
+    const size_t CONSUMERS   = 3;
+    const size_t MESSAGES    = 20000;                         // per producer
+    const size_t OUTSTANDING = TextMsgBuffer::SLOTS / 2;      // keeps the table from filling up
+
+    /* distinct for each message; every 97th is longer than the reserved storage */
+    string makeText(size_t producer, size_t seq)
+    {
+        string text = "P" + std::to_string(producer) + "-" + std::to_string(seq) + ":";
+        if (seq % 97 == 0)
+            text += string(TextMsgBuffer::TEXT_RESERVE + seq % 13, char('a' + producer));
+        else
+            text += string(seq % 61, char('a' + producer));
+        return text;
+    }
+
+    /* IDs handed from the producers to the consumers, as between threads of Yoshimi */
+    struct Handover
+    {
+        std::mutex mtx;
+        std::deque<std::pair<int, string>> queue;
+        std::atomic<size_t> outstanding{0};
+        std::atomic<size_t> producing{PRODUCERS};
+        std::atomic<size_t> fetched{0};
+        std::atomic<size_t> wrong{0};
+        std::atomic<size_t> invalid{0};
+    };
+}
+
+
+
+void run_TextMsgBufferTest()
+{
+    cout << "\n■□■□■□■□■□■□■□■□◆•Text-Msg-Buffer-Test•◆□■□■□■□■□■□■□■□■\n"<<endl;
+
+    TextMsgBuffer& buffer = TextMsgBuffer::instance();
+    buffer.clear();
+    TextMsgBuffer::Stats before = buffer.stats();
+
+    // =============================================== single thread: push, peek and fetch
+    CHECK(buffer.push("") == NO_MSG);
+    int id = buffer.push("Hello");
+    CHECK(id >= 0 and id < NO_MSG);
+    CHECK(buffer.fetch(id, false) == "Hello");    // peek leaves it in place
+    CHECK(buffer.fetch(id) == "Hello");
+    CHECK(buffer.fetch(id) == "");                // ...but fetch is destructive
+    CHECK(buffer.fetch(-1) == "");
+    CHECK(buffer.fetch(NO_MSG) == "");
+
+
+    // =============================================== many producers, several consumers
+    Handover handover;
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < PRODUCERS; ++p)
+        threads.emplace_back([&handover, &buffer, p]
+            {
+                for (size_t seq = 0; seq < MESSAGES; ++seq)
+                {
+                    while (handover.outstanding.load() >= OUTSTANDING)
+                        std::this_thread::yield();
+                    ++handover.outstanding;
+                    string text = makeText(p, seq);
+                    int pos = buffer.push(text);
+                    if (pos < 0 or pos >= NO_MSG)
+                    {
+                        ++handover.invalid;
+                        --handover.outstanding;
+                        continue;
+                    }
+                    std::lock_guard<std::mutex> guard(handover.mtx);
+                    handover.queue.emplace_back(pos, std::move(text));
+                }
+                --handover.producing;
+            });
+    for (size_t c = 0; c < CONSUMERS; ++c)
+        threads.emplace_back([&handover, &buffer]
+            {
+                while (true)
+                {
+                    std::pair<int, string> entry{-1, ""};
+                    {
+                        std::lock_guard<std::mutex> guard(handover.mtx);
+                        if (not handover.queue.empty())
+                        {
+                            entry = std::move(handover.queue.front());
+                            handover.queue.pop_front();
+                        }
+                    }
+                    if (entry.first < 0)
+                    {
+                        if (handover.producing.load() == 0 and handover.outstanding.load() == 0)
+                            return;
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (buffer.fetch(entry.first) != entry.second)
+                        ++handover.wrong;
+                    ++handover.fetched;
+                    --handover.outstanding;
+                }
+            });
+    for (std::thread& t : threads)
+        t.join();
+
+    TextMsgBuffer::Stats stressed = buffer.stats();
+    cout << "fetched " << handover.fetched.load() << " messages, highest slot " << stressed.highWater
+         << ", oversized " << stressed.oversized - before.oversized << endl;
+    CHECK(handover.invalid.load() == 0);
+    CHECK(handover.wrong.load() == 0);
+    CHECK(handover.fetched.load() == PRODUCERS * MESSAGES);
+    CHECK(stressed.full == before.full);
+    CHECK(stressed.highWater < OUTSTANDING + PRODUCERS);   // the limit is checked before counting
+    CHECK(stressed.oversized - before.oversized == PRODUCERS * ((MESSAGES + 96) / 97));
+    buffer.clear();
+    CHECK(buffer.stats().leaked == before.leaked);   // nothing left behind
+
+
+    // =============================================== all producers together fill every slot
+    std::mutex mtx;
+    std::set<int> claimed;
+    std::atomic<size_t> rejected{0};
+    threads.clear();
+    for (size_t p = 0; p < PRODUCERS; ++p)
+        threads.emplace_back([&, p]
+            {
+                for (size_t seq = 0; seq < TextMsgBuffer::SLOTS; ++seq)
+                {
+                    int pos = buffer.push(makeText(p, seq));
+                    if (pos < 0)
+                    {
+                        ++rejected;
+                        continue;
+                    }
+                    std::lock_guard<std::mutex> guard(mtx);
+                    CHECK(claimed.insert(pos).second); // no slot handed out twice
+                }
+            });
+    for (std::thread& t : threads)
+        t.join();
+
+    TextMsgBuffer::Stats filled = buffer.stats();
+    CHECK(claimed.size() == TextMsgBuffer::SLOTS);
+    CHECK(rejected.load() == PRODUCERS * TextMsgBuffer::SLOTS - TextMsgBuffer::SLOTS);
+    CHECK(filled.full - stressed.full == rejected.load());  // counted, rather than reported on the console
+    CHECK(filled.highWater == TextMsgBuffer::SLOTS - 1);
+
+    // a slot fetched is available again
+    int first = *claimed.begin();
+    CHECK(not buffer.fetch(first).empty());
+    CHECK(buffer.push("again") == first);
+    CHECK(buffer.fetch(first) == "again");
+
+    // messages never fetched are found as leaks
+    buffer.clear();
+    CHECK(buffer.stats().leaked - filled.leaked == TextMsgBuffer::SLOTS - 1);
+    CHECK(buffer.push("after") >= 0);
+    buffer.clear();
+
+    cout << "Bye Cruel World..." <<endl;
+}
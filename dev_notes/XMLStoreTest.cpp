@@ -25,11 +25,15 @@
 
 #include "Misc/FileMgrFuncs.h"
 #include "Misc/SynthEngine.h"
+#include "Misc/Part.h"
 
 #include <iostream>
 #include <string>
 #include <memory>
 #include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
 #include <cmath>
 
 using std::string;
@@ -44,6 +48,76 @@ using std::endl;
     }
 
 
+namespace {
+    /* top element rendered as XML, which is what the binary form must reproduce */
+    string renderContent(XMLStore& xml)
+    {
+        char* rendered = xml.accessTop().render();
+        string content{rendered? rendered : ""};
+        free(rendered);
+        return content;
+    }
+
+    /* encode -> decode in memory and through a file; must render the same XML */
+    string verifyBinaryRoundTrip(XMLStore& original, string const& label, Logger const& log)
+    {
+        string expected = renderContent(original);
+        string data = original.renderBinary();
+        CHECK(not data.empty());
+        CHECK(XMLStore::isBinary(data.data(), data.size()));
+
+        XMLStore decoded{data.data(), data.size()};
+        CHECK(decoded);
+        CHECK(renderContent(decoded) == expected);
+        CHECK(decoded.renderBinary() == data);   // stable when encoded again
+
+        const string BINFILE{"heffalump-" + label + ".bin"};
+        CHECK(original.saveBinaryFile(BINFILE, log));
+        XMLStore loaded{BINFILE, log};
+        CHECK(loaded);
+        CHECK(renderContent(loaded) == expected);
+        file::deleteFile(BINFILE);
+
+        cout << label << ": XML " << expected.size() << " bytes, binary " << data.size() << " bytes" << endl;
+        return data;
+    }
+
+    /* layout of the header (see BinHeader in XMLStore.cpp) */
+    const size_t POS_VERSION     = 8;
+    const size_t POS_BYTE_ORDER  = 12;
+    const size_t POS_NUM_STRINGS = 16;
+    const size_t POS_NUM_NODES   = 20;
+    const size_t HEADER_SIZE     = 32;
+
+    uint32_t readField(string const& data, size_t pos)
+    {
+        uint32_t val;
+        memcpy(&val, data.data() + pos, sizeof(val));
+        return val;
+    }
+
+    string withField(string data, size_t pos, uint32_t val)
+    {
+        memcpy(&data[pos], &val, sizeof(val));
+        return data;
+    }
+
+    /* damaged data must yield an empty store, both from memory and from a file */
+    void verifyRejected(string data, string const& label, Logger const& log)
+    {
+        XMLStore decoded{data.data(), data.size()};
+        CHECK(not decoded);
+
+        const string BINFILE{"heffalump-broken.bin"};
+        CHECK(file::saveData(&data[0], data.size(), BINFILE) == ssize_t(data.size()));
+        XMLStore loaded{BINFILE, log};
+        CHECK(not loaded);
+        file::deleteFile(BINFILE);
+        cout << "rejected: " << label << endl;
+    }
+}
+
+
 void run_XMLStoreTest(SynthEngine& synth)
 {
     cout << "+++ Test XML handling................................." << endl;
@@ -151,5 +225,68 @@ void run_XMLStoreTest(SynthEngine& synth)
     const string TESTFILE{"heffalump.xml"};
     CHECK(xml.saveXMLfile(TESTFILE,synth.getRuntime().getLogger()))
 
+
+
+    cout <<"Verify compact binary form..." << endl;
+    Logger const& log = synth.getRuntime().getLogger();
+
+    XMLStore instrument{TOPLEVEL::XML::Instrument};
+    XMLtree instrumentTop = instrument.accessTop();
+    synth.part[0]->add2XML_YoshimiInstrument(instrumentTop);
+    string instrumentData = verifyBinaryRoundTrip(instrument, "instrument", log);
+
+    XMLStore patchSet{TOPLEVEL::XML::Patch};
+    synth.add2XML(patchSet);
+    verifyBinaryRoundTrip(patchSet, "patchset", log);
+
+    char* sessionBuffer{nullptr};
+    int sessionSize = synth.getRuntime().saveSessionData(&sessionBuffer);
+    CHECK(sessionSize > 0);
+    XMLStore session{sessionBuffer, size_t(sessionSize)};
+    CHECK(session);
+    CHECK(session.renderBinary() == string(sessionBuffer, size_t(sessionSize)));
+    free(sessionBuffer);
+    verifyBinaryRoundTrip(session, "session", log);
+
+    // attributes without value and opaque text are given as XML text
+    XMLStore special{"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<!DOCTYPE ZynAddSubFX-data>\n"
+                     "<ZynAddSubFX-data version-major=\"2\" version-minor=\"4\">\n"
+                     "<INFORMATION flagged>\n"
+                     "<string name=\"name\">Heffalump &amp; Woozle  </string>\n"
+                     "<string name=\"empty\"></string>\n"
+                     "<par name=\"volume\" value=\"96\" plain/>\n"
+                     "</INFORMATION>\n"
+                     "</ZynAddSubFX-data>\n"};
+    CHECK(special);
+    XMLtree specialInfo = special.getElm("INFORMATION");
+    CHECK(specialInfo);
+    CHECK(specialInfo.getPar_int("volume", 0, 0, 127) == 96);
+    string specialData = verifyBinaryRoundTrip(special, "special", log);
+    XMLStore specialDecoded{specialData.data(), specialData.size()};
+    XMLtree specialDecodedInfo = specialDecoded.getElm("INFORMATION");
+    CHECK(specialDecodedInfo.getPar_str("name") == specialInfo.getPar_str("name"));
+    CHECK(specialDecodedInfo.getPar_str("empty") == specialInfo.getPar_str("empty"));
+    CHECK(specialDecodedInfo.getPar_int("volume", 0, 0, 127) == 96);
+
+    // damaged or foreign data is rejected as a whole
+    size_t size = instrumentData.size();
+    uint32_t numStrings = readField(instrumentData, POS_NUM_STRINGS);
+    uint32_t numNodes = readField(instrumentData, POS_NUM_NODES);
+    size_t posFirstNode = HEADER_SIZE + numStrings * sizeof(uint32_t);
+    uint32_t byteOrder = readField(instrumentData, POS_BYTE_ORDER);
+    uint32_t swapped = (byteOrder >> 24) | ((byteOrder >> 8) & 0xff00) | ((byteOrder << 8) & 0xff0000) | (byteOrder << 24);
+    string unterminated = instrumentData;
+    unterminated[size - 1] = 'x';
+
+    verifyRejected(instrumentData.substr(0, size - 1), "truncated", log);
+    verifyRejected(instrumentData.substr(0, HEADER_SIZE - 1), "truncated header", log);
+    verifyRejected(instrumentData + '\0', "trailing garbage", log);
+    verifyRejected(unterminated, "unterminated string pool", log);
+    verifyRejected(withField(instrumentData, POS_NUM_NODES, numNodes + 1), "corrupted node count", log);
+    verifyRejected(withField(instrumentData, posFirstNode, numStrings), "corrupted string index", log);
+    verifyRejected(withField(instrumentData, POS_VERSION, readField(instrumentData, POS_VERSION) + 1), "wrong version", log);
+    verifyRejected(withField(instrumentData, POS_BYTE_ORDER, swapped), "wrong byte order", log);
+
     cout << "Bye Cruel World..." <<endl;
 }
@@ -51,6 +51,8 @@
 #include "Misc/FormatFuncs.h"
 #include "Misc/CliFuncs.h"
 #include "Misc/Util.h"
+#include "Misc/InstrumentCache.h"
+#include "Params/PADTableCache.h"
 
 
 // used to hold back shutdown when running sound generation for test
@@ -2548,6 +2550,47 @@ int CmdInterpreter::commandList(Parser& input)
         return REPLY::done_msg;
     }
 
+    if (input.matchnMove(4, "profile"))
+    {
+        if (input.matchnMove(1, "reset"))
+        {
+            synth->profiler.requestReset();
+            Runtime.Log("DSP profile restarted");
+            return REPLY::done_msg;
+        }
+        synth->profiler.report(msg, Runtime.numAvailableParts);
+        InterChange::MediateStats const& med = synth->interchange.mediateStats;
+        msg.push_back("  mediate ran out of time in " + to_string(med.cutShort.load()) + " periods, deferring "
+                      + to_string(med.deferred.load()) + " commands");
+        TextMsgBuffer::Stats text = synth->textMsgBuffer.stats();
+        msg.push_back("  text messages: " + to_string(text.highWater + 1) + " slots used at most, "
+                      + to_string(text.full) + " refused, " + to_string(text.leaked) + " leaked");
+        synth->cliOutput(msg, LINES);
+        return REPLY::done_msg;
+    }
+
+    if (input.matchnMove(4, "padcache"))
+    {
+        PADTableCache::Usage usage = PADTableCache::usage();
+        Runtime.Log("PADSynth wavetable cache: " + PADTableCache::location());
+        Runtime.Log("  " + to_string(usage.entries) + " entries, " + to_string(usage.bytes >> 20)
+                    + " of " + to_string(PADTableCache::SIZE_LIMIT >> 20) + " MiB");
+        return REPLY::done_msg;
+    }
+
+    if (input.matchnMove(2, "cache"))
+    {
+        InstrumentCache::Usage usage = synth->instrumentCache.usage();
+        size_t requests = usage.hits + usage.misses;
+        int hitRate = requests ? int(100 * usage.hits / requests) : 0;
+        Runtime.Log("Instrument cache: " + to_string(usage.entries) + " instruments, "
+                    + to_string(usage.bytes >> 20) + " of " + to_string(usage.limit >> 20) + " MiB"
+                    + ", " + to_string(usage.preloaded) + " preloaded");
+        Runtime.Log("  " + to_string(usage.hits) + " of " + to_string(requests)
+                    + " program changes served from memory (" + to_string(hitRate) + "%)");
+        return REPLY::done_msg;
+    }
+
     if (input.matchnMove(2, "mlearn"))
     {
         if (input.nextChar('@'))
@@ -3232,6 +3275,47 @@ int CmdInterpreter::commandConfig(Parser& input, unsigned char controlType)
         else if (controlType == TOPLEVEL::type::Write)
             return REPLY::value_msg;
     }
+    else if (input.matchnMove(3, "render"))
+    {
+        command = CONFIG::control::renderThreads;
+        if (controlType == TOPLEVEL::type::Write && input.isAtEnd())
+            return REPLY::value_msg;
+        value = string2int(input);
+    }
+    else if (input.matchnMove(2, "cull"))
+    {
+        if (input.matchnMove(1, "level"))
+            command = CONFIG::control::noteCullLevel;
+        else if (input.matchnMove(1, "time"))
+            command = CONFIG::control::noteCullTime;
+        else
+            return REPLY::op_msg;
+        if (controlType == TOPLEVEL::type::Write && input.isAtEnd())
+            return REPLY::value_msg;
+        value = string2int(input);
+    }
+    else if (input.matchnMove(2, "cache"))
+    {
+        if (input.matchnMove(1, "size"))
+        {
+            command = CONFIG::control::instrumentCacheSize;
+            if (controlType == TOPLEVEL::type::Write && input.isAtEnd())
+                return REPLY::value_msg;
+            value = string2int(input);
+        }
+        else if (input.matchnMove(1, "preload"))
+        {
+            command = CONFIG::control::instrumentPreload;
+            value = (input.toggle() == 1);
+        }
+        else
+            return REPLY::op_msg;
+    }
+    else if (input.matchnMove(2, "binary"))
+    {
+        command = CONFIG::control::binaryState;
+        value = (input.toggle() == 1);
+    }
     else if (input.matchnMove(1, "virtual"))
     {
         command = CONFIG::control::virtualKeyboardLayout;
@@ -5880,11 +5964,40 @@ int CmdInterpreter::commandPart(Parser& input, unsigned char controlType)
             if (input.lineEnd(controlType))
                 return REPLY::value_msg;
             value = string2int(input);
-            if (value < 1 || value > POLYPHONY)
+            if (value < 1 || value > MAX_POLYPHONY)
                 return REPLY::range_msg;
         }
         return sendNormal(synth, 0, value, controlType, PART::control::maxNotes, npart);
     }
+    if (input.matchnMove(3, "voices"))
+    {
+        int value = 0;
+        if (controlType == TOPLEVEL::type::Write)
+        {
+            if (input.lineEnd(controlType))
+                return REPLY::value_msg;
+            value = string2int(input);
+            if (value < MIN_POLYPHONY || value > MAX_POLYPHONY)
+                return REPLY::range_msg;
+        }
+        return sendNormal(synth, 0, value, controlType, PART::control::maxVoices, npart);
+    }
+    if (input.matchnMove(3, "steal"))
+    {
+        int value = 0;
+        if (controlType == TOPLEVEL::type::Write)
+        {
+            if (input.matchnMove(1, "released"))
+                value = PART::stealType::released;
+            else if (input.matchnMove(1, "quietest"))
+                value = PART::stealType::quietest;
+            else if (input.matchnMove(1, "key"))
+                value = PART::stealType::sameKey;
+            else
+                return REPLY::range_msg;
+        }
+        return sendNormal(synth, 0, value, controlType, PART::control::voiceSteal, npart);
+    }
 
     if (input.matchnMove(1, "mode"))
     {
@@ -6857,6 +6970,18 @@ Reply CmdInterpreter::cmdIfaceProcessCommand(Parser& input)
                 sendDirect(synth, TOPLEVEL::action::lowPrio, tmp - 1, TOPLEVEL::type::Write, BANK::control::deleteInstrument, TOPLEVEL::section::bank);
             return Reply::DONE;
         }
+        if (input.matchnMove(4, "padcache"))
+        {
+            size_t removed = PADTableCache::purge();
+            Runtime.Log("Removed " + to_string(removed) + " stored PADSynth wavetables");
+            return Reply::DONE;
+        }
+        if (input.matchnMove(2, "cache"))
+        {
+            size_t removed = synth->instrumentCache.clear();
+            Runtime.Log("Removed " + to_string(removed) + " instruments from memory");
+            return Reply::DONE;
+        }
         return Reply::what("remove");
     }
 
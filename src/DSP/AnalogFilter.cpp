@@ -33,10 +33,8 @@ using func::decibel;
 
 
 AnalogFilter::AnalogFilter(SynthEngine& _synth, uchar _type, float _freq, float _q, uchar _stages, float dBgain)
-    : x{}
-    , y{}
-    , oldx{}
-    , oldy{}
+    : state{}
+    , oldstate{}
     , type{_type}
     , stages{_stages}
     , freq{_freq}
@@ -67,9 +65,8 @@ AnalogFilter::AnalogFilter(SynthEngine& _synth, uchar _type, float _freq, float
 
 AnalogFilter::AnalogFilter(AnalogFilter const& orig)
     : Filter_{orig}
-    , y{orig.y}
-    , oldx{orig.oldx}
-    , oldy{orig.oldy}
+    , state{orig.state}
+    , oldstate{orig.oldstate}
     , type{orig.type}
     , stages{orig.stages}
     , freq{orig.freq}
@@ -94,9 +91,8 @@ void AnalogFilter::cleanup()
 {
     for (int i = 0; i < MAX_FILTER_STAGES + 1; ++i)
     {
-        x[i].c1 = x[i].c2 = y[i].c1 = y[i].c2 = 0.0f;
-        oldx[i] = x[i];
-        oldy[i] = y[i];
+        state[i] = biquad::State{0.0f, 0.0f, 0.0f, 0.0f};
+        oldstate[i] = state[i];
     }
     d[0] = 0; // never used
     needsinterpolation = false;
@@ -410,55 +406,43 @@ void AnalogFilter::interpolatenextbuffer()
 
     oldc = c;
     oldd = d;
-    oldx = x;
-    oldy = y;
+    oldstate = state;
 
     needsinterpolation = true;
 }
 
 
-void AnalogFilter::singlefilterout(float* smp, FStage& x, FStage& y, Coeffs const& c, Coeffs const& d)
+/* the first order filters are run as biquad with zero coefficients for the second order terms */
+biquad::Coeffs AnalogFilter::sectionCoeffs(Coeffs const& c, Coeffs const& d)  const
 {
-    float y0;
     if (order == 1)
-    {   // First order filter
-        for (int i = 0; i < synth.sent_buffersize; ++i)
-        { // anti-denormal added in here
-            y0 = (smp[i] + float(1e-20)) * c[0] + x.c1 * c[1] + y.c1 * d[1];
-            y.c1 = y0;
-            x.c1 = smp[i];
-            smp[i] = y0; // out it goes
-        }
-    }
-    if (order == 2)
-    { // Second order filter
-        for (int i = 0; i < synth.sent_buffersize; ++i)
-        { // anti-denormal added in here
-            y0 = (smp[i] + float(1e-20)) * c[0] + x.c1 * c[1] + x.c2 * c[2] + y.c1 * d[1] + y.c2 * d[2];
-            y.c2 = y.c1;
-            y.c1 = y0;
-            x.c2 = x.c1;
-            x.c1 = smp[i];
-            smp[i] = y0; // out it goes
-        }
-    }
+        return biquad::Coeffs{c[0], c[1], 0.0f, d[1], 0.0f};
+    return biquad::Coeffs{c[0], c[1], c[2], d[1], d[2]};
 }
 
 
 void AnalogFilter::filterout(float* smp)
 {
+    const float ANTI_DENORMAL = 1e-20;
+    uint cascade = stages + 1;
+    biquad::Section bank[2 * (MAX_FILTER_STAGES + 1)];
+    for (uint i = 0; i < cascade; ++i)
+        bank[i] = biquad::Section{sectionCoeffs(c, d), state[i]};
+
+    size_t chains = 1;
+    float* out[2] = {smp, nullptr};
     if (needsinterpolation)
-    {
+    {   // the old coefficients run as second chain on the same input
         if (not tmpismp) // allocate interpolation buffer on first usage
             tmpismp.reset(synth.buffersize);
-
-        memcpy(tmpismp.get(), smp, synth.sent_bufferbytes);
-        for (uint i = 0; i < stages + 1; ++i)
-            singlefilterout(tmpismp.get(), oldx[i], oldy[i], oldc, oldd);
+        for (uint i = 0; i < cascade; ++i)
+            bank[cascade + i] = biquad::Section{sectionCoeffs(oldc, oldd), oldstate[i]};
+        out[1] = tmpismp.get();
+        chains = 2;
     }
-
-    for (uint i = 0; i < stages + 1; ++i)
-        singlefilterout(smp, x[i], y[i], c, d);
+    biquad::runBank(smp, out, synth.sent_buffersize, bank, chains, cascade, ANTI_DENORMAL);
+    for (uint i = 0; i < cascade; ++i)
+        state[i] = bank[i].state;
 
     if (needsinterpolation)
     {
@@ -26,6 +26,7 @@
 #define ANALOG_FILTER_H
 
 #include "DSP/Filter_.h"
+#include "DSP/BiquadBank.h"
 #include "Misc/Alloc.h"
 #include "globals.h"
 
@@ -67,11 +68,8 @@ class AnalogFilter : public Filter_
         static constexpr uint MAX_TYPES = 1 + TOPLEVEL::filter::HighShelf2;  // NOTE: change this if adding new filter types
 
     private:
-        struct FStage {
-            float c1{0}, c2{0};
-        };
-        using FStages = std::array<FStage,MAX_FILTER_STAGES + 1>;
-        FStages x,y,oldx,oldy;
+        using States = std::array<biquad::State, MAX_FILTER_STAGES + 1>;
+        States state, oldstate;
 
         uint type;          // The type of the filter (LPF1,HPF1,LPF2,HPF2...)
         uint stages;        // how many times the filter is applied (0->1,1->2,etc.)
@@ -92,7 +90,7 @@ class AnalogFilter : public Filter_
         Samples tmpismp;    // used if it needs interpolation in filterout()
         SynthEngine& synth;
 
-        void singlefilterout(float* smp, FStage& x, FStage& y, Coeffs const& c, Coeffs const& d);
+        biquad::Coeffs sectionCoeffs(Coeffs const& c, Coeffs const& d)  const;
         void computefiltercoefs();
 };
 
@@ -0,0 +1,234 @@
+/*
+    BiquadBank.cpp - many second order filter sections computed side by side
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "DSP/BiquadBank.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX_KERNEL
+#endif
+
+using biquad::Coeffs;
+using biquad::State;
+using biquad::Section;
+
+
+namespace { // implementation details
+
+    const size_t LANES     = 8;     // chains computed side by side
+    const size_t MIN_LANES = 4;     // with fewer chains, compute each on its own
+    const size_t BLOCK     = 256;   // samples taken through all stages in one pass
+
+    inline float compute(Coeffs const& c, State& s, float x, float bias)
+    {
+        float y = (x + bias) * c.b0 + s.x1 * c.b1 + s.x2 * c.b2 + s.y1 * c.d1 + s.y2 * c.d2;
+        s.x2 = s.x1;
+        s.x1 = x;
+        s.y2 = s.y1;
+        s.y1 = y;
+        return y;
+    }
+
+    void runSection(Section& sec, float* smp, size_t cnt, float bias)
+    {
+        Coeffs const c = sec.coef;
+        State s = sec.state;
+        for (size_t i = 0; i < cnt; ++i)
+            smp[i] = compute(c, s, smp[i], bias);
+        sec.state = s;
+    }
+
+
+    /* One stage of a group of chains, transposed to place each chain into a lane;
+     * unused lanes are zeroed and thus produce silence. */
+    struct Lanes
+    {
+        alignas(32) float b0[LANES], b1[LANES], b2[LANES], d1[LANES], d2[LANES];
+        alignas(32) float x1[LANES], x2[LANES], y1[LANES], y2[LANES];
+
+        void load(Section const* sec, size_t width, size_t stride)
+        {
+            for (size_t j = 0; j < LANES; ++j)
+            {
+                Section s = (j < width)? sec[j * stride] : Section{};
+                b0[j] = s.coef.b0;  b1[j] = s.coef.b1;  b2[j] = s.coef.b2;
+                d1[j] = s.coef.d1;  d2[j] = s.coef.d2;
+                x1[j] = s.state.x1; x2[j] = s.state.x2;
+                y1[j] = s.state.y1; y2[j] = s.state.y2;
+            }
+        }
+
+        void store(Section* sec, size_t width, size_t stride)  const
+        {
+            for (size_t j = 0; j < width; ++j)
+                sec[j * stride].state = State{x1[j], x2[j], y1[j], y2[j]};
+        }
+    };
+
+
+    /* buf holds cnt frames, each with one sample per lane */
+    void stagePlain(Lanes& lanes, float* buf, size_t cnt, float bias)
+    {
+        Lanes l = lanes;  // local copy can not alias the buffer
+        for (size_t i = 0; i < cnt; ++i, buf += LANES)
+            for (size_t j = 0; j < LANES; ++j)
+            {
+                float x = buf[j];
+                float y = (x + bias) * l.b0[j] + l.x1[j] * l.b1[j] + l.x2[j] * l.b2[j]
+                        + l.y1[j] * l.d1[j] + l.y2[j] * l.d2[j];
+                l.x2[j] = l.x1[j];
+                l.x1[j] = x;
+                l.y2[j] = l.y1[j];
+                l.y1[j] = y;
+                buf[j] = y;
+            }
+        lanes = l;
+    }
+
+#ifdef HAVE_AVX_KERNEL
+    __attribute__((target("avx")))
+    void stageAVX(Lanes& lanes, float* buf, size_t cnt, float bias)
+    {
+        const __m256 b0 = _mm256_load_ps(lanes.b0);
+        const __m256 b1 = _mm256_load_ps(lanes.b1);
+        const __m256 b2 = _mm256_load_ps(lanes.b2);
+        const __m256 d1 = _mm256_load_ps(lanes.d1);
+        const __m256 d2 = _mm256_load_ps(lanes.d2);
+        const __m256 bs = _mm256_set1_ps(bias);
+        __m256 x1 = _mm256_load_ps(lanes.x1);
+        __m256 x2 = _mm256_load_ps(lanes.x2);
+        __m256 y1 = _mm256_load_ps(lanes.y1);
+        __m256 y2 = _mm256_load_ps(lanes.y2);
+        for (size_t i = 0; i < cnt; ++i, buf += LANES)
+        {
+            // Note: separate multiply and add (no FMA), same order as compute()
+            __m256 x = _mm256_load_ps(buf);
+            __m256 y = _mm256_mul_ps(_mm256_add_ps(x, bs), b0);
+            y = _mm256_add_ps(y, _mm256_mul_ps(x1, b1));
+            y = _mm256_add_ps(y, _mm256_mul_ps(x2, b2));
+            y = _mm256_add_ps(y, _mm256_mul_ps(y1, d1));
+            y = _mm256_add_ps(y, _mm256_mul_ps(y2, d2));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            _mm256_store_ps(buf, y);
+        }
+        _mm256_store_ps(lanes.x1, x1);
+        _mm256_store_ps(lanes.x2, x2);
+        _mm256_store_ps(lanes.y1, y1);
+        _mm256_store_ps(lanes.y2, y2);
+    }
+#endif
+
+    using StageKernel = void(*)(Lanes&, float*, size_t, float);
+
+    StageKernel selectKernel()
+    {
+#ifdef HAVE_AVX_KERNEL
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx"))
+            return stageAVX;
+#endif
+        return stagePlain;
+    }
+
+    // decided once, when the program is loaded
+    StageKernel const runStage = selectKernel();
+
+
+    /* Take the input through all chains, block by block, and hand each result
+     * to output(chain, smps, stride, offset, len); for each sample, the chains
+     * are handed over in order. The input of each block is copied
+     * before any output is written, so output may overwrite the input. */
+    template<class OUT>
+    void processBank(float const* in, size_t cnt, Section* bank,
+                     size_t chains, size_t stages, float bias, OUT&& output)
+    {
+        float src[BLOCK];
+        for (size_t done = 0; done < cnt; done += BLOCK)
+        {
+            size_t len = std::min(BLOCK, cnt - done);
+            memcpy(src, in + done, len * sizeof(float));
+            if (chains < MIN_LANES)
+            {
+                float buf[BLOCK];
+                for (size_t chain = 0; chain < chains; ++chain)
+                {
+                    memcpy(buf, src, len * sizeof(float));
+                    for (size_t s = 0; s < stages; ++s)
+                        runSection(bank[chain * stages + s], buf, len, bias);
+                    output(chain, buf, 1, done, len);
+                }
+                continue;
+            }
+            alignas(32) float buf[BLOCK * LANES];
+            Lanes lanes;
+            for (size_t first = 0; first < chains; first += LANES)
+            {
+                size_t width = std::min(LANES, chains - first);
+                for (size_t i = 0; i < len; ++i)
+                    std::fill_n(buf + i * LANES, LANES, src[i]);
+                for (size_t s = 0; s < stages; ++s)
+                {
+                    Section* sec = bank + first * stages + s;
+                    lanes.load(sec, width, stages);
+                    runStage(lanes, buf, len, bias);
+                    lanes.store(sec, width, stages);
+                }
+                for (size_t j = 0; j < width; ++j)
+                    output(first + j, buf + j, LANES, done, len);
+            }
+        }
+    }
+}//(End)implementation details
+
+
+namespace biquad {
+
+void mixBank(float const* in, float* out, size_t cnt,
+             Section* bank, float const* gain, size_t chains, size_t stages)
+{
+    processBank(in, cnt, bank, chains, stages, 0.0f
+               ,[=](size_t chain, float const* smps, size_t stride, size_t offset, size_t len)
+                {
+                    float g = gain[chain];
+                    for (size_t i = 0; i < len; ++i)
+                        out[offset + i] += smps[i * stride] * g;
+                });
+}
+
+
+void runBank(float const* in, float* const* out, size_t cnt,
+             Section* bank, size_t chains, size_t stages, float bias)
+{
+    processBank(in, cnt, bank, chains, stages, bias
+               ,[=](size_t chain, float const* smps, size_t stride, size_t offset, size_t len)
+                {
+                    float* dest = out[chain] + offset;
+                    for (size_t i = 0; i < len; ++i)
+                        dest[i] = smps[i * stride];
+                });
+}
+
+}//(End)namespace biquad
@@ -0,0 +1,75 @@
+/*
+    BiquadBank.h - many second order filter sections computed side by side
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef BIQUAD_BANK_H
+#define BIQUAD_BANK_H
+
+#include <cstddef>
+
+/* A bank is a set of independent cascades ("chains"), each built from the same
+ * number of biquad sections and all fed by one common input signal; this is how
+ * SUBnote builds its harmonics from noise. The section of chain k at stage s is
+ * found at bank[k * stages + s].
+ *
+ * Since the chains do not depend on each other, up to 8 of them are computed
+ * side by side, one per SIMD lane: with AVX on x86 CPUs supporting it (detected
+ * at program start), elsewhere the lane loop is left to auto-vectorisation.
+ * With fewer than 4 chains, each is computed on its own.
+ * All variants perform the same arithmetic, in the same order, as a plain
+ * sample-by-sample biquad, thus results do not depend on the path taken;
+ * this relies on fast-math and FMA contraction being disabled for this file.
+ * The "subbank" case of test::Benchmark times the bank at its widest.
+ */
+namespace biquad {
+
+    /* y[n] = b0·x[n] + b1·x[n-1] + b2·x[n-2] + d1·y[n-1] + d2·y[n-2]
+     * Note: the feedback coefficients include the sign (d = -a) */
+    struct Coeffs
+    {
+        float b0, b1, b2;
+        float d1, d2;
+    };
+
+    struct State
+    {
+        float x1, x2;   // previous input
+        float y1, y2;   // previous output
+    };
+
+    struct Section
+    {
+        Coeffs coef;
+        State  state;
+    };
+
+
+    /* Filter the input through all chains and add the output of each,
+     * weighted by gain[chain], into out; chains are added in order. */
+    void mixBank(float const* in, float* out, size_t cnt,
+                 Section* bank, float const* gain, size_t chains, size_t stages);
+
+    /* Filter the input through all chains, placing the output of each into
+     * out[chain]; the outputs may overwrite the input buffer.
+     * The bias is added to the input of each section (anti-denormal). */
+    void runBank(float const* in, float* const* out, size_t cnt,
+                 Section* bank, size_t chains, size_t stages, float bias =0);
+}
+
+#endif /*BIQUAD_BANK_H*/
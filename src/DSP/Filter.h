@@ -31,12 +31,13 @@
 #include "DSP/FormantFilter.h"
 #include "DSP/SVFilter.h"
 #include "Params/FilterParams.h"
+#include "Misc/NotePool.h"
 
 #include <memory>
 
 class SynthEngine;
 
-class Filter
+class Filter : public NotePooled
 {
     public:
        ~Filter() = default;
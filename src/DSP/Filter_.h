@@ -27,7 +27,9 @@
 #ifndef FILTER__H
 #define FILTER__H
 
-class Filter_
+#include "Misc/NotePool.h"
+
+class Filter_ : public NotePooled
 {
     public:
         Filter_()
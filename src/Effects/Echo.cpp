@@ -30,6 +30,7 @@
 #include "Misc/SynthEngine.h"
 #include "Effects/Echo.h"
 #include <iostream>
+#include <algorithm>
 
 using func::power;
 using func::powFrac;
@@ -38,21 +39,26 @@ Echo::Echo(bool insertion_, float* efxoutl_, float* efxoutr_, SynthEngine& _synt
     Effect(insertion_, efxoutl_, efxoutr_, NULL, 0, _synth),
     Pdelay(60),
     Plrdelay(100),
+    Pbpm(false),
+    PsepLRDelay(false),
     feedback(1, _synth.samplerate),
     hidamp(1, _synth.samplerate),
+    dl(1),
+    dr(1),
+    delay(1),
     lrdelay(0),
     ldelay(NULL),
     rdelay(NULL),
     lxfade(1, _synth.samplerate_f),
     rxfade(1, _synth.samplerate_f)
 {
+    maxdelay = 5 * synth.samplerate;
     setvolume(50);
     setfeedback(40);
     sethidamp(60);
     setpreset(Ppreset);
     changepar(4, 30); // lrcross
     Pchanged = false;
-    maxdelay = 5 * synth.samplerate;
     ldelay = new float[maxdelay];
     rdelay = new float[maxdelay];
     realposl = realposr = 1;
@@ -82,6 +88,16 @@ void Echo::cleanup()
 }
 
 
+// the delay lines hold what is going to be output next;
+// while cross-fading to a new delay, the former taps are still read
+uint Echo::tailFrames() const
+{
+    int longest = std::max({dl, dr, lxfade.getOldValue(), lxfade.getNewValue()
+                                  , rxfade.getOldValue(), rxfade.getNewValue()});
+    return uint(longest) + Effect::tailFrames();
+}
+
+
 // Initialize the delays
 void Echo::initdelays()
 {
@@ -337,10 +353,12 @@ void Echo::changepar(int npar, unsigned char value)
 
         case 2:
             setdelay(value);
+            initdelays();
             break;
 
         case 3:
             setlrdelay(value);
+            initdelays();
             break;
 
         case 4:
@@ -357,10 +375,12 @@ void Echo::changepar(int npar, unsigned char value)
 
         case EFFECT::control::sepLRDelay:
             PsepLRDelay = value;
+            initdelays();
             break;
 
         case EFFECT::control::bpm:
             Pbpm = value;
+            initdelays();
             break;
 
         default:
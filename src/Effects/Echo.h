@@ -64,6 +64,7 @@ class Echo : public Effect
         void changepar(int npar, uchar value) override;
         uchar getpar(int npar)          const override;
         void cleanup()                        override;
+        uint tailFrames()               const override;
 
         void setdryonly();
 
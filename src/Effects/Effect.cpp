@@ -65,6 +65,13 @@ void Effect::cleanup()
 }
 
 
+// covers the modulated delays and filters of the simple effects
+uint Effect::tailFrames() const
+{
+    return synth.samplerate / 5;
+}
+
+
 void Effect::setpanning(char Ppanning_)
 {
     Ppanning = Ppanning_;
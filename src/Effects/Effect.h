@@ -66,6 +66,8 @@ class Effect
 
         virtual void out(float *smpsl, float *smpsr) = 0;
         virtual void cleanup();
+        // how long the output may still sound after the input went silent
+        virtual uint tailFrames() const;
 
         uchar Ppreset; // Current preset
         float *const efxoutl;
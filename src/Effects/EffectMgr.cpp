@@ -31,6 +31,10 @@
 #include "Effects/EffectMgr.h"
 #include "Effects/EQ.h"
 
+namespace {
+    const float SILENCE_LEVEL = 1e-6f; // -120dB
+}
+
 EffectMgr::EffectMgr(const bool insertion_, SynthEngine& _synth) :
     ParamBase{_synth},
     efxoutl{size_t(_synth.buffersize)},
@@ -39,7 +43,9 @@ EffectMgr::EffectMgr(const bool insertion_, SynthEngine& _synth) :
     filterpars{NULL},
     effectType{0}, // type none resolves to zero internally
     dryonly{false},
-    efx{}
+    efx{},
+    quietFrames{0},
+    tailFrames{0}
 {
     defaults();
 }
@@ -102,6 +108,7 @@ void EffectMgr::changeeffect(int _nefx)
     }
     if (efx)
         filterpars = efx->filterpars;
+    tailFrames = efx? efx->tailFrames() : 0;
 }
 
 
@@ -117,6 +124,7 @@ void EffectMgr::cleanup()
 {
     memset(efxoutl.get(), 0, synth.bufferbytes);
     memset(efxoutr.get(), 0, synth.bufferbytes);
+    quietFrames = 0;
     if (efx)
         efx->cleanup();
 }
@@ -133,8 +141,11 @@ uchar EffectMgr::getpreset()
 // Change the preset of the current effect
 void EffectMgr::changepreset(uchar npreset)
 {
-    if (efx)
-        efx->setpreset(npreset);
+    if (!efx)
+        return;
+    efx->setpreset(npreset);
+    quietFrames = 0;
+    tailFrames = efx->tailFrames();
 }
 
 
@@ -144,6 +155,8 @@ void EffectMgr::seteffectpar(int npar, uchar value)
     if (!efx)
         return;
     efx->changepar(npar, value);
+    quietFrames = 0; // might now sound even without input
+    tailFrames = efx->tailFrames();
 }
 
 
@@ -166,7 +179,7 @@ void EffectMgr::getAllPar(EffectParArray& target) const
 
 
 // Apply the effect
-void EffectMgr::out(float *smpsl, float *smpsr)
+bool EffectMgr::out(float *smpsl, float *smpsr, bool silentIn)
 {
     if (!efx)
     {
@@ -176,18 +189,29 @@ void EffectMgr::out(float *smpsl, float *smpsr)
             memset(smpsr, 0, synth.sent_bufferbytes);
             memset(efxoutl.get(), 0, synth.sent_bufferbytes);
             memset(efxoutr.get(), 0, synth.sent_bufferbytes);
+            return true;
         }
-        return;
+        return silentIn;
+    }
+    if (!silentIn)
+        quietFrames = 0;
+    else if (quietFrames >= tailFrames)
+    {   // tail has died away: the dry input is zero, so is the output
+        memset(efxoutl.get(), 0, synth.sent_bufferbytes);
+        memset(efxoutr.get(), 0, synth.sent_bufferbytes);
+        return true;
     }
     memset(efxoutl.get(), 0, synth.sent_bufferbytes);
     memset(efxoutr.get(), 0, synth.sent_bufferbytes);
     efx->out(smpsl, smpsr);
+    tailFrames = efx->tailFrames(); // delay may follow the BPM
 
     if (effectType == (EFFECT::type::eq - EFFECT::type::none))
     {   // this is need only for the EQ effect
         memcpy(smpsl, efxoutl.get(), synth.sent_bufferbytes);
         memcpy(smpsr, efxoutr.get(), synth.sent_bufferbytes);
-        return;
+        trackTail(smpsl, smpsr, silentIn);
+        return false;
     }
 
     // Insertion effect
@@ -238,6 +262,23 @@ void EffectMgr::out(float *smpsl, float *smpsr)
             smpsr[i] = efxoutr[i];
         }
     }
+    trackTail(smpsl, smpsr, silentIn);
+    return false;
+}
+
+
+void EffectMgr::trackTail(float const* smpsl, float const* smpsr, bool silentIn)
+{
+    if (!silentIn)
+        return;
+    float peak = 0.0f;
+    for (int i = 0; i < synth.sent_buffersize; ++i)
+        peak = std::max(peak, std::max(std::max(fabsf(smpsl[i]), fabsf(smpsr[i])),
+                                       std::max(fabsf(efxoutl[i]), fabsf(efxoutr[i]))));
+    if (peak < SILENCE_LEVEL)
+        quietFrames += synth.sent_buffersize;
+    else
+        quietFrames = 0;
 }
 
 
@@ -53,7 +53,10 @@ class EffectMgr : public ParamBase
         void add2XML(XMLtree&);
         void getfromXML(XMLtree&);
 
-        void out(float *smpsl, float *smpsr);
+        /* process one period; silentIn tells the input is all zero.
+         * Returns true when the output is all zero as well. */
+        bool out(float *smpsl, float *smpsr, bool silentIn = false);
+        bool idle() const { return !efx || quietFrames >= tailFrames; }
 
         void  setdryonly(bool value);
         float sysefxgetvolume();
@@ -83,6 +86,12 @@ class EffectMgr : public ParamBase
         int effectType;
         bool dryonly;
         unique_ptr<Effect> efx;
+
+        // while the input is silent, the effect is computed until its
+        // output stayed below SILENCE_LEVEL for the length of its tail
+        uint quietFrames;
+        uint tailFrames;
+        void trackTail(float const* smpsl, float const* smpsr, bool silentIn);
 };
 
 class LimitMgr
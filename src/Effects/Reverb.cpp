@@ -25,6 +25,7 @@
 */
 
 #include <cmath>
+#include <algorithm>
 
 #include "DSP/Unison.h"
 #include "DSP/AnalogFilter.h"
@@ -271,6 +272,21 @@ void Reverb::cleanup()
 }
 
 
+// pre-delay plus the longest comb and allpass lines
+uint Reverb::tailFrames() const
+{
+    size_t longest = 0;
+    for (size_t i = 0; i < REV_COMBS * 2; ++i)
+        longest = std::max(longest, comblen[i]);
+    size_t tail = longest;
+    longest = 0;
+    for (size_t i = 0; i < REV_APS * 2; ++i)
+        longest = std::max(longest, aplen[i]);
+    tail += longest + std::max(idelaylen, 0);
+    return uint(tail) + Effect::tailFrames();
+}
+
+
 // Parameter control
 void Reverb::setvolume(uchar Pvolume_)
 {
@@ -78,6 +78,7 @@ class Reverb : public Effect
         Reverb(bool insertion_, float *efxoutl_, float *efxoutr_, SynthEngine&);
         void out(float* rawL, float* rawR) override;
         void cleanup() override;
+        uint tailFrames() const override;
 
         void setpreset(uchar npreset) override;
         void changepar(int npar, uchar value) override;
@@ -981,6 +981,32 @@ string DataText::resolveConfig(SynthEngine& synth, CommandBlock& cmd, bool addVa
             yesno = true;
             break;
 
+        case CONFIG::control::renderThreads:
+            contstr += "Render threads";
+            break;
+
+        case CONFIG::control::noteCullLevel:
+            contstr += "Cull level dB";
+            break;
+
+        case CONFIG::control::noteCullTime:
+            contstr += "Cull time ms";
+            break;
+
+        case CONFIG::control::instrumentCacheSize:
+            contstr += "Instrument cache MiB";
+            break;
+
+        case CONFIG::control::instrumentPreload:
+            contstr += "Preload current bank";
+            yesno = true;
+            break;
+
+        case CONFIG::control::binaryState:
+            contstr += "Binary session state";
+            yesno = true;
+            break;
+
         case CONFIG::control::saveCurrentConfig:
         {
             string name = textMsgBuffer.fetch(value_int);
@@ -1599,6 +1625,22 @@ string DataText::resolvePart(CommandBlock& cmd, bool addValue)
         case PART::control::maxNotes:
             contstr = "Key Limit";
             break;
+        case PART::control::maxVoices:
+            contstr = "Voices";
+            break;
+        case PART::control::voiceSteal:
+            showValue = false;
+            contstr = "Voice Steal ";
+            if (addValue)
+            {
+                if (value_int == PART::stealType::quietest)
+                    contstr += "Quietest";
+                else if (value_int == PART::stealType::sameKey)
+                    contstr += "Same Key";
+                else
+                    contstr += "Released";
+            }
+            break;
         case PART::control::keyShift:
             contstr = "Key Shift";
             break;
@@ -29,6 +29,7 @@
 #include <bitset>
 #include <thread>
 #include <atomic>
+#include <chrono>
 
 #include "Interface/InterChange.h"
 #include "Interface/Vectors.h"
@@ -204,6 +205,7 @@ void* InterChange::sortResultsThread()
 
         while (decodeLoopback.read(cmd.bytes))
         {
+            refreshOscilTables(cmd);
             if (cmd.data.part == TOPLEVEL::section::midiLearn)
                 synth.midilearn.generalOperations(cmd);
             else if (cmd.data.source >= TOPLEVEL::action::lowPrio)
@@ -211,6 +213,7 @@ void* InterChange::sortResultsThread()
             else
                 resolveReplies(cmd);
         }
+        synth.disposeReleasedInstruments(); // after in place program changes
 
         sem_wait(&sortResultsThreadSemaphore);
     }
@@ -218,6 +221,24 @@ void* InterChange::sortResultsThread()
 }
 
 
+/* A change to an AddSynth voice or oscillator makes the note-on tables
+ * of that instrument stale; rebuild them in background, off the audio thread.
+ * Voices may use the oscillator of another voice, thus all are rebuilt.
+ */
+void InterChange::refreshOscilTables(CommandBlock& cmd)
+{
+    if (!(cmd.data.type & TOPLEVEL::type::Write))
+        return;
+    if (cmd.data.part >= NUM_MIDI_PARTS || cmd.data.kit >= NUM_KIT_ITEMS)
+        return;
+    if (cmd.data.engine < PART::engine::addVoice1 || cmd.data.engine >= PART::engine::addVoiceModEnd)
+        return;
+    ADnoteParameters* pars = synth.part[cmd.data.part]->kit[cmd.data.kit].adpars;
+    if (pars)
+        pars->requestOscilTables();
+}
+
+
 InterChange::~InterChange()
 {
     if (sortResultsThreadHandle)
@@ -1484,6 +1505,15 @@ int InterChange::indirectPart(CommandBlock& cmd, uchar& newMsg, bool& guiTo, str
             }
         break;
 
+        case PART::control::maxVoices:
+            if (write)
+            {
+                part.setVoiceCapacity(value);
+                synth.partonoffWrite(npart, 2);
+                cmd.data.source &= ~TOPLEVEL::action::lowPrio;
+            }
+        break;
+
         case PADSYNTH::control::applyChanges:
             // it appears Pkitmode is not being recognised here :(
             if (kititem >= NUM_KIT_ITEMS)//not part.Pkitmode)
@@ -1899,11 +1929,72 @@ void InterChange::generateSpecialInstrument(int npart, string name)
  *         moreover, result values are also published through the toGUI ringbuffer, from where
  *         they are dispatched by the »duty-cycle« in the event handling thread.
  */
+namespace {
+    /* Budget of InterChange::mediate() within one audio period. MIDI is served
+     * first, limited by count only; the other sources share what remains of
+     * MEDIATE_SHARE of the period duration, but at least one round is done. */
+    const size_t MIDI_BUDGET   = 128;
+    const float  MEDIATE_SHARE = 0.25f;
+
+    inline void notePeak(std::atomic<size_t>& peak, size_t level)
+    {
+        if (level > peak.load(std::memory_order_relaxed))
+            peak.store(level, std::memory_order_relaxed);
+    }
+}
+
+
+/* record the queue levels; returns the total waiting */
+size_t InterChange::trackQueues()
+{
+    size_t total = 0;
+    size_t level = fromMIDI.pending();
+    notePeak(mediateStats.peakMIDI, level);
+    total += level;
+#ifdef GUI_FLTK
+    level = fromGUI.pending();
+    notePeak(mediateStats.peakGUI, level);
+    total += level;
+#endif
+#ifndef YOSHIMI_LV2_PLUGIN
+    level = fromCLI.pending();
+    notePeak(mediateStats.peakCLI, level);
+    total += level;
+#endif
+    level = returnsBuffer.pending();
+    notePeak(mediateStats.peakReturns, level);
+    return total + level;
+}
+
+
+void InterChange::mediateMidi(CommandBlock& cmd)
+{
+    cameFrom = envControl::input;
+    if (cmd.data.part != TOPLEVEL::section::midiLearn)
+        // Normal MIDI message, not special midi-learn message
+    {
+        historyActionCheck(cmd);
+        commandSend(cmd);
+        returns(cmd);
+    }
+#ifdef GUI_FLTK
+    else if (synth.getRuntime().showGui
+            && cmd.data.control == MIDILEARN::control::reportActivity)
+        toGUI.write(cmd.bytes);
+#endif
+}
+
+
 void InterChange::mediate()
 {
     CommandBlock cmd;
     cmd.data.control = UNUSED; // No other data element could be read uninitialised
     syncWrite = true;
+    trackQueues();
+    // Note: the time point must keep the clock's integral rep; a float one loses precision with uptime
+    auto deadline = std::chrono::steady_clock::now()
+                  + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<float>(MEDIATE_SHARE * synth.sent_buffersize_f / synth.samplerate_f));
     if (setUndo)
     {
         int step = 0;
@@ -1916,6 +2007,10 @@ void InterChange::mediate()
         }
     }
 
+    // notes and controllers must not wait behind GUI or CLI traffic
+    for (size_t cnt = 0; cnt < MIDI_BUDGET and fromMIDI.read(cmd.bytes); ++cnt)
+        mediateMidi(cmd);
+
     bool more;
     do
     {
@@ -1944,19 +2039,7 @@ void InterChange::mediate()
         if (fromMIDI.read(cmd.bytes))
         {
             more = true;
-            cameFrom = envControl::input;
-            if (cmd.data.part != TOPLEVEL::section::midiLearn)
-                // Normal MIDI message, not special midi-learn message
-            {
-                historyActionCheck(cmd);
-                commandSend(cmd);
-                returns(cmd);
-            }
-#ifdef GUI_FLTK
-            else if (synth.getRuntime().showGui
-                    && cmd.data.control == MIDILEARN::control::reportActivity)
-                toGUI.write(cmd.bytes);
-#endif
+            mediateMidi(cmd);
         }
         else if (cmd.data.control == TOPLEVEL::section::midiLearn)
         {
@@ -1968,6 +2051,16 @@ void InterChange::mediate()
             returns(cmd);
             more = true;
         }
+        if (more and std::chrono::steady_clock::now() > deadline)
+        {// leave the rest for the next period
+            size_t waiting = trackQueues();
+            if (waiting > 0)
+            {
+                ++ mediateStats.cutShort;
+                mediateStats.deferred += waiting;
+            }
+            break;
+        }
     }
     while (more and synth.getRuntime().runSynth.load(std::memory_order_relaxed));
     syncWrite = false;
@@ -2528,7 +2621,6 @@ void InterChange::commandMidi(CommandBlock& cmd)
         case MIDI::control::instrument:
             cmd.data.source |= TOPLEVEL::action::lowPrio;
             cmd.data.part = TOPLEVEL::section::midiIn;
-            synth.partonoffLock(chan & 0x3f, -1);
             synth.getRuntime().finishedCLI = true;
             break;
 
@@ -3431,6 +3523,72 @@ void InterChange::commandConfig(CommandBlock& cmd)
             else
                 value = synth.getRuntime().enable_NRPN;
             break;
+        case CONFIG::control::renderThreads:
+            if (write)
+            {
+                value_int = std::clamp(value_int, 0, MAX_RENDER_THREADS);
+                cmd.data.value = value_int;
+                synth.getRuntime().renderThreads = value_int;
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().renderThreads;
+            break;
+        case CONFIG::control::noteCullLevel:
+            if (write)
+            {
+                value_int = std::clamp(value_int, MIN_NOTE_CULL_LEVEL, MAX_NOTE_CULL_LEVEL);
+                cmd.data.value = value_int;
+                synth.getRuntime().noteCullLevel = value_int;
+                synth.setNoteCull();
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().noteCullLevel;
+            break;
+        case CONFIG::control::noteCullTime:
+            if (write)
+            {
+                value_int = std::clamp(value_int, 0, MAX_NOTE_CULL_TIME);
+                cmd.data.value = value_int;
+                synth.getRuntime().noteCullTime = value_int;
+                synth.setNoteCull();
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().noteCullTime;
+            break;
+        case CONFIG::control::instrumentCacheSize:
+            if (write)
+            {
+                value_int = std::clamp(value_int, 0, MAX_INSTRUMENT_CACHE);
+                cmd.data.value = value_int;
+                synth.getRuntime().instrumentCacheSize = value_int;
+                synth.instrumentCache.setLimit(value_int);
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().instrumentCacheSize;
+            break;
+        case CONFIG::control::instrumentPreload:
+            if (write)
+            {
+                synth.getRuntime().instrumentPreload = value_bool;
+                synth.preloadBank(synth.getRuntime().currentRoot, synth.getRuntime().currentBank);
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().instrumentPreload;
+            break;
+        case CONFIG::control::binaryState:
+            if (write)
+            {
+                synth.getRuntime().binaryState = value_bool;
+                synth.getRuntime().updateConfig(control, value_int);
+            }
+            else
+                value = synth.getRuntime().binaryState;
+            break;
 // save config
         case CONFIG::control::saveCurrentConfig: //done elsewhere
             break;
@@ -3591,13 +3749,12 @@ void InterChange::commandMain(CommandBlock& cmd)
             break;
 
         case MAIN::control::loadInstrumentFromBank:
-            synth.partonoffLock(kititem, -1);
+            // the part keeps playing, see SynthEngine::setProgram()
             //std::cout << "Main bank ins load" << std::endl;
             cmd.data.source |= TOPLEVEL::action::lowPrio;
             break;
 
         case MAIN::control::loadInstrumentByName:
-            synth.partonoffLock(kititem, -1);
             //std::cout << "Main ins load" << std::endl;
             cmd.data.source |= TOPLEVEL::action::lowPrio;
             break;
@@ -4225,6 +4382,21 @@ void InterChange::commandPart(CommandBlock& cmd)
             else
                 value = part.Pkeylimit;
             break;
+        case PART::control::maxVoices:
+            if (write)
+            {   // reallocated in the background with the part off
+                synth.partonoffWrite(npart, -1);
+                cmd.data.source = TOPLEVEL::action::lowPrio;
+            }
+            else
+                value = part.Pvoices;
+            break;
+        case PART::control::voiceSteal:
+            if (write)
+                part.Psteal = value_int;
+            else
+                value = part.Psteal;
+            break;
         case PART::control::keyShift: // done elsewhere
             break;
 
@@ -110,6 +110,20 @@ class InterChange : private DataText
         void generateSpecialInstrument(int npart, std::string name);
         void mediate();
         void historyActionCheck(CommandBlock&);
+
+        /* mediate() is limited to a share of each audio period; what remains
+         * is left in the buffers for the next period. Written by the audio
+         * thread only, thus may be read at any time (values are advisory). */
+        struct MediateStats
+        {
+            std::atomic<size_t> cutShort{0};     // periods where the budget ran out
+            std::atomic<size_t> deferred{0};     // commands left waiting, summed over those periods
+            std::atomic<size_t> peakMIDI{0};     // queue high-water marks
+            std::atomic<size_t> peakGUI{0};
+            std::atomic<size_t> peakCLI{0};
+            std::atomic<size_t> peakReturns{0};
+        };
+        MediateStats mediateStats;
         void returns(CommandBlock&);
         void doClearPartInstrument(int npart);
         bool commandSend(CommandBlock&);
@@ -129,7 +143,10 @@ class InterChange : private DataText
         static void* _sortResultsThread(void* arg);
         pthread_t  sortResultsThreadHandle;
         void muteQueueWrite(CommandBlock&);
+        void mediateMidi(CommandBlock&);
+        size_t trackQueues();
         void indirectTransfers(CommandBlock&, bool noForward = false);
+        void refreshOscilTables(CommandBlock&);
         int indirectVector(CommandBlock&, uchar& newMsg, bool& guiTo, std::string& text);
         int indirectMidi  (CommandBlock&, uchar& newMsg, bool& guiTo, std::string& text);
         int indirectScales(CommandBlock&, uchar& newMsg, bool& guiTo, std::string& text);
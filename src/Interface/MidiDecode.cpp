@@ -742,9 +742,9 @@ void MidiDecode::setMidiProgram(uchar ch, int prg, bool in_place)
                 putData.data.kit = npart;
                 if (in_place)
                 {
-                    synth->partonoffLock(npart, -1);
                     synth->setProgramFromBank(putData, true);
                     synth->interchange.decodeLoopback.write(putData.bytes);
+                    synth->interchange.spinSortResultsThread(); // also disposes of the former instrument
                 }
                 else
                 {
@@ -759,9 +759,9 @@ void MidiDecode::setMidiProgram(uchar ch, int prg, bool in_place)
         putData.data.kit = ch & 0x3f;
         if (in_place)
         {
-            synth->partonoffLock(ch, -1);
             synth->setProgramFromBank(putData, true);
             synth->interchange.decodeLoopback.write(putData.bytes);
+            synth->interchange.spinSortResultsThread();
         }
         else
             synth->midilearn.writeMidi(putData, false);
@@ -55,8 +55,6 @@ using std::string;
 using std::vector;
 using std::list;
 
-enum scan : int { noList = -3, listEnd, listBlocked};
-
 
 namespace { // Implementation details...
 
@@ -80,6 +78,10 @@ MidiLearn::MidiLearn(SynthEngine& synthInstance)
     , midi_list{}
     , learnedName{}
     , learnTransferBlock{}
+    , currentIndex{}
+    , index{nullptr}
+    , indexReaders{0}
+    , rebuildLock{}
     { }
 
 
@@ -102,17 +104,11 @@ bool MidiLearn::runMidiLearn(int intVal, ushort CC, uchar chan, bool in_place)
         return true; // block while learning
     }
 
-    if (findSize() == 0)
-        return false; // don't bother if there's no list!
-
-    int lastpos = scan::listBlocked;
+    uint32_t key = (uint32_t(CC) << 8) | chan;
     LearnBlock foundEntry;
     bool firstLine = true;
-    while (lastpos != scan::listEnd)
+    for (uint32_t line = 0; fetchLine(key, line, foundEntry); ++line)
     {
-        lastpos = findEntry(midi_list, lastpos, CC, chan, foundEntry, false);
-        if (lastpos == scan::noList)
-            return false;
         int status = foundEntry.status;
         if (status & 4) // it's muted
             continue;
@@ -187,7 +183,7 @@ bool MidiLearn::runMidiLearn(int intVal, ushort CC, uchar chan, bool in_place)
                 writeMidi(resultCmd, in_place);
             }
         }
-        if (lastpos == scan::listBlocked) // blocking all of this CC/chan pair
+        if ((status & 5) == 1) // blocking all of this CC/chan pair
             return true;
     }
     return false;
@@ -227,49 +223,62 @@ bool MidiLearn::writeMidi(CommandBlock& cmd, bool in_place)
  * This will only be called by incoming midi. It is the only function that
  * needs to be really quick
  */
-int MidiLearn::findEntry(list<LearnBlock>& midi_list, int lastpos, ushort CC, uchar chan, LearnBlock& block, bool show)
+bool MidiLearn::fetchLine(uint32_t key, uint32_t line, LearnBlock& block)
 {
-    int newpos = 0; // 'last' comes in at listBlocked for the first call
-    list<LearnBlock>::iterator it = midi_list.begin();
-
-    while (newpos <= lastpos && it != midi_list.end())
+    bool found = false;
+    ++ indexReaders;
+    LearnIndex const* lookup = index.load();
+    if (lookup)
     {
-        ++ it;
-        ++ newpos;
+        auto slice = lookup->slices.find(key);
+        if (slice != lookup->slices.end() && line < slice->second.end - slice->second.begin)
+        {
+            block = lookup->lines[slice->second.begin + line];
+            found = true;
+        }
     }
-    if (it == midi_list.end())
-        return scan::noList;
+    -- indexReaders;
+    return found;
+}
 
-    while ((CC != it->CC || (it->chan != 16 && chan != it->chan)) &&  it != midi_list.end())
-    {
-        ++ it;
-        ++ newpos;
-    }
-    if (it == midi_list.end())
-        return scan::noList;
 
-    while (CC == it->CC && it != midi_list.end())
+/*
+ * Called after every change to midi_list, never by incoming midi.
+ * For each CC and each channel, collect the matching lines, as
+ * they would be met walking the list, up to the first one blocking.
+ */
+void MidiLearn::rebuildIndex()
+{
+    std::lock_guard<std::mutex> guard(rebuildLock);
+    std::unique_ptr<LearnIndex> fresh;
+    if (not midi_list.empty())
     {
-        if ((it->chan >= 16 || chan == it->chan) && CC == it->CC)
-        {
-            if (show)
-                synth.getRuntime().Log("Found line " + findName(*it) + "  at " + to_string(newpos)); // a test!
-            block.chan    = it->chan;
-            block.CC      = it->CC;
-            block.min_in  = it->min_in;
-            block.max_in  = it->max_in;
-            block.status  = it->status;
-            block.min_out = it->min_out;
-            block.max_out = it->max_out;
-            block.frame.data = it->frame.data;
-            if ((it->status & 5) == 1) // blocked, not muted
-                return scan::listBlocked; // don't allow any more of this CC and channel;
-            return newpos;
-        }
-        ++ it;
-        ++ newpos;
+        fresh.reset(new LearnIndex);
+        std::unordered_map<ushort, std::vector<LearnBlock const*>> byCC;
+        for (LearnBlock const& block : midi_list)
+            byCC[block.CC].push_back(&block);
+
+        for (auto const& group : byCC)
+            for (uint32_t chan = 0; chan < NUM_MIDI_CHANNELS; ++chan)
+            {
+                uint32_t begin = uint32_t(fresh->lines.size());
+                for (LearnBlock const* block : group.second)
+                {
+                    if (block->chan < NUM_MIDI_CHANNELS && block->chan != chan)
+                        continue;
+                    fresh->lines.push_back(*block);
+                    if ((block->status & 5) == 1) // blocked, not muted
+                        break;
+                }
+                uint32_t end = uint32_t(fresh->lines.size());
+                if (end > begin)
+                    fresh->slices[(uint32_t(group.first) << 8) | chan] = LearnIndex::Slice{begin, end};
+            }
     }
-    return scan::listEnd;
+    index.store(fresh.get());
+    while (indexReaders.load() > 0)
+        std::this_thread::yield(); // a reader may still use the old one
+    currentIndex = std::move(fresh);
 }
 
 
@@ -382,6 +391,7 @@ bool MidiLearn::remove(int itemNumber)
     if (it != midi_list.end())
     {
         midi_list.erase(it);
+        rebuildIndex();
         return true;
     }
     return false;
@@ -410,6 +420,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
     if (control == MIDILEARN::control::clearAll)
     {
         midi_list.clear();
+        rebuildIndex();
         updateGui();
         synth.getRuntime().Log("List cleared");
         return;
@@ -617,6 +628,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
         it->min_in = insert;
         it->max_in = parameter;
         it->status = type;
+        rebuildIndex();
         writeToGui(response);
         return;
     }
@@ -656,6 +668,7 @@ void MidiLearn::generalOperations(CommandBlock& cmd)
             midi_list.push_back(entry);
         else
             midi_list.insert(it, entry);
+        rebuildIndex();
 
         synth.getRuntime().Log("Moved line to " + to_string(lineNo + 1) + " " + lineName);
         updateGui();
@@ -762,6 +775,7 @@ void MidiLearn::insertLine(ushort CC, uchar chan)
             CCtype = "NRPN " + asHexString((CCh >> 7) & 0x7f) + " " + asHexString(CCh & 0x7f);
         synth.getRuntime().Log("Learned " + CCtype + "  Chan " + to_string((int)entry.chan + 1) + "  " + learnedName);
     }
+    rebuildIndex();
     updateGui(MIDILEARN::control::limit);
     learning = false;
 }
@@ -971,7 +985,10 @@ bool MidiLearn::extractMidiListData(XMLStore& xml)
     midi_list.clear();
     XMLtree xmlLearn = xml.getElm("MIDILEARN");
     if (not xmlLearn)
+    {
+        rebuildIndex();
         return false; // notify caller: missing data
+    }
 
     uint ID{0};
     while (true)
@@ -1093,6 +1110,7 @@ if (DECODE_MODE & 1)
 }
         }// <LINE>
     }   // while
+    rebuildIndex();
     return true;
 }
 
@@ -26,6 +26,11 @@
 
 #include <list>
 #include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
 
 #include "Interface/InterChange.h"
 #include "Interface/Data2Text.h"
@@ -90,7 +95,23 @@ class MidiLearn : private DataText, TextData
         string       learnedName;
         CommandBlock learnTransferBlock;
 
-        int findEntry(list<LearnBlock>&, int lastpos, ushort CC, uchar chan, LearnBlock& block, bool show);
+        /* Immutable lookup from (CC, channel) to the lines responding, in list
+         * order and ending with a blocking line. Rebuilt whenever midi_list
+         * has been edited and published by swapping the pointer; incoming MIDI
+         * finds its lines without walking the list or allocating. */
+        struct LearnIndex
+        {
+            struct Slice { uint32_t begin, end; };
+            std::vector<LearnBlock> lines;
+            std::unordered_map<uint32_t, Slice> slices;
+        };
+        std::unique_ptr<LearnIndex> currentIndex; // owned by the editing side
+        std::atomic<LearnIndex const*> index;
+        std::atomic<int> indexReaders;            // old index is kept until none is left
+        std::mutex rebuildLock;
+
+        void rebuildIndex();
+        bool fetchLine(uint32_t key, uint32_t line, LearnBlock& block);
         string findName(LearnBlock&);
         void insertLine(ushort CC, uchar chan);
         bool saveList(string const& name);
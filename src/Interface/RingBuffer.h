@@ -56,6 +56,14 @@ class RingBuffer final : private std::array <char, (1 << log2Blocks) * (1 << log
     bool write (const char * writeData);
 
     bool read (char * readData) const;
+
+    // blocks waiting to be read; a snapshot only
+    size_t pending () const
+      {
+        uint32_t write = writePoint.load (std::memory_order_relaxed);
+        uint32_t read = readPoint.load (std::memory_order_relaxed);
+        return ((write - read) & mask) / bytes;
+      }
   };
 
 
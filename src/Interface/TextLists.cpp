@@ -62,6 +62,8 @@ std::string toplist [] = {
     "  INstrument <n>",         "delete instrument from slot n in current bank",
     "  YOshimi <n>",            "close instance ID",
     "  MLearn <s> [n]",         "delete midi learned 'ALL' whole list, or '@'(n) line",
+    "  PADCache",               "delete all stored PADSynth wavetables",
+    "  CAche",                  "drop all instruments held in memory",
     "Set/Read/MLearn",          "manage all main parameters",
     "MINimum/MAXimum/DEFault",  "find ranges",
     "  Part [n] ...",           "enter context level at part n",
@@ -115,6 +117,12 @@ std::string configlist [] = {
     "BUffer <n>",          "* internal size (power 2 16-4096)",
     "PAdsynth [s]",        "interpolation type (Linear, other = cubic)",
     "BUIldpad [s]",        "PADSynth wavetable build mode (Muted, Background, Autoapply)",
+    "RENder <n>",          "* additional threads computing parts (0-16, 0 = off)",
+    "CUll Level <n>",      "dB below which a released note counts as silent (-150 to -60)",
+    "CUll Time <n>",       "ms a released note may stay silent before it is stopped (0-5000, 0 = never)",
+    "CAche Size <n>",      "MiB of bank instruments kept in memory (0-4096, 0 = off)",
+    "CAche Preload [s]",   "load the current bank into memory in the background (ON, {other})",
+    "BInary [s]",          "save session state in compact binary form (ON, {other})",
     "Virtual <n>",         "keyboard (0 = QWERTY, 1 = Dvorak, 2 = QWERTZ, 3 = AZERTY)",
     "Xml <n>",             "compression (0-9)",
     "REports [s]",         "destination (Stdout, other = console)",
@@ -201,6 +209,8 @@ std::string partlist [] = {
     "POrtamento <s>",      "portamento (ON, {other})",
     "Mode <s>",            "key mode (Poly, Mono, Legato)",
     "Note <n>",            "note polyphony",
+    "VOIces <n>",          "voice capacity, beyond that voices are stolen",
+    "STEal <s>",           "voice to steal (Released, Quietest, Key)",
     "SHift <n>",           "key shift semitones (0 no shift)",
     "BYpass <n> <s>",      "bypass part effect number n, (ON, {other})",
     "EFfects [n]",         "enter effects context level",
@@ -1041,6 +1051,9 @@ std::string listlist [] = {
     "Tuning",           "microtonal scale tunings",
     "Keymap",           "microtonal scale keyboard map",
     "Config",           "current configuration",
+    "PADCache",         "location and size of stored PADSynth wavetables",
+    "CAche",            "instruments held in memory and program change hit rate",
+    "PROFile [s]",      "DSP time per stage, part and engine ('Reset' to start over)",
     "MLearn [s <n>]",   "midi learned controls ('@' n for full details on one line)",
     "SECtion [s]",      "copy/paste section presets",
     "History [s]",      "recent files (Patchsets, SCales, STates, Vectors, MLearn)",
@@ -1052,6 +1065,7 @@ std::string listlist [] = {
 std::string testlist [] = {
     "NOte [n]",         "midi note to play for test",
     "CHannel [n]",      "midi channel to use for the test note",
+    "PArts [n]",        "play the test note on n consecutive channels (parts) at once",
     "VElocity [n]",     "velocity to use for note on/off",
     "DUration [n]",     "overall duration for the test sound",
     "HOldfraction [n]", "fraction of the duration to play sound before note off",
@@ -1062,6 +1076,11 @@ std::string testlist [] = {
     "SWapWave [n]",     "swap wavetable of 1st PADSynth item after offset n",
     "BUffersize [n]",   "number of samples per Synth-call < global buffsize (=default)",
     "TArget [s]",       "target file path to write sound data (empty: /dev/null)",
+    "BEnchmark [s]",    "run the benchmark scenarios instead, writing results to file s",
+    "BAseline [s]",     "earlier benchmark results to check for regressions",
+    "THreshold [n]",    "slowdown (fraction) against the baseline counted as regression",
+    "COrpus [s]",       "bank root holding the benchmark instruments (empty: search)",
+    "KErnels [n]",      "instead check n random cases of the unison kernels against scalar code",
     "EXEcute",          "actually trigger the test. Stops all other sound output.",
     "@end","@end"
 };
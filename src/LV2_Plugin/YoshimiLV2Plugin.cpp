@@ -123,6 +123,7 @@ void YoshimiLV2Plugin::process(uint32_t sample_count)
      * However, Yoshimi is always correct when working standalone.
      */
 
+    synth.profiler.beginPeriod(); // the whole run counts, however split at events
     uint32_t processed = 0;
     BeatTracker::BeatValues beats(beatTracker->getRawBeatValues());
     uint32_t beatsAt = 0;
@@ -251,6 +252,7 @@ void YoshimiLV2Plugin::process(uint32_t sample_count)
         }
         processed += mastered_chunk;
     }
+    synth.profiler.endPeriod(synth.samplerate);
 
     float bpmInc = (float)(sample_count - beatsAt) * beats.bpm / (synth.samplerate_f * 60.f);
     beats.songBeat += bpmInc;
@@ -551,7 +553,8 @@ LV2_State_Status YoshimiLV2Plugin::stateSave(LV2_State_Store_Function store, LV2
     char* data{nullptr};
     int sz = runtime().saveSessionData(&data);
 
-    store(handle, _yoshimi_state_id, data, sz, _atom_string_id, LV2_STATE_IS_POD | LV2_STATE_IS_PORTABLE);
+    // compact binary form, in native byte order
+    store(handle, _yoshimi_state_id, data, sz, _atom_type_chunk, LV2_STATE_IS_POD);
     free(data);
     return LV2_STATE_SUCCESS;
 }
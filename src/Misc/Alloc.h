@@ -74,4 +74,32 @@ public:
 };
 
 
+
+/* Intermediary sample buffers used while computing notes and parts within one period.
+ * These replace local memory allocations that were being made every time an add or
+ * sub note was processed. Shared, so treat with care: each thread computing parts
+ * must use its own set (see RenderPool).
+ */
+struct ScratchBuffers
+{
+    Samples genTmp1;  // for add and sub notes
+    Samples genTmp2;
+    Samples genTmp3;
+    Samples genTmp4;
+
+    Samples genMixl;  // for part mix
+    Samples genMixr;
+
+    void reset(size_t buffSize)
+    {
+        genTmp1.reset(buffSize);
+        genTmp2.reset(buffSize);
+        genTmp3.reset(buffSize);
+        genTmp4.reset(buffSize);
+        genMixl.reset(buffSize);
+        genMixr.reset(buffSize);
+    }
+};
+
+
 #endif /*MISC_ALLOC_H*/
@@ -38,6 +38,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <ctime>
 
 #include "Misc/XMLStore.h"
 #include "Misc/Config.h"
@@ -46,6 +47,7 @@
 #include "Misc/TextMsgBuffer.h"
 #include "Misc/FileMgrFuncs.h"
 #include "Misc/FormatFuncs.h"
+#include "Misc/BuildScheduler.h"
 
 const int BANKS_VERSION = 11;
 
@@ -86,6 +88,7 @@ Bank::Bank(SynthEngine& _synth)
     , defaultInsName{}
     , foundLocal{file::localDir() + "/found/"}
     , roots{}
+    , scannedFiles{}
     , synth(_synth)
     { }
 
@@ -287,6 +290,8 @@ bool Bank::savetoslot(size_t rootID, size_t bankID, int ninstrument, int npart)
 
     if (saveType & 2) // Yoshimi format
         ok1 = synth.part[npart]->saveXML(fullpath, true);
+    synth.instrumentCache.forget(fullpath);
+    synth.instrumentCache.forget(setExtension(fullpath, EXTEN::zynInst));
     if (!ok1 || !ok2)
         return false;
 
@@ -467,6 +472,7 @@ void Bank::checkbank(size_t rootID, size_t banknum)
     }
 
     thisBank.clear();
+    markScanned(rootID, banknum);
 }
 
 
@@ -517,6 +523,7 @@ bool Bank::loadbank(size_t rootID, size_t banknum)
         instrumentsInBanks += 1;
     }
     thisBank.clear();
+    markScanned(rootID, banknum);
     return true;
 }
 
@@ -1080,6 +1087,79 @@ bool Bank::isValidBank(string chkdir)
 }
 
 
+/*
+ * Adding, removing or renaming any file gives the bank directory a new
+ * modification time, so a bank still showing the time of its last scan
+ * is known to hold just the instruments listed in the bank file.
+ */
+bool Bank::isUnchangedBank(size_t rootID, size_t bankID, string const& bankdir)
+{
+    uint dirTime = roots [rootID].banks [bankID].dirTime;
+    return dirTime != 0 and dirTime == uint(isDirectory(bankdir));
+}
+
+
+void Bank::markScanned(size_t rootID, size_t bankID)
+{
+    uint dirTime = uint(isDirectory(getBankPath(rootID, bankID)));
+    if (time(nullptr) - time_t(dirTime) < 2)
+        dirTime = 0; // could still change within the same second unnoticed
+    roots [rootID].banks [bankID].dirTime = dirTime;
+}
+
+
+/*
+ * Reading every instrument file to find the engines used is by far
+ * the slowest part of a bank scan, so this is done up front for all
+ * the given banks of a root, with the files spread over the task runner.
+ * Instruments already listed for a known bank are not read again.
+ * The results are picked up by addtobank().
+ */
+void Bank::scanAhead(size_t rootID, string const& rootdir, list<string> const& bankdirs)
+{
+    map<string, size_t> known;
+    if (version == BANKS_VERSION) // otherwise all banks are loaded afresh
+        for (auto& [bankID, bank] : roots [rootID].banks)
+            known[bank.dirname] = bankID;
+
+    std::vector<string> files;
+    for (string const& dirname : bankdirs)
+    {
+        std::set<string> listed;
+        auto bank = known.find(dirname);
+        if (bank != known.end())
+            for (auto& [pos, instrument] : roots [rootID].banks [bank->second].instruments)
+                if (instrument.used)
+                    listed.insert(file::findLeafName(instrument.filename));
+
+        string bankdir = rootdir + dirname + "/";
+        list<string> thisBank;
+        uint32_t found = listDir(&thisBank, bankdir);
+        if (found == 0xffffffff)
+            continue;
+        for (string const& candidate : thisBank)
+        {
+            string exten = file::findExtension(candidate);
+            if (candidate.size() <= exten.size() or (exten != EXTEN::yoshInst and exten != EXTEN::zynInst))
+                continue;
+            if (listed.count(file::findLeafName(candidate)))
+                continue;
+            if (exten == EXTEN::zynInst and isRegularFile(setExtension(bankdir + candidate, EXTEN::yoshInst)))
+                continue; // the .xiy will be used
+            files.push_back(bankdir + candidate);
+        }
+    }
+
+    std::vector<ScannedFile> results(files.size());
+    task::parallelFor(files.size(), [&](size_t i)
+                                    {
+                                        results[i].features = XMLStore::checkfileinformation(files[i], results[i].report);
+                                    });
+    for (size_t i = 0; i < files.size(); ++i)
+        scannedFiles[files[i]] = std::move(results[i]);
+}
+
+
 /**
  * Add an instrument to the bank.
  * If pos is -1 try to find next suitable position
@@ -1141,6 +1221,7 @@ bool Bank::addtobank(size_t rootID, size_t bankID, int pos, string filename, con
      * we store its original filename while showing an offset ID.
      * If the location is writable we move the file.
      */
+    string scannedAs = bankdirname + filename;
     if (renameFile(bankdirname + filename, bankdirname + newfile))
         filename = newfile;
 
@@ -1150,10 +1231,22 @@ bool Bank::addtobank(size_t rootID, size_t bankID, int pos, string filename, con
         file_to_evaluate = setExtension(file_to_evaluate, EXTEN::zynInst);
     exten = file::findExtension(file_to_evaluate);
     filename = file::findLeafName(file_to_evaluate)+exten;
+    if (file::findExtension(scannedAs) != exten)
+        scannedAs = file_to_evaluate; // not the file that was renamed
 
     // scan the actual file to verify type and find Add|Sub|Pad-Synth usage
     auto& logger{synth.getRuntime().getLogger()};
-    auto detectedFeatures = XMLStore::checkfileinformation(file_to_evaluate, logger);
+    XMLStore::Features detectedFeatures;
+    auto scanned = scannedFiles.find(scannedAs);
+    if (scanned != scannedFiles.end())
+    {// already done by scanAhead()
+        detectedFeatures = scanned->second.features;
+        if (not scanned->second.report.empty())
+            logger(scanned->second.report, _SYS_::LogNotSerious);
+        scannedFiles.erase(scanned);
+    }
+    else
+        detectedFeatures = XMLStore::checkfileinformation(file_to_evaluate, logger);
 
     // store collected information into the Bank slot
     InstrumentEntry &instrRef = getInstrumentReference(rootID, bankID, pos);
@@ -1681,18 +1774,34 @@ bool Bank::installNewRoot(size_t rootID, string rootdir, bool reload)
 
     map<string, string> bankDirsMap;
 
+    // banks not touched since the last scan can be taken as listed
+    std::set<string> unchanged;
+    if (reload and version == BANKS_VERSION)
+    {
+        for (auto& [bankID, bank] : roots [rootID].banks)
+            if (not bank.dirname.empty() and isUnchangedBank(rootID, bankID, rootdir + bank.dirname))
+                unchanged.insert(bank.dirname);
+    }
+
     // thin out invalid directories
     int validBanks = 0;
+    list<string> toScan;
     list<string>::iterator r_it = thisRoot.end();
     while (r_it != thisRoot.begin())
     {
         string candidate = *--r_it;
         string chkdir = rootdir + candidate;
-        if (isValidBank(chkdir))
+        if (unchanged.count(candidate))
             ++validBanks;
+        else if (isValidBank(chkdir))
+        {
+            ++validBanks;
+            toScan.push_back(candidate);
+        }
         else
             r_it = thisRoot.erase(r_it);
     }
+    scanAhead(rootID, rootdir, toScan);
     bool result = true;
     if (validBanks >= MAX_BANKS_IN_ROOT)
         synth.getRuntime().Log("Warning: There are " + to_string(validBanks - MAX_BANKS_IN_ROOT) + " too many valid bank candidates");
@@ -1720,7 +1829,8 @@ bool Bank::installNewRoot(size_t rootID, string rootdir, bool reload)
 
                     if (version == BANKS_VERSION) // all we need to do!
                     {
-                        checkbank(rootID, id);
+                        if (not unchanged.count(trybank))
+                            checkbank(rootID, id);
                         instrumentsInBanks += getBankSize(id, rootID);
                     }
                     else
@@ -1801,6 +1911,7 @@ bool Bank::installNewRoot(size_t rootID, string rootdir, bool reload)
     }
     if (thisRoot.size())
         thisRoot.clear(); // leave it tidy
+    scannedFiles.clear();
     return result;
 }
 
@@ -1819,6 +1930,7 @@ void Bank::saveToConfigFile(XMLtree& xmlBankList)
             {
                 XMLtree xmlBank = xmlBankroot.addElm("bank_id", bankID);
                 xmlBank.addPar_str("dirname", bank.dirname);
+                xmlBank.addPar_uint("dir_time", bank.dirTime);
 
                 for (size_t pos=0; pos < MAX_INSTRUMENTS_IN_BANK; ++pos)
                 {
@@ -1862,6 +1974,7 @@ void Bank::loadFromConfigFile(XMLtree& xmlBankList)
                         string bankDirname = xmlBank.getPar_str("dirname");
                         roots[i].banks[bankID].dirname = bankDirname;
                         BankEntry& bank = roots[i].banks[bankID];
+                        bank.dirTime = xmlBank.getPar_uint("dir_time", 0);
                         for (size_t pos=0; pos < MAX_INSTRUMENTS_IN_BANK; ++pos)
                         {
                             if (XMLtree xmlInst = xmlBank.getElm("instrument_id", pos))
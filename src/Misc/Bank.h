@@ -28,10 +28,12 @@
 #define BANK_H
 
 #include "Misc/Part.h"
+#include "Misc/XMLStore.h"
 #include "Misc/FormatFuncs.h"
 
 #include <optional>
 #include <string>
+#include <list>
 #include <map>
 
 using std::string;
@@ -80,11 +82,13 @@ using InstrumentEntryMap = std::map<int, InstrumentEntry> ;
 /** Describes a Bank
  *   - directory name
  *   - instrument map for this directory
+ *   - directory modification time when last scanned (0 = unknown)
  */
 struct BankEntry
 {
     string dirname;
     InstrumentEntryMap instruments;
+    uint dirTime{0};
 };
 
 /** Maps bank id to bank entry. */
@@ -187,6 +191,13 @@ class Bank
 
         RootEntryMap  roots;
 
+        struct ScannedFile
+        {
+            XMLStore::Features features;
+            string report;
+        };
+        std::map<string, ScannedFile> scannedFiles;  // features found ahead by scanAhead(), keyed by full path
+
         SynthEngine& synth;
 
 
@@ -194,6 +205,9 @@ class Bank
         void deletefrombank(size_t rootID, size_t bankID, uint pos);
         bool isOccupiedRoot(string rootCandidate);
         bool isValidBank(string chkdir);
+        bool isUnchangedBank(size_t rootID, size_t bankID, string const& bankdir);
+        void markScanned(size_t rootID, size_t bankID);
+        void scanAhead(size_t rootID, string const& rootdir, std::list<string> const& bankdirs);
 
         InstrumentEntry& getInstrumentReference(size_t rootID, size_t bankID, size_t ninstrument);
         void updateShare(string bankdirs[], string baseDir, string shareID);
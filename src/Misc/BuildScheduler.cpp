@@ -24,10 +24,24 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <condition_variable>
+#include <semaphore.h>
+
+using std::atomic;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::memory_order_seq_cst;
 
 
 namespace { // Implementation details of scheduling...
 
+    using Clock = std::chrono::steady_clock;
+    using task::Priority;
+
     /* »dirty wait delay« : when further rebuilds are requested while
      * a background build process is underway, an additional grace period
      * is added to allow for more changes to trickle in and avoid overloading
@@ -37,101 +51,479 @@ namespace { // Implementation details of scheduling...
     /* number of threads to keep free as headroom for the Synth */
     const size_t REQUIRED_HEADROOM = 2;
 
-    /* factor to overload the nominally available CPUs */
-    const double OVERPROVISIONING = 1.5;
+    const uint NUM_PRIORITIES = 2;
 
     size_t determineUsableBackgroundConcurrency()
     {
-        size_t cpuCount = std::thread::hardware_concurrency();
-        int free = cpuCount * OVERPROVISIONING - REQUIRED_HEADROOM;
-        return std::max(free, 1);
+        int cpuCount = std::thread::hardware_concurrency();
+        return std::max(cpuCount - int(REQUIRED_HEADROOM), 1);
     }
 
 
+    /* A task together with its bookkeeping; passed by pointer through the queues */
+    struct Job
+    {
+        task::RunnerBackend::Task task;
+        Priority prio;
+        Clock::time_point scheduled;
+    };
 
-    class TaskRunnerImpl
+
+    /* Work-stealing deque (Chase and Lev, in the formulation for weak memory models
+     * by Lê, Pop, Cohen and Zappa Nardelli, PPoPP 2013). Only the owning worker may
+     * push() and pop() at the bottom end; any thread can steal() from the top end.
+     * Capacity is fixed; when full, push() fails and the caller must go elsewhere. */
+    class WorkDeque
     {
-        std::mutex mtx;
-        using Guard = const std::lock_guard<std::mutex>;
+        static const int64_t CAPACITY = 256;   // power of 2
 
-        using Task = task::RunnerBackend::Task;
+        alignas(64) atomic<int64_t> top{0};
+        alignas(64) atomic<int64_t> bottom{0};
+        atomic<Job*> slot[CAPACITY]{};
 
-        std::queue<Task> waitingTasks{};
+        public:
+            bool push(Job* job)
+            {
+                int64_t b = bottom.load(memory_order_relaxed);
+                int64_t t = top.load(memory_order_acquire);
+                if (b - t >= CAPACITY)
+                    return false;
+                slot[b & (CAPACITY - 1)].store(job, memory_order_relaxed);
+                std::atomic_thread_fence(memory_order_release);
+                bottom.store(b + 1, memory_order_relaxed);
+                return true;
+            }
 
-        static const size_t THREAD_LIMIT;
-        size_t runningThreads = 0;
+            Job* pop()
+            {
+                int64_t b = bottom.load(memory_order_relaxed) - 1;
+                bottom.store(b, memory_order_relaxed);
+                std::atomic_thread_fence(memory_order_seq_cst);
+                int64_t t = top.load(memory_order_relaxed);
+                Job* job = nullptr;
+                if (t <= b)
+                {
+                    job = slot[b & (CAPACITY - 1)].load(memory_order_relaxed);
+                    if (t == b)
+                    {// last element: race against thieves
+                        if (not top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+                            job = nullptr;
+                        bottom.store(b + 1, memory_order_relaxed);
+                    }
+                }
+                else
+                    bottom.store(b + 1, memory_order_relaxed);
+                return job;
+            }
+
+            Job* steal()
+            {
+                int64_t t = top.load(memory_order_acquire);
+                std::atomic_thread_fence(memory_order_seq_cst);
+                int64_t b = bottom.load(memory_order_acquire);
+                if (t >= b)
+                    return nullptr;
+                Job* job = slot[t & (CAPACITY - 1)].load(memory_order_relaxed);
+                if (not top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+                    return nullptr; // lost the race; caller moves on
+                return job;
+            }
+    };
+
+
+    /* Bounded multi-producer / multi-consumer queue (after Dmitry Vyukov),
+     * used to hand over tasks scheduled from outside the worker threads. */
+    class InjectionQueue
+    {
+        static const size_t CAPACITY = 1024;   // power of 2
+
+        struct Cell
+        {
+            atomic<size_t> sequence;
+            Job* job;
+        };
+        Cell cell[CAPACITY];
+        alignas(64) atomic<size_t> enqueuePos{0};
+        alignas(64) atomic<size_t> dequeuePos{0};
 
         public:
-            /* Meyer's Singleton */
+            InjectionQueue()
+            {
+                for (size_t i = 0; i < CAPACITY; ++i)
+                    cell[i].sequence.store(i, memory_order_relaxed);
+            }
+
+            bool push(Job* job)
+            {
+                size_t pos = enqueuePos.load(memory_order_relaxed);
+                while (true)
+                {
+                    Cell& c = cell[pos & (CAPACITY - 1)];
+                    size_t seq = c.sequence.load(memory_order_acquire);
+                    intptr_t diff = intptr_t(seq) - intptr_t(pos);
+                    if (diff == 0)
+                    {
+                        if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                        {
+                            c.job = job;
+                            c.sequence.store(pos + 1, memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0)
+                        return false; // full
+                    else
+                        pos = enqueuePos.load(memory_order_relaxed);
+                }
+            }
+
+            Job* pop()
+            {
+                size_t pos = dequeuePos.load(memory_order_relaxed);
+                while (true)
+                {
+                    Cell& c = cell[pos & (CAPACITY - 1)];
+                    size_t seq = c.sequence.load(memory_order_acquire);
+                    intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+                    if (diff == 0)
+                    {
+                        if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                        {
+                            Job* job = c.job;
+                            c.sequence.store(pos + CAPACITY, memory_order_release);
+                            return job;
+                        }
+                    }
+                    else if (diff < 0)
+                        return nullptr; // empty
+                    else
+                        pos = dequeuePos.load(memory_order_relaxed);
+                }
+            }
+    };
+
+
+    /* lock-free accumulation of latency figures, in microseconds */
+    struct LatencyStats
+    {
+        atomic<uint64_t> tasks{0};
+        atomic<uint64_t> waitSum{0}, waitMax{0};
+        atomic<uint64_t> runSum{0},  runMax{0};
+
+        static void raiseMax(atomic<uint64_t>& max, uint64_t val)
+        {
+            uint64_t prev = max.load(memory_order_relaxed);
+            while (prev < val and not max.compare_exchange_weak(prev, val, memory_order_relaxed))
+            { }
+        }
+
+        void record(uint64_t wait, uint64_t run)
+        {
+            tasks.fetch_add(1, memory_order_relaxed);
+            waitSum.fetch_add(wait, memory_order_relaxed);
+            runSum.fetch_add(run, memory_order_relaxed);
+            raiseMax(waitMax, wait);
+            raiseMax(runMax, run);
+        }
+    };
+
+    inline uint64_t micros(Clock::duration dur)
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(dur).count());
+    }
+
+
+
+    class TaskRunnerImpl
+    {
+        using Task = task::RunnerBackend::Task;
+
+        struct Worker
+        {
+            WorkDeque local[NUM_PRIORITIES];
+        };
+
+        const size_t numWorkers;
+        std::unique_ptr<Worker[]> worker;
+        InjectionQueue injected[NUM_PRIORITIES];
+        LatencyStats stats[NUM_PRIORITIES];
+
+        // takes the jobs not fitting into a full injection queue;
+        // scheduling thus never has to wait for the workers to catch up
+        std::deque<Job*> overflow[NUM_PRIORITIES];
+        std::mutex overflowMtx;
+        atomic<size_t> overflowCnt{0};
+
+        // parking of idle workers
+        sem_t wakeup;
+        atomic<int> sleeping{0};
+        std::once_flag launched;
+
+        // delayed re-queue
+        struct Delayed
+        {
+            Clock::time_point due;
+            Job* job;
+            bool operator<(Delayed const& other) const { return due > other.due; } // earliest on top
+        };
+        std::priority_queue<Delayed> delayed;
+        std::mutex timerMtx;
+        std::condition_variable timerWakeup;
+        std::once_flag timerLaunched;
+
+        // identifies the worker running the current thread (if any)
+        static thread_local Worker* currentWorker;
+        static thread_local Priority currentPrio;
+
+        public:
+            TaskRunnerImpl()
+                : numWorkers{determineUsableBackgroundConcurrency()}
+                , worker{new Worker[numWorkers]}
+            {
+                sem_init(&wakeup, 0, 0);
+            }
+
+            /* Meyer's Singleton; never destroyed,
+             * since detached workers may still be parked at shutdown */
             static TaskRunnerImpl& access()
             {
-                static TaskRunnerImpl instance{};
-                return instance;
+                static TaskRunnerImpl* instance = new TaskRunnerImpl;
+                return *instance;
+            }
+
+            static Priority priorityOfCaller(Priority fallback)
+            {
+                return currentWorker? currentPrio : fallback;
             }
 
-            /* Implementation of scheduling into background thread:
-             * pass the work task through a queue and start up to
-             * THREAD_LIMIT workers to consume those work tasks. */
-            void schedule(Task&& task)
+            static bool isWorker()
             {
-                Guard lock(mtx);
-                waitingTasks.push(move(task));
-                if (runningThreads < THREAD_LIMIT)
-                    launchWorker();
-            };
+                return currentWorker != nullptr;
+            }
 
-            void reschedule(Task&& task)
+            /* run one further queued job within the current worker thread,
+             * while the task running there waits for some other task */
+            bool helpOut()
             {
-                Task delayedTask{
-                    [workOp = move(task)] () -> void
-                        {// this code runs within a worker thread
-                            std::this_thread::sleep_for(RESCHEDULE_DELAY);
-                            workOp();
-                        }};
-                schedule(move(delayedTask));
+                if (not currentWorker)
+                    return false;
+                Job* job = findWork(size_t(currentWorker - worker.get()));
+                if (not job)
+                    return false;
+                Priority ownPrio = currentPrio;
+                run(job);
+                currentPrio = ownPrio;
+                return true;
+            }
+
+            void schedule(Task&& task, Priority prio)
+            {
+                std::call_once(launched, [this]{ launchWorkers(); });
+                submit(new Job{move(task), prio, Clock::now()});
+            }
+
+            /* re-queue the task after the »dirty wait delay«, handled by a timer thread */
+            void reschedule(Task&& task, Priority prio)
+            {
+                std::call_once(timerLaunched, [this]{ launchTimer(); });
+                Job* job = new Job{move(task), prio, Clock::time_point{}};
+                {
+                    std::lock_guard<std::mutex> lock(timerMtx);
+                    delayed.push(Delayed{Clock::now() + RESCHEDULE_DELAY, job});
+                }
+                timerWakeup.notify_one();
+            }
+
+            task::RunnerBackend::Statistics statistics(Priority prio)
+            {
+                LatencyStats& st = stats[prio];
+                size_t cnt = st.tasks.load(memory_order_relaxed);
+                double div = cnt? 1000.0 * cnt : 1.0;
+                return task::RunnerBackend::Statistics{cnt
+                                                      ,st.waitSum.load(memory_order_relaxed) / div
+                                                      ,st.waitMax.load(memory_order_relaxed) / 1000.0
+                                                      ,st.runSum.load(memory_order_relaxed) / div
+                                                      ,st.runMax.load(memory_order_relaxed) / 1000.0
+                                                      };
             }
 
         private:
-            void markWorker_finished()
+            void submit(Job* job)
+            {
+                std::call_once(launched, [this]{ launchWorkers(); });
+                if (job->scheduled == Clock::time_point{})
+                    job->scheduled = Clock::now();
+                bool queued = currentWorker and currentWorker->local[job->prio].push(job);
+                if (not queued and not injected[job->prio].push(job))
+                {
+                    std::lock_guard<std::mutex> lock(overflowMtx);
+                    overflow[job->prio].push_back(job);
+                    overflowCnt.fetch_add(1, memory_order_relaxed);
+                }
+
+                // pairs with the fence in park(): either the worker sees the job, or we see it sleeping
+                std::atomic_thread_fence(memory_order_seq_cst);
+                if (sleeping.load(memory_order_relaxed) > 0)
+                    sem_post(&wakeup);
+            }
+
+            Job* findWork(size_t self)
+            {
+                for (uint prio = 0; prio < NUM_PRIORITIES; ++prio)
+                {
+                    if (Job* job = worker[self].local[prio].pop())
+                        return job;
+                    if (Job* job = injected[prio].pop())
+                        return job;
+                    if (overflowCnt.load(memory_order_relaxed) > 0)
+                        if (Job* job = takeOverflow(prio))
+                            return job;
+                    for (size_t i = 1; i < numWorkers; ++i)
+                        if (Job* job = worker[(self + i) % numWorkers].local[prio].steal())
+                            return job;
+                }
+                return nullptr;
+            }
+
+            Job* takeOverflow(uint prio)
             {
-                Guard lock(mtx);
-                if (runningThreads == 0)
-                    throw std::logic_error("BuildScheduler: worker thread management floundered");
-                --runningThreads;
+                std::lock_guard<std::mutex> lock(overflowMtx);
+                if (overflow[prio].empty())
+                    return nullptr;
+                Job* job = overflow[prio].front();
+                overflow[prio].pop_front();
+                overflowCnt.fetch_sub(1, memory_order_relaxed);
+                return job;
             }
 
-            void launchWorker()
+            Job* park(size_t self)
             {
-                // note: mutex locked at caller
-                std::thread backgroundThread(
+                sleeping.fetch_add(1, memory_order_relaxed);
+                std::atomic_thread_fence(memory_order_seq_cst);
+                Job* job = findWork(self);
+                if (not job)
+                    while (sem_wait(&wakeup) != 0)
+                    { } // interrupted by signal
+                sleeping.fetch_sub(1, memory_order_relaxed);
+                return job;
+            }
+
+            void run(Job* job)
+            {
+                Clock::time_point start = Clock::now();
+                currentPrio = job->prio;
+                try {
+                    job->task();
+                }
+                catch(...)
+                {/* absorb failure in task */}
+                stats[job->prio].record(micros(start - job->scheduled), micros(Clock::now() - start));
+                delete job;
+            }
+
+            void launchWorkers()
+            {
+                for (size_t w = 0; w < numWorkers; ++w)
+                {
+                    std::thread backgroundThread(
+                        [this, w] () -> void
+                            {// worker thread: runs for the lifetime of the application
+                                currentWorker = &worker[w];
+                                while (true)
+                                    if (Job* job = findWork(w))
+                                        run(job);
+                                    else if (Job* job = park(w))
+                                        run(job);
+                            });
+                    backgroundThread.detach();
+                }
+            }
+
+            void launchTimer()
+            {
+                std::thread timerThread(
                     [this] () -> void
-                        {// worker thread(s): consume queue contents
-                            while (Task workOp = pullFromQueue())
-                                try {
-                                    workOp();
+                        {
+                            std::unique_lock<std::mutex> lock(timerMtx);
+                            while (true)
+                            {
+                                if (delayed.empty())
+                                    timerWakeup.wait(lock);
+                                else if (Clock::now() < delayed.top().due)
+                                    timerWakeup.wait_until(lock, delayed.top().due);
+                                else
+                                {
+                                    Job* job = delayed.top().job;
+                                    delayed.pop();
+                                    lock.unlock();
+                                    submit(job);
+                                    lock.lock();
                                 }
-                                catch(...)
-                                {/* absorb failure in workOp */}
-                            markWorker_finished();
+                            }
                         });
-                backgroundThread.detach();
-                assert(runningThreads < THREAD_LIMIT);
-                ++runningThreads;
+                timerThread.detach();
+            }
+    };
+
+    thread_local TaskRunnerImpl::Worker* TaskRunnerImpl::currentWorker = nullptr;
+    thread_local Priority TaskRunnerImpl::currentPrio = task::INTERACTIVE;
+
+
+
+    /* Shared state of a parallelFor() invocation. Helper tasks may start only after
+     * the invoking thread has already returned; such latecomers find no work left,
+     * but still hold on to this state, hence it is managed by shared_ptr. */
+    class ParallelJob
+    {
+        using Job = std::function<void(size_t)>;
+        using Guard = std::lock_guard<std::mutex>;
+
+        const size_t cnt;
+        Job job;
+
+        std::atomic<size_t> next{0};
+        size_t finished{0};
+        std::exception_ptr failure{};
+
+        std::mutex mtx;
+        std::condition_variable allDone;
+
+        public:
+            ParallelJob(size_t jobCnt, Job&& jobFun)
+                : cnt{jobCnt}
+                , job{move(jobFun)}
+            { }
+
+            /* claim and perform invocations until none are left */
+            void work()
+            {
+                for (size_t i = next.fetch_add(1); i < cnt; i = next.fetch_add(1))
+                {
+                    std::exception_ptr problem;
+                    try {
+                        job(i);
+                    }
+                    catch(...)
+                    {
+                        problem = std::current_exception();
+                    }
+                    Guard lock(mtx);
+                    if (problem and not failure)
+                        failure = problem;
+                    if (++finished == cnt)
+                        allDone.notify_all();
+                }
             }
 
-            Task pullFromQueue()
+            void awaitCompletion()
             {
-                Guard lock(mtx);
-                if (waitingTasks.empty())
-                    return Task(); // empty Task to signal end
-                Task nextWorkOp(move(waitingTasks.front()));
-                waitingTasks.pop();
-                return nextWorkOp;
+                std::unique_lock<std::mutex> lock(mtx);
+                allDone.wait(lock, [this]{ return finished == cnt; });
+                if (failure)
+                    std::rethrow_exception(failure);
             }
     };
 
-    const size_t TaskRunnerImpl::THREAD_LIMIT = determineUsableBackgroundConcurrency();
-
 }//(End)Implementation details of scheduling.
 
 
@@ -140,18 +532,49 @@ namespace task {
 
     /* === Implementation of access to the task runner === */
 
-    void RunnerBackend::schedule(Task&& task)
+    void RunnerBackend::schedule(Task&& task, Priority prio)
+    {
+        TaskRunnerImpl::access().schedule(move(task), prio);
+    }
+
+    void RunnerBackend::reschedule(Task&& task, Priority prio)
+    {
+        TaskRunnerImpl::access().reschedule(move(task), prio);
+    }
+
+    bool RunnerBackend::isWorker()
     {
-        TaskRunnerImpl::access().schedule(move(task));
+        return TaskRunnerImpl::isWorker();
     }
 
-    void RunnerBackend::reschedule(Task&& task)
+    bool RunnerBackend::helpOut()
     {
-        TaskRunnerImpl::access().reschedule(move(task));
+        return TaskRunnerImpl::isWorker()
+           and TaskRunnerImpl::access().helpOut();
+    }
+
+    RunnerBackend::Statistics RunnerBackend::statistics(Priority prio)
+    {
+        return TaskRunnerImpl::access().statistics(prio);
     }
 
     void dirty_wait_delay()
     {
         std::this_thread::sleep_for(RESCHEDULE_DELAY);
     }
+
+    void parallelFor(size_t cnt, std::function<void(size_t)> job)
+    {
+        if (cnt == 0)
+            return;
+        auto state = std::make_shared<ParallelJob>(cnt, move(job));
+        size_t helpers = std::min(cnt, size_t(std::max(1u, std::thread::hardware_concurrency()))) - 1;
+        // helpers inherit the priority when invoked from within a task
+        Priority prio = TaskRunnerImpl::priorityOfCaller(INTERACTIVE);
+        for (size_t i = 0; i < helpers; ++i)
+            RunnerBackend::schedule([state]{ state->work(); }, prio);
+
+        state->work();
+        state->awaitCompletion();
+    }
 }
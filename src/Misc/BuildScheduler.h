@@ -22,6 +22,7 @@
 #define BUILDSCHEDULER_H
 
 #include <atomic>
+#include <chrono>
 #include <future>
 #include <utility>
 #include <optional>
@@ -33,6 +34,13 @@ using std::move;
 using std::optional;
 
 
+namespace task {
+    /* Interactive work (e.g. rebuilds after edits in the GUI)
+     * is always picked up before bulk work (e.g. loading instruments) */
+    enum Priority { INTERACTIVE, BULK };
+}
+
+
 
 
 
@@ -122,7 +130,7 @@ class FutureBuild
 
 
     //--Customisation---
-    using ScheduleAction = std::function<FutureVal()>;
+    using ScheduleAction = std::function<FutureVal(task::Priority)>;
     using SchedulerSetup = std::function<ScheduleAction(BuildOp)>;
 
     ScheduleAction schedule;
@@ -148,7 +156,7 @@ class FutureBuild
         explicit operator bool()  const { return isUnderway(); }
 
         // mutating operations
-        void requestNewBuild();
+        void requestNewBuild(task::Priority =task::INTERACTIVE);
         void swap(TAB & dataToReplace);
 
         void blockingWait(bool publishResult =false);
@@ -163,14 +171,31 @@ class FutureBuild
 
 
 namespace task {
-    /* Access point to a global generic task runner backend */
+    /* Access point to a global generic task runner backend.
+     * Tasks are distributed onto a fixed set of worker threads; a task scheduled from
+     * within a worker is queued locally to that worker, while idle workers steal work.
+     * reschedule() re-queues the task after a short delay, without occupying a worker.
+     * A task waiting for another task must use helpOut() meanwhile: the awaited task
+     * may be queued behind the waiting one, and there may be only a single worker. */
     class RunnerBackend
     {
         public:
             using Task = std::function<void()>;
 
-            static void schedule(Task&&);
-            static void reschedule(Task&&);
+            static void schedule(Task&&, Priority =INTERACTIVE);
+            static void reschedule(Task&&, Priority =INTERACTIVE);
+
+            static bool isWorker();   // called from within a worker thread?
+            static bool helpOut();    // run one queued task in the calling worker; false if none
+
+            /* accumulated since program start; times in milliseconds */
+            struct Statistics
+            {
+                size_t tasks;
+                double avgWait, maxWait;   // from scheduling until the task is started
+                double avgRun,  maxRun;
+            };
+            static Statistics statistics(Priority);
     };
 
     /* Add a fixed sleep period; related to the duration of a "dirty wait".
@@ -178,6 +203,28 @@ namespace task {
      * build, since typically further subsequent changes will arrive from GUI. */
     void dirty_wait_delay();
 
+    /* Invoke job(0) ... job(cnt-1) in parallel, using the RunnerBackend, and block
+     * until all invocations are complete. The calling thread takes part in the work,
+     * thus no deadlock can happen when called from a task itself and all workers are busy.
+     * The first exception raised by any invocation is re-thrown in the calling thread. */
+    void parallelFor(size_t cnt, std::function<void(size_t)> job);
+
+    /* Block until the future is ready. When called from within a task, other
+     * queued tasks are performed while waiting, so the awaited one is never
+     * starved by the waiting task occupying the (possibly only) worker. */
+    template<class FUT>
+    void awaitResult(FUT& future)
+    {
+        if (not RunnerBackend::isWorker())
+        {
+            future.wait();
+            return;
+        }
+        while (future.wait_for(std::chrono::microseconds(0)) != std::future_status::ready)
+            if (not RunnerBackend::helpOut())
+                future.wait_for(std::chrono::milliseconds(1)); // awaited task runs elsewhere
+    }
+
 
     /* Global facility to manage building actions as background task.
      * When constructing a concrete FutureBuild instance, this front-end shall be used
@@ -192,13 +239,14 @@ namespace task {
 
         using OptionalResult = optional<TAB>;
         using BuildOperation = std::function<OptionalResult()>;
-        using ScheduleAction = std::function<FutureVal()>;
+        using ScheduleAction = std::function<FutureVal(Priority)>;
 
         private:
             struct PackagedBuildOperation
             {
                 BuildOperation buildOp;
                 FakeCopyAdapter<Promise> promise;
+                Priority prio;
 
                 void operator() ()
                 {// This code will run within the scheduler/task
@@ -222,21 +270,21 @@ namespace task {
                     // Thus use the exiting functor and promise
                     // to package them into a new task for rescheduling...
                     RunnerBackend::Task followUpTask = PackagedBuildOperation{move(buildOp),
-                                                                              move(*promise)};
-                    RunnerBackend::reschedule(move(followUpTask));
+                                                                              move(*promise), prio};
+                    RunnerBackend::reschedule(move(followUpTask), prio);
                 }
             };
 
         public:
             static ScheduleAction wireBuildFunction(BuildOperation buildOp)
             {
-                return [buildOp]()
+                return [buildOp](Priority prio)
                         {// This code will run whenever the FutureBuild wants to schedule another BuildOperation...
                             Promise promise;
                             FutureVal future = promise.get_future();
 
                             // pass BuildOperation to the Task-Runner backend, packaged as generic functor...
-                            RunnerBackend::schedule(PackagedBuildOperation{move(buildOp), move(promise)});
+                            RunnerBackend::schedule(PackagedBuildOperation{move(buildOp), move(promise), prio}, prio);
 
                             // hand-over the corresponding future to FutureBuild
                             return future;
@@ -312,7 +360,7 @@ typename FutureBuild<TAB>::BuildOp FutureBuild<TAB>::wireState(BuildOp backgroun
  * only one thread can pass, and thus no one can set the target pointer,
  * after we have loaded and found it to be NULL. */
 template<class TAB>
-void FutureBuild<TAB>::requestNewBuild()
+void FutureBuild<TAB>::requestNewBuild(task::Priority prio)
 {
     bool expectFalse{false};
     if (not dirty.compare_exchange_strong(expectFalse, true, std::memory_order_acq_rel))
@@ -325,7 +373,7 @@ void FutureBuild<TAB>::requestNewBuild()
     // If we reach this point, we are the first ones to set the dirty flag
     // and we can be sure there is currently no background task underway...
     // Launch a new background task, which on start clears the dirty flag.
-    if (not installNewBuildTarget(new FutureVal{move(schedule())}))
+    if (not installNewBuildTarget(new FutureVal{move(schedule(prio))}))
         throw std::logic_error("FutureBuild state handling logic broken: "
                                "concurrent attempt to start a build, causing data corruption.");
 }
@@ -396,12 +444,13 @@ void FutureBuild<TAB>::blockingWait(bool publishResult)
 {
     // possibly wait until the actual background task was started
     while (dirty.load(std::memory_order_relaxed) and not target.load(std::memory_order_relaxed))
-        task::dirty_wait_delay();
+        if (not task::RunnerBackend::helpOut())
+            task::dirty_wait_delay();
 
     FutureVal* future = retrieveLatestTarget();
     if (future)
     {
-        future->wait(); // blocks until result is ready
+        task::awaitResult(*future); // blocks until result is ready
 
         // we alone hold the result now; attempt to publish it for the SynthEngine
         if (not publishResult or not installNewBuildTarget(future))
@@ -416,7 +465,7 @@ FutureBuild<TAB>::~FutureBuild()
     FutureVal* future = retrieveLatestTarget();
     if (future and future->valid())
     {// indicates active background task (result not yet reaped)
-        future->wait(); // blocking wait until background task has finished
+        task::awaitResult(*future); // blocking wait until background task has finished
         delete future;
     }
 }
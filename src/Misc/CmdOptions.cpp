@@ -64,9 +64,12 @@ namespace { // constants used in the implementation
         {"name-tag",          'N',  "<tag>",    0                  , "add tag to clientname",        2},
         {"samplerate",        'R',  "<rate>",   0                  , "set alsa audio sample rate",   1},
         {"oscilsize",         'o',  "<size>",   0                  , "set AddSynth oscillator size", 1},
+        {"render-threads",     14,  "<n>",      0                  , "set additional threads computing parts", 1},
         {"state",             'S',  "<file>",   0                  , "load .state complete machine setup file", 2},
         {"load-guitheme",     'T',  "<file>",   0                  , "load .clr GUI theme file",                2},
         {"null",               13,  NULL,       0                  , "use Null-backend without audio/midi",     0},
+        {"render",             15,  "<file>",   0                  , "render .mid file into .wav, then exit (repeatable)", 0},
+        {"render-dir",         16,  "<path>",   0                  , "write rendered .wav files into this directory",      0},
 #if defined(JACK_SESSION)
         {"jack-session-uuid", 'U',  "<uuid>",   0                  , "jack session uuid",            2},
         {"jack-session-file", 'u',  "<file>",   0                  , "load named jack session file", 2},
@@ -111,6 +114,9 @@ namespace { // constants used in the implementation
             case 'S': recordOption(); break;     // load complete state file
 
             case 13:  recordToggle(); break;     // NULL backend (no audio and MIDI)
+            case 14:  recordOption(); break;     // render threads
+            case 15:  recordOption(); break;     // offline render MIDI file
+            case 16:  recordOption(); break;     // offline render target directory
 
 #if defined(JACK_SESSION)
             case 'u': recordOption(); break;     // load Jack session file
@@ -297,6 +303,29 @@ void CmdOptions::applyTo (Config& config)  const
                 config.audioEngine = no_audio;
                 config.midiEngine  = no_midi;
                 break;
+
+            case 14:
+                config.configChanged = true;
+                config.renderThreadsChanged = true;
+                config.renderThreads = std::clamp(string2int(line), 0, MAX_RENDER_THREADS);
+                break;
+
+            case 15:
+                // not marked as configChanged: offline rendering is never persisted
+                Config::renderMidiFiles.push_back(line);
+                config.engineChanged = true;
+                config.midiChanged = true;
+                config.audioEngine = offline_audio;
+                config.midiEngine  = offline_midi;
+                config.guiChanged = true;
+                config.showGui = false;
+                config.cliChanged = true;
+                config.showCli = false;
+                break;
+
+            case 16:
+                Config::renderTargetDir = line;
+                break;
         }
     }
     if (config.jackSessionUuid.size() and config.jackSessionFile.size())
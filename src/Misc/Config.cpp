@@ -31,6 +31,7 @@
 #include <cmath>
 #include <array>
 #include <string>
+#include <cstring>
 #include <libgen.h>
 #include <limits.h>
 #include <unistd.h>
@@ -120,6 +121,9 @@ int        Config::showCLIcontext{1};
 
 string Config::globalJackSessionUuid = "";
 
+std::vector<string> Config::renderMidiFiles{};
+string Config::renderTargetDir = "";
+
 const VerInfo Config::VER_YOSHI_CURR{YOSHIMI_VERSION};
 const VerInfo Config::VER_ZYN_COMPAT{2,4,3};
 
@@ -183,6 +187,13 @@ Config::Config(SynthEngine& synthInstance)
     , bufferChanged{false}
     , oscilsize{512}
     , oscilChanged{false}
+    , renderThreads{0}
+    , renderThreadsChanged{false}
+    , noteCullLevel{-100}
+    , noteCullTime{200}
+    , instrumentCacheSize{64}
+    , instrumentPreload{false}
+    , binaryState{true}
     , showGui{true}
     , storedGui{true}
     , guiChanged{false}
@@ -230,12 +241,7 @@ Config::Config(SynthEngine& synthInstance)
     , logList{}
     , manualFile{}
     , exitType{}
-    , genTmp1{}
-    , genTmp2{}
-    , genTmp3{}
-    , genTmp4{}
-    , genMixl{}
-    , genMixr{}
+    , genScratch{}
     , findManual_Thread{}
     , sigIntActive{0}
     , ladi1IntActive{0}
@@ -300,6 +306,8 @@ void Config::init()
     }
     oscilsize = nearestPowerOf2(oscilsize, MIN_OSCIL_SIZE, MAX_OSCIL_SIZE);
     buffersize = nearestPowerOf2(buffersize, MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
+    if (renderThreads > MAX_RENDER_THREADS)
+        renderThreads = MAX_RENDER_THREADS;
 
     if (!Config::globalJackSessionUuid.empty())
         jackSessionUuid = Config::globalJackSessionUuid;
@@ -338,6 +346,12 @@ void Config::populateFromPrimary()
     connectJackaudio    = primary.connectJackaudio;
     loadDefaultState    = primary.loadDefaultState;
     Interpolation       = primary.Interpolation;
+    renderThreads       = primary.renderThreads;
+    noteCullLevel       = primary.noteCullLevel;
+    noteCullTime        = primary.noteCullTime;
+    instrumentCacheSize = primary.instrumentCacheSize;
+    instrumentPreload   = primary.instrumentPreload;
+    binaryState         = primary.binaryState;
 //presetsDirlist                                        /////TODO shouldn't we populate these too? if yes -> use a STL container (e.g. std::array), which can be bulk copied
     instrumentFormat    = primary.instrumentFormat;
     enableProgChange    = primary.enableProgChange;
@@ -367,6 +381,36 @@ void Config::populateFromPrimary()
 }
 
 
+/**
+ * For headless rendering, all instances shall produce the same sound: take the
+ * engine parameters and the files to load from the primary, regardless of any
+ * stored instance config. Must be called prior to loadConfig().
+ */
+void Config::adoptRenderSetup(Config const& primary)
+{
+    assert (0 < synth.getUniqueId());
+    audioEngine  = offline_audio;
+    midiEngine   = offline_midi;
+    engineChanged = midiChanged = true;
+    samplerate   = primary.samplerate;
+    buffersize   = primary.buffersize;
+    oscilsize    = primary.oscilsize;
+    rateChanged  = bufferChanged = oscilChanged = true;
+    renderThreads = primary.renderThreads;
+    renderThreadsChanged = true;
+
+    paramsLoad     = primary.paramsLoad;
+    instrumentLoad = primary.instrumentLoad;
+    load2part      = primary.load2part;
+    midiLearnLoad  = primary.midiLearnLoad;
+    if (not primary.stateFile.empty() and primary.sessionStage == _SYS_::type::StartupSecond)
+    {// primary was launched with --state
+        stateFile    = primary.stateFile;
+        sessionStage = _SYS_::type::StartupFirst;
+    }
+}
+
+
 void Config::flushLog()
 {
     for (auto& line : logList)
@@ -616,6 +660,12 @@ void Config::addConfigXML(XMLStore& xml)
 
     conf.addPar_int ("sound_buffer_size"      , buffersize);
     conf.addPar_int ("oscil_size"             , oscilsize);
+    conf.addPar_int ("render_threads"         , renderThreads);
+    conf.addPar_int ("note_cull_level"        , noteCullLevel);
+    conf.addPar_int ("note_cull_time"         , noteCullTime);
+    conf.addPar_int ("instrument_cache_size"  , instrumentCacheSize);
+    conf.addPar_bool("instrument_preload"     , instrumentPreload);
+    conf.addPar_bool("binary_session_state"   , binaryState);
     conf.addPar_bool("reports_destination"    , toConsole);
     conf.addPar_int ("console_text_size"      , consoleTextSize);
     conf.addPar_int ("interpolation"          , Interpolation);
@@ -785,6 +835,12 @@ bool Config::updateConfig(int configKey, int value)
                 par(Cfg::showLearnEditor        ) = xmlConf.getPar_bool("open_editor_on_learned_CC", showLearnedCC);
                 par(Cfg::enableOmni             ) = xmlConf.getPar_bool("enable_omni_change", enableOmni);
                 par(Cfg::enableNRPNs            ) = xmlConf.getPar_bool("enable_incoming_NRPNs", enable_NRPN);
+                par(Cfg::renderThreads          ) = xmlConf.getPar_int ("render_threads", 0, 0, MAX_RENDER_THREADS);
+                par(Cfg::noteCullLevel          ) = xmlConf.getPar_int ("note_cull_level", noteCullLevel, MIN_NOTE_CULL_LEVEL, MAX_NOTE_CULL_LEVEL);
+                par(Cfg::noteCullTime           ) = xmlConf.getPar_int ("note_cull_time", noteCullTime, 0, MAX_NOTE_CULL_TIME);
+                par(Cfg::instrumentCacheSize    ) = xmlConf.getPar_int ("instrument_cache_size", instrumentCacheSize, 0, MAX_INSTRUMENT_CACHE);
+                par(Cfg::instrumentPreload      ) = xmlConf.getPar_bool("instrument_preload", instrumentPreload);
+                par(Cfg::binaryState            ) = xmlConf.getPar_bool("binary_session_state", binaryState);
 //              par(Cfg::saveCurrentConfig      ) = // return string (dummy)
 
                 // Alter the specific config value given
@@ -823,6 +879,12 @@ bool Config::updateConfig(int configKey, int value)
                 xmlConf.addPar_int ("enable_part_on_voice_load", 1); // for backward compatibility
                 xmlConf.addPar_bool("enable_omni_change"       , par(Cfg::enableOmni));
                 xmlConf.addPar_bool("enable_incoming_NRPNs"    , par(Cfg::enableNRPNs));
+                xmlConf.addPar_int ("render_threads"           , par(Cfg::renderThreads));
+                xmlConf.addPar_int ("note_cull_level"          , par(Cfg::noteCullLevel));
+                xmlConf.addPar_int ("note_cull_time"           , par(Cfg::noteCullTime));
+                xmlConf.addPar_int ("instrument_cache_size"    , par(Cfg::instrumentCacheSize));
+                xmlConf.addPar_bool("instrument_preload"       , par(Cfg::instrumentPreload));
+                xmlConf.addPar_bool("binary_session_state"     , par(Cfg::binaryState));
                 xmlConf.addPar_bool("ignore_reset_all_CCs"     , par(Cfg::ignoreResetAllCCs));
                 xmlConf.addPar_bool("monitor-incoming_CCs"     , par(Cfg::logIncomingCCs));
                 xmlConf.addPar_bool("open_editor_on_learned_CC",par(Cfg::showLearnEditor));
@@ -913,6 +975,13 @@ bool Config::extractConfigData(XMLStore& xml)
             buffersize = conf.getPar_int("sound_buffer_size"   , buffersize, MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
         if (!oscilChanged)
             oscilsize = conf.getPar_int ("oscil_size"          , oscilsize, MIN_OSCIL_SIZE, MAX_OSCIL_SIZE);
+        if (!renderThreadsChanged)
+            renderThreads = conf.getPar_int("render_threads"   , renderThreads, 0, MAX_RENDER_THREADS);
+        noteCullLevel = conf.getPar_int ("note_cull_level"     , noteCullLevel, MIN_NOTE_CULL_LEVEL, MAX_NOTE_CULL_LEVEL);
+        noteCullTime  = conf.getPar_int ("note_cull_time"      , noteCullTime, 0, MAX_NOTE_CULL_TIME);
+        instrumentCacheSize = conf.getPar_int ("instrument_cache_size", instrumentCacheSize, 0, MAX_INSTRUMENT_CACHE);
+        instrumentPreload   = conf.getPar_bool("instrument_preload"   , instrumentPreload);
+        binaryState         = conf.getPar_bool("binary_session_state" , binaryState);
         toConsole     = conf.getPar_bool("reports_destination" , toConsole);
         consoleTextSize=conf.getPar_int ("console_text_size"   , consoleTextSize, 11, 100);
         Interpolation = conf.getPar_int ("interpolation"       , Interpolation,    0, 1);
@@ -1122,7 +1191,8 @@ bool Config::saveSessionData(string sessionfile)
 
     capturePatchState(xml);
 
-    bool success = xml.saveXMLfile(sessionfile, getLogger(), gzipCompression);
+    bool success = binaryState? xml.saveBinaryFile(sessionfile, getLogger())
+                              : xml.saveXMLfile(sessionfile, getLogger(), gzipCompression);
     if (success)
         Log("Session data saved to \""+sessionfile+"\"", _SYS_::LogNotSerious);
     else
@@ -1130,15 +1200,19 @@ bool Config::saveSessionData(string sessionfile)
     return success;
 }
 
-/** Variation to extract config and patch state for LV2 */
+/** Variation to extract config and patch state for LV2, in compact binary form */
 int Config::saveSessionData(char** dataBuffer)
 {
     XMLStore xml{TOPLEVEL::XML::State};
 
     capturePatchState(xml);
 
-    *dataBuffer = xml.render();
-    return strlen(*dataBuffer) + 1;
+    string data = xml.renderBinary();
+    *dataBuffer = static_cast<char*>(malloc(data.size()));
+    if (not *dataBuffer)
+        return 0;
+    memcpy(*dataBuffer, data.data(), data.size());
+    return data.size();
 }
 
 void Config::capturePatchState(XMLStore& xml)
@@ -1171,14 +1245,13 @@ bool Config::restoreSessionData(string sessionfile)
     return false;
 }
 
-/** Variation to retrieve patch state and config from the LV2 host */
+/** Variation to retrieve patch state and config from the LV2 host;
+ *  sessions saved by earlier versions hold XML text instead of binary data */
 bool Config::restoreSessionData(const char* dataBuffer, int size)
 {
-    (void)size; // currently unused
-
-    XMLStore xml{dataBuffer};
+    XMLStore xml{dataBuffer, size_t(size)};
     if (not xml)
-        Log("Unable to parse XML to restore session state.");
+        Log("Unable to read data to restore session state.");
     else
         return restorePatchState(xml);
 
@@ -1335,6 +1408,10 @@ void Config::startupReport(string const& clientName)
             report += "alsa";
             break;
 
+        case offline_audio:
+            report += "offline";
+            break;
+
         default:
             report += "nada";
             break;
@@ -1352,6 +1429,10 @@ void Config::startupReport(string const& clientName)
             report += "alsa";
             break;
 
+        case offline_midi:
+            report += "offline";
+            break;
+
         default:
             report += "nada";
             break;
@@ -1720,6 +1801,27 @@ float Config::getConfigLimits(CommandBlock* getData)
         case CONFIG::control::handlePadSynthBuild:
             max = 2;
             break;
+        case CONFIG::control::renderThreads:
+            max = MAX_RENDER_THREADS;
+            break;
+        case CONFIG::control::noteCullLevel:
+            min = MIN_NOTE_CULL_LEVEL;
+            def = -100;
+            max = MAX_NOTE_CULL_LEVEL;
+            break;
+        case CONFIG::control::noteCullTime:
+            def = 200;
+            max = MAX_NOTE_CULL_TIME;
+            break;
+        case CONFIG::control::instrumentCacheSize:
+            def = 64;
+            max = MAX_INSTRUMENT_CACHE;
+            break;
+        case CONFIG::control::instrumentPreload:
+            break;
+        case CONFIG::control::binaryState:
+            def = 1;
+            break;
         case CONFIG::control::virtualKeyboardLayout:
             max = 3;
             break;
@@ -32,6 +32,7 @@
 #include <bitset>
 #include <deque>
 #include <list>
+#include <vector>
 
 #include "globals.h"
 #include "Misc/Log.h"
@@ -164,6 +165,11 @@ class Config
         string        jackSessionUuid;
         static string globalJackSessionUuid;
 
+        static std::vector<string> renderMidiFiles;  // headless rendering, see OfflineEngine
+        static string renderTargetDir;
+        bool isOfflineRender() const { return audioEngine == offline_audio; }
+        void adoptRenderSetup(Config const& primary);
+
         string        alsaAudioDevice;
         string        alsaMidiDevice;
         string        nameTag;
@@ -208,6 +214,13 @@ class Config
         bool  bufferChanged;
         uint  oscilsize;
         bool  oscilChanged;
+        uint  renderThreads;
+        bool  renderThreadsChanged;
+        int   noteCullLevel;
+        uint  noteCullTime;
+        uint  instrumentCacheSize;
+        bool  instrumentPreload;
+        bool  binaryState;
         bool  showGui;
         bool  storedGui;
         bool  guiChanged;
@@ -279,18 +292,11 @@ class Config
         int exitType;
 
         /*
-         * These replace local memory allocations that
-         * were being made every time an add or sub note
-         * was processed. Now global so treat with care!
+         * Intermediary buffers for notes, parts and sys effects,
+         * used by the audio thread. Now global so treat with care!
+         * Render threads have their own sets (see RenderPool).
          */
-        Samples genTmp1;
-        Samples genTmp2;
-        Samples genTmp3;
-        Samples genTmp4;
-
-        // as above but for part and sys effect
-        Samples genMixl;
-        Samples genMixr;
+        ScratchBuffers genScratch;
 
     private:
         void findManual();
@@ -0,0 +1,283 @@
+/*
+    DSPProfiler.cpp - where the time of each audio period is spent
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/DSPProfiler.h"
+#include "Misc/FormatFuncs.h"
+
+#include <algorithm>
+
+using std::chrono::steady_clock;
+using std::string;
+using std::to_string;
+
+using func::asCompactString;
+
+
+namespace { // implementation details
+
+    const double CALIBRATION_MIN = 0.1;   // seconds before the counter rate is trusted
+
+    const char* stageName[DSPProfiler::STAGES]  = { "mediate", "parts", "insert effects", "system effects", "mixing" };
+    const char* engineName[DSPProfiler::ENGINES] = { "AddSynth", "SubSynth", "PadSynth", "part effects" };
+
+    string percent(double part, double whole)
+    {
+        return whole > 0? asCompactString(float(100.0 * part / whole)) + "%" : "-";
+    }
+}
+
+
+DSPProfiler::DSPProfiler()
+    : inPeriod{}
+    , stageInPeriod{}
+    , periodStart{0}
+    , activeParts{0}
+    , periodFrames{0}
+    , hostPeriod{false}
+    , calibTicks{now()}
+    , calibTime{steady_clock::now()}
+    , ticksPerSec{0}
+    , resetRequested{false}
+{
+    clearAll();
+#ifndef HAVE_CYCLE_COUNTER
+    ticksPerSec = 1e9; // ticks are nanoseconds
+#endif
+}
+
+
+void DSPProfiler::clearAll()
+{
+    for (auto& c : stages)
+        c.clear();
+    for (uint npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+    {
+        partTicks[npart].clear();
+        for (auto& c : engines[npart])
+            c.clear();
+        for (auto& c : kits[npart])
+            c.clear();
+        partLoad[npart].clear();
+        blamePart[npart].store(0, std::memory_order_relaxed);
+        for (auto& c : culled[npart])
+            c.store(0, std::memory_order_relaxed);
+    }
+    for (auto& b : blameStage)
+        b.store(0, std::memory_order_relaxed);
+    period.clear();
+    periodLoad.clear();
+    overruns.store(0, std::memory_order_relaxed);
+}
+
+
+void DSPProfiler::beginPeriod()
+{
+    startPeriod();
+    hostPeriod = true;
+}
+
+
+void DSPProfiler::endPeriod(uint samplerate)
+{
+    hostPeriod = false;
+    finishPeriod(samplerate);
+}
+
+
+void DSPProfiler::beginCycle(uint numParts)
+{
+    if (!hostPeriod)
+        startPeriod();
+    activeParts = std::max(activeParts, numParts);
+}
+
+
+void DSPProfiler::endCycle(int frames, uint samplerate)
+{
+    periodFrames += frames;
+    if (!hostPeriod)
+        finishPeriod(samplerate);
+}
+
+
+void DSPProfiler::startPeriod()
+{
+    if (resetRequested.load(std::memory_order_acquire))
+    {
+        clearAll();
+        resetRequested.store(false, std::memory_order_release);
+    }
+    activeParts = 0;
+    periodFrames = 0;
+    for (auto& t : inPeriod)
+        t = 0;
+    for (auto& t : stageInPeriod)
+        t = 0;
+    periodStart = now();
+}
+
+
+void DSPProfiler::finishPeriod(uint samplerate)
+{
+    Ticks end = now();
+    Ticks taken = end - periodStart;
+    period.add(taken);
+    for (int s = 0; s < STAGES; ++s)
+        if (stageInPeriod[s] > 0)
+            stages[s].add(stageInPeriod[s]);
+    for (uint npart = 0; npart < activeParts; ++npart)
+        if (inPeriod[npart] > 0)
+            partTicks[npart].add(inPeriod[npart]);
+
+#ifdef HAVE_CYCLE_COUNTER
+    double elapsed = std::chrono::duration<double>(steady_clock::now() - calibTime).count();
+    if (elapsed > CALIBRATION_MIN)
+        ticksPerSec.store((end - calibTicks) / elapsed, std::memory_order_relaxed);
+#endif
+    double rate = ticksPerSec.load(std::memory_order_relaxed);
+    if (rate <= 0 || periodFrames <= 0 || samplerate == 0)
+        return;
+    double available = rate * periodFrames / samplerate;
+    float load = float(taken / available);
+    periodLoad.add(load);
+    for (uint npart = 0; npart < activeParts; ++npart)
+        if (inPeriod[npart] > 0)
+            partLoad[npart].add(float(inPeriod[npart] / available));
+    if (load < 1.0f)
+        return;
+
+    // find the culprit of this overrun
+    overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    Ticks most = 0;
+    int part = -1;
+    int stage = -1;
+    for (uint npart = 0; npart < activeParts; ++npart)
+        if (inPeriod[npart] > most)
+        {
+            most = inPeriod[npart];
+            part = npart;
+        }
+    for (int s = 0; s < STAGES; ++s)
+        if (s != parts && stageInPeriod[s] > most)
+        {
+            most = stageInPeriod[s];
+            stage = s;
+        }
+    if (stage < 0 && part < 0)
+        return; // nothing measured stands out
+    auto& blamed = stage >= 0? blameStage[stage] : blamePart[part];
+    blamed.store(blamed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+double DSPProfiler::toSecs(Ticks t)  const
+{
+    double rate = ticksPerSec.load(std::memory_order_relaxed);
+    return rate > 0? t / rate : 0;
+}
+
+
+void DSPProfiler::report(std::list<string>& msg, uint numParts)  const
+{
+    uint64_t periods = period.calls.load(std::memory_order_relaxed);
+    if (periods == 0 || ticksPerSec.load(std::memory_order_relaxed) <= 0)
+    {
+        msg.push_back("DSP profile: no data yet");
+        return;
+    }
+    auto usecs = [&](Ticks t) { return asCompactString(float(toSecs(t) * 1e6)) + "us"; };
+    double total = period.ticks.load(std::memory_order_relaxed);
+
+    msg.push_back("DSP profile over " + to_string(periods) + " periods");
+    msg.push_back("  period average " + usecs(Ticks(total / periods))
+                 + ", worst " + usecs(period.worst.load(std::memory_order_relaxed))
+                 + ", overruns " + to_string(overruns.load(std::memory_order_relaxed)));
+
+    string hist = "  load  ";
+    for (size_t step = 0; step < LOAD_STEPS; ++step)
+    {
+        hist += (step + 1 < LOAD_STEPS)? " <" + to_string((step + 1) * 10) + "%:" : " over:";
+        hist += to_string(periodLoad.count[step].load(std::memory_order_relaxed));
+    }
+    msg.push_back(hist);
+
+    for (int s = 0; s < STAGES; ++s)
+    {
+        Ticks ticks = stages[s].ticks.load(std::memory_order_relaxed);
+        string line = "  " + string(stageName[s]) + ": " + percent(ticks, total)
+                    + ", worst " + usecs(stages[s].worst.load(std::memory_order_relaxed));
+        uint64_t blamed = blameStage[s].load(std::memory_order_relaxed);
+        if (blamed)
+            line += ", caused " + to_string(blamed) + " overruns";
+        msg.push_back(line);
+    }
+
+    uint64_t culledNotes = 0;
+    for (uint npart = 0; npart < numParts && npart < NUM_MIDI_PARTS; ++npart)
+        for (auto const& c : culled[npart])
+            culledNotes += c.load(std::memory_order_relaxed);
+    if (culledNotes)
+        msg.push_back("  notes stopped early when inaudible: " + to_string(culledNotes));
+
+    for (uint npart = 0; npart < numParts && npart < NUM_MIDI_PARTS; ++npart)
+    {
+        Counter const& pc = partTicks[npart];
+        uint64_t calls = pc.calls.load(std::memory_order_relaxed);
+        if (calls == 0)
+            continue;
+        Ticks ticks = pc.ticks.load(std::memory_order_relaxed);
+        string line = "  part " + to_string(npart + 1) + ": " + percent(ticks, total)
+                    + ", worst " + usecs(pc.worst.load(std::memory_order_relaxed));
+        uint64_t blamed = blamePart[npart].load(std::memory_order_relaxed);
+        if (blamed)
+            line += ", caused " + to_string(blamed) + " overruns";
+        uint64_t heavy = 0;
+        for (size_t step = LOAD_STEPS / 2; step < LOAD_STEPS; ++step)
+            heavy += partLoad[npart].count[step].load(std::memory_order_relaxed);
+        if (heavy)
+            line += ", above 50% in " + to_string(heavy) + " periods";
+        msg.push_back(line);
+
+        string detail;
+        for (int e = 0; e < ENGINES; ++e)
+        {
+            Ticks et = engines[npart][e].ticks.load(std::memory_order_relaxed);
+            if (et)
+                detail += string(detail.empty()? "" : ", ") + engineName[e] + " " + percent(et, ticks);
+            uint64_t cut = culled[npart][e].load(std::memory_order_relaxed);
+            if (cut)
+                detail += " (" + to_string(cut) + " culled)";
+        }
+        string kitDetail;
+        uint kitsPlayed = 0;
+        for (uint item = 0; item < NUM_KIT_ITEMS; ++item)
+        {
+            Ticks kt = kits[npart][item].ticks.load(std::memory_order_relaxed);
+            if (kt == 0)
+                continue;
+            ++kitsPlayed;
+            kitDetail += ", kit " + to_string(item + 1) + " " + percent(kt, ticks);
+        }
+        if (kitsPlayed > 1)
+            detail += kitDetail;
+        if (!detail.empty())
+            msg.push_back("      " + detail);
+    }
+}
@@ -0,0 +1,195 @@
+/*
+    DSPProfiler.h - where the time of each audio period is spent
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef DSPPROFILER_H
+#define DSPPROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER
+#endif
+
+#include "globals.h"
+
+
+/* Always active profiler for the audio thread(s) of one SynthEngine.
+ * Probes read the CPU cycle counter (or the steady clock, where there is
+ * none) around the stages of MasterAudio, the computation of each part and
+ * each note engine; counts are aggregated with relaxed atomics, since each
+ * slot is only written by the thread computing its part within a period.
+ * The counter rate is calibrated against the steady clock while running.
+ *
+ * Times of stages and parts are summed over the period, since a stage may
+ * be passed more than once, and the host may split its period into several
+ * MasterAudio cycles (e.g. JACK, splitting at MIDI events); such a host
+ * brackets its period by beginPeriod() / endPeriod(), otherwise each cycle
+ * counts as a period of its own. At the end of each period, its load
+ * (time taken / time available) goes into a histogram; when a period overran,
+ * the overrun is blamed on the part or stage which took most time in that period.
+ * Counters are only reset by the audio thread, upon request.
+ */
+class DSPProfiler
+{
+    public:
+        using Ticks = uint64_t;
+
+        enum Stage : uchar { mediate, parts, insertEffects, systemEffects, mixing, STAGES };
+        enum Engine : uchar { addSynth, subSynth, padSynth, partEffects, ENGINES };
+
+        static constexpr size_t LOAD_STEPS = 11; // 10% each, the last one is overrun
+
+        static Ticks now()
+        {
+#ifdef HAVE_CYCLE_COUNTER
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        DSPProfiler();
+        // shall not be copied nor moved
+        DSPProfiler(DSPProfiler&&)                 = delete;
+        DSPProfiler(DSPProfiler const&)            = delete;
+        DSPProfiler& operator=(DSPProfiler&&)      = delete;
+        DSPProfiler& operator=(DSPProfiler const&) = delete;
+
+        void addStage(Stage stage, Ticks t)
+        {
+            stageInPeriod[stage] += t;
+        }
+        /* account the time since mark to the stage, returns the new mark */
+        Ticks lap(Stage stage, Ticks mark)
+        {
+            Ticks t = now();
+            addStage(stage, t - mark);
+            return t;
+        }
+        void addEngine(uint npart, uint kitItem, Engine e, Ticks t)
+        {
+            engines[npart][e].add(t);
+            if (kitItem < NUM_KIT_ITEMS)
+                kits[npart][kitItem].add(t);
+        }
+        /* a note retired early, since it had become inaudible */
+        void addCulled(uint npart, Engine e)
+        {
+            auto& c = culled[npart][e];
+            c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        void addPart(uint npart, Ticks t)
+        {
+            inPeriod[npart] += t;
+        }
+
+        /* called by a host splitting its period into several cycles, around them */
+        void beginPeriod();
+        void endPeriod(uint samplerate);
+        /* called by the audio thread around each MasterAudio cycle;
+         * frames and samplerate determine the time available */
+        void beginCycle(uint numParts);
+        void endCycle(int frames, uint samplerate);
+
+        void requestReset() { resetRequested.store(true, std::memory_order_release); }
+        void report(std::list<std::string>& msg, uint numParts)  const;
+
+    private:
+        struct Counter
+        {
+            std::atomic<Ticks>    ticks{0};
+            std::atomic<uint64_t> calls{0};
+            std::atomic<Ticks>    worst{0};
+
+            void add(Ticks t)
+            {   // single writer, thus load+store suffices
+                ticks.store(ticks.load(std::memory_order_relaxed) + t, std::memory_order_relaxed);
+                calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if (t > worst.load(std::memory_order_relaxed))
+                    worst.store(t, std::memory_order_relaxed);
+            }
+            void clear()
+            {
+                ticks.store(0, std::memory_order_relaxed);
+                calls.store(0, std::memory_order_relaxed);
+                worst.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        struct Histogram
+        {
+            std::atomic<uint64_t> count[LOAD_STEPS];
+
+            Histogram() { clear(); }
+            void add(float load)
+            {
+                size_t step = load < 1.0f? size_t(load * (LOAD_STEPS - 1)) : LOAD_STEPS - 1;
+                count[step].store(count[step].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            void clear()
+            {
+                for (auto& c : count)
+                    c.store(0, std::memory_order_relaxed);
+            }
+        };
+
+        Counter stages[STAGES];
+        Counter partTicks[NUM_MIDI_PARTS];
+        Counter engines[NUM_MIDI_PARTS][ENGINES];
+        Counter kits[NUM_MIDI_PARTS][NUM_KIT_ITEMS];
+        Counter period;
+
+        Histogram periodLoad;
+        Histogram partLoad[NUM_MIDI_PARTS];
+
+        std::atomic<uint64_t> culled[NUM_MIDI_PARTS][ENGINES];
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> blamePart[NUM_MIDI_PARTS];
+        std::atomic<uint64_t> blameStage[STAGES];
+
+        // ticks of each part within the current period; written by the
+        // computing thread, read by the audio thread after the parts joined
+        Ticks inPeriod[NUM_MIDI_PARTS];
+        Ticks stageInPeriod[STAGES];
+        Ticks periodStart;
+        uint  activeParts;
+        int   periodFrames;
+        bool  hostPeriod;   // within beginPeriod() / endPeriod()
+
+        // cycle counter calibration
+        Ticks calibTicks;
+        std::chrono::steady_clock::time_point calibTime;
+        std::atomic<double> ticksPerSec;
+
+        std::atomic<bool> resetRequested;
+
+        void clearAll();
+        void startPeriod();
+        void finishPeriod(uint samplerate);
+        double toSecs(Ticks t)  const;
+};
+
+#endif /*DSPPROFILER_H*/
@@ -340,6 +340,16 @@ inline string setExtension(string const& fname, string ext)
 }
 
 
+// the instrument file to load, preferring Yoshimi format where both exist
+inline string findInstrumentFile(string const& fname)
+{
+    string chosen = setExtension(fname, EXTEN::yoshInst);
+    if (!isRegularFile(chosen))
+        chosen = setExtension(fname, EXTEN::zynInst);
+    return chosen;
+}
+
+
 inline bool copyFile(string const& source, string const& destination, char option)
 {
     // options
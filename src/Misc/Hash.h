@@ -23,6 +23,7 @@
 
 
 #include <cstddef>
+#include <cstdint>
 #include <typeinfo>
 
 
@@ -66,6 +67,21 @@ inline void hash_combine(size_t& seed, size_t hash)
 }
 
 
+/**
+ * Hash over the raw bytes of some data (64bit FNV-1a).
+ * Unlike std::hash, the result is stable across program runs and thus can be used
+ * to identify persistent data. Feed the result of a previous invocation as seed
+ * to hash several pieces of data in sequence.
+ */
+inline uint64_t hash_bytes(void const* data, size_t len, uint64_t seed = 0xcbf29ce484222325u)
+{
+    auto bytes = static_cast<unsigned char const*>(data);
+    for (size_t i = 0; i < len; ++i)
+        seed = (seed ^ bytes[i]) * 0x100000001b3u;
+    return seed;
+}
+
+
 /**
 * @return a standard hash value, based on the full (mangled) C++ type name
 */
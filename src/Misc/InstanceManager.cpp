@@ -44,7 +44,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <string>
-#include <array>
+#include <vector>
 #include <map>
 
 using std::string;
@@ -77,7 +77,9 @@ namespace { // implementation details...
     auto drivers_to_probe(Config const& current)
     {
         using Scenario = std::pair<audio_driver,midi_driver>;
-        return std::array{Scenario{current.audioEngine, current.midiEngine}
+        if (current.isOfflineRender())  // never fall back to live audio when rendering
+            return std::vector{Scenario{offline_audio, offline_midi}};
+        return std::vector{Scenario{current.audioEngine, current.midiEngine}
                          ,Scenario{jack_audio, alsa_midi}
                          ,Scenario{jack_audio, jack_midi}
                          ,Scenario{alsa_audio, alsa_midi}
@@ -96,6 +98,7 @@ namespace { // implementation details...
             case   no_audio : return "no_audio";
             case jack_audio : return "jack_audio";
             case alsa_audio : return "alsa_audio";
+            case offline_audio : return "offline_audio";
             default:
                 throw std::logic_error("Unknown audio driver ID");
     }   }
@@ -107,6 +110,7 @@ namespace { // implementation details...
             case   no_midi : return "no_midi";
             case jack_midi : return "jack_midi";
             case alsa_midi : return "alsa_midi";
+            case offline_midi : return "offline_midi";
             default:
                 throw std::logic_error("Unknown MIDI driver ID");
         }
@@ -302,6 +306,8 @@ bool InstanceManager::Instance::startUp(PluginCreator pluginCreator)
     state = BOOTING;
     bool isLV2 = bool(pluginCreator);
     runtime().isLV2 = isLV2;
+    if (not isPrimary() and Config::primary().isOfflineRender())
+        runtime().adoptRenderSetup(Config::primary());
     runtime().loadConfig();
     assert (not runtime().runSynth);
     if (isLV2)
@@ -464,12 +470,22 @@ uint InstanceManager::requestNewInstance(uint desiredID)
 /**
  * Initiate restoring of specific instances, as persisted in the base config.
  * This function must be called after the »primary« SynthEngine was started, but prior
- * to launching any further instances; the new allotted engines will start asynchronously
+ * to launching any further instances; the new allotted engines will start asynchronously.
+ * When rendering offline, helper instances are started instead, to share the work.
  */
 void InstanceManager::triggerRestoreInstances()
 {
     assert (1 == groom->instanceCnt());
     Config& cfg{accessPrimaryConfig()};
+    if (cfg.isOfflineRender())
+    {// spread the files to render over further instances, one per core
+        size_t instanceCnt = std::min<size_t>({Config::renderMidiFiles.size()
+                                          ,std::max(1u, std::thread::hardware_concurrency())
+                                          ,MAX_INSTANCES});
+        for (uint id=1; id < instanceCnt; ++id)
+            groom->createInstance(id);
+    }
+    else
     if (cfg.autoInstance)
         for (uint id=1; id<MAX_INSTANCES; ++id)
             if (cfg.activeInstances.test(id))
@@ -662,7 +678,12 @@ void InstanceManager::launchSoundTest()
     auto& soundTest{test::TestInvoker::access()};
     auto& primarySynth{groom->getPrimary().getSynth()};
     assert(soundTest.activated);
-    soundTest.performSoundCalculation(primarySynth);
+    if (soundTest.kernelCheckRequested())
+        soundTest.performKernelCheck(primarySynth);
+    else if (soundTest.benchmarkRequested())
+        soundTest.performBenchmark(primarySynth);
+    else
+        soundTest.performSoundCalculation(primarySynth);
 }
 #endif
 
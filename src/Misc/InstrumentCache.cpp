@@ -0,0 +1,242 @@
+/*
+    InstrumentCache.cpp - parsed bank instruments held in memory
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/InstrumentCache.h"
+#include "Misc/FileMgrFuncs.h"
+#include "Misc/BuildScheduler.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+using std::string;
+using std::vector;
+using std::optional;
+
+
+namespace { // implementation details
+
+    using Snapshot = std::shared_ptr<const string>;
+
+    struct Entry
+    {
+        Snapshot snapshot;
+        size_t modified;
+        std::list<string>::iterator recent;
+    };
+
+    /* read, unpack and parse; failures are left to the ordinary load to report */
+    optional<XMLStore> parse(string const& filename)
+    {
+        string report;
+        string xml = file::loadGzipped(filename, report);
+        if (xml.empty())
+            return std::nullopt;
+        optional<XMLStore> instrument{std::in_place, xml.c_str()};
+        if (not *instrument)
+            return std::nullopt;
+        return instrument;
+    }
+}//(End)implementation details
+
+
+struct InstrumentCache::Store
+{
+    mutable std::mutex lock;
+    std::unordered_map<string, Entry> entries;
+    std::list<string> recent;  // most recently used first
+    size_t bytes{0};
+    size_t limit{0};
+    size_t hits{0};
+    size_t misses{0};
+    size_t preloaded{0};
+    bool closed{false};
+
+    // note: lock held by caller
+    void drop(std::unordered_map<string, Entry>::iterator pos)
+    {
+        bytes -= pos->second.snapshot->size();
+        recent.erase(pos->second.recent);
+        entries.erase(pos);
+    }
+
+    // note: lock held by caller
+    void trim(size_t target)
+    {
+        while (bytes > target and not recent.empty())
+            drop(entries.find(recent.back()));
+    }
+
+    /* a preloaded instrument is only added when there is room for it,
+     * while an instrument actually in use pushes out the oldest entries */
+    bool insert(string const& filename, Snapshot snapshot, size_t modified, bool isPreload)
+    {
+        size_t size = snapshot->size();
+        std::lock_guard<std::mutex> guard(lock);
+        if (closed or size == 0 or size > limit)
+            return false;
+        auto pos = entries.find(filename);
+        if (pos != entries.end())
+        {
+            if (isPreload)
+                return false;
+            drop(pos);
+        }
+        if (isPreload)
+        {
+            if (bytes + size > limit)
+                return false;
+            ++preloaded;
+        }
+        else
+            trim(limit - size);
+        recent.push_front(filename);
+        entries.emplace(filename, Entry{std::move(snapshot), modified, recent.begin()});
+        bytes += size;
+        return true;
+    }
+
+    void preload(string const& bankEntry)
+    {
+        string filename = file::findInstrumentFile(bankEntry);  // same key as used by setProgram
+        size_t modified = file::isRegularFile(filename);
+        if (not modified)
+            return;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (closed or bytes >= limit or entries.count(filename))
+                return;
+        }
+        if (optional<XMLStore> instrument = parse(filename))
+            insert(filename, std::make_shared<const string>(instrument->renderBinary()), modified, true);
+    }
+};
+
+
+
+InstrumentCache::InstrumentCache()
+    : store{std::make_shared<Store>()}
+    { }
+
+
+InstrumentCache::~InstrumentCache()
+{
+    std::lock_guard<std::mutex> guard(store->lock);
+    store->closed = true;  // preload tasks still queued will find nothing to do
+    store->entries.clear();
+    store->recent.clear();
+    store->bytes = 0;
+}
+
+
+void InstrumentCache::setLimit(size_t megabytes)
+{
+    std::lock_guard<std::mutex> guard(store->lock);
+    store->limit = megabytes << 20;
+    store->trim(store->limit);
+}
+
+
+/* Get the parsed instrument file, from memory if possible; an instrument read
+ * from disk is added to the cache. Returns nothing when the cache is disabled
+ * or the file can not be loaded, so the caller should then load it as usual. */
+optional<XMLStore> InstrumentCache::fetch(string const& filename)
+{
+    size_t modified = file::isRegularFile(filename);
+    if (not modified)
+        return std::nullopt;
+    Snapshot snapshot;
+    {
+        std::lock_guard<std::mutex> guard(store->lock);
+        if (store->limit == 0)
+            return std::nullopt;
+        auto pos = store->entries.find(filename);
+        if (pos != store->entries.end())
+        {
+            if (pos->second.modified == modified)
+            {
+                ++store->hits;
+                store->recent.splice(store->recent.begin(), store->recent, pos->second.recent);
+                snapshot = pos->second.snapshot;
+            }
+            else
+                store->drop(pos);  // changed on disk
+        }
+        if (not snapshot)
+            ++store->misses;
+    }
+    if (snapshot)
+    {
+        optional<XMLStore> instrument{std::in_place, snapshot->data(), snapshot->size()};
+        if (*instrument)
+            return instrument;
+        return std::nullopt;
+    }
+    optional<XMLStore> instrument = parse(filename);
+    if (instrument)
+        store->insert(filename, std::make_shared<const string>(instrument->renderBinary()), modified, false);
+    return instrument;
+}
+
+
+/* Parse the given instrument files in the background, in addition to what
+ * is already held, but never pushing out any other entries. */
+void InstrumentCache::preload(vector<string> filenames)
+{
+    {
+        std::lock_guard<std::mutex> guard(store->lock);
+        if (store->limit == 0)
+            return;
+    }
+    for (string& filename : filenames)
+        task::RunnerBackend::schedule([store = this->store, filename = std::move(filename)]
+                                      {
+                                          store->preload(filename);
+                                      }
+                                     , task::BULK);
+}
+
+
+void InstrumentCache::forget(string const& filename)
+{
+    std::lock_guard<std::mutex> guard(store->lock);
+    auto pos = store->entries.find(filename);
+    if (pos != store->entries.end())
+        store->drop(pos);
+}
+
+
+size_t InstrumentCache::clear()
+{
+    std::lock_guard<std::mutex> guard(store->lock);
+    size_t removed = store->entries.size();
+    store->entries.clear();
+    store->recent.clear();
+    store->bytes = 0;
+    return removed;
+}
+
+
+InstrumentCache::Usage InstrumentCache::usage() const
+{
+    std::lock_guard<std::mutex> guard(store->lock);
+    return Usage{store->entries.size(), store->bytes, store->limit
+                ,store->hits, store->misses, store->preloaded};
+}
@@ -0,0 +1,77 @@
+/*
+    InstrumentCache.h - parsed bank instruments held in memory
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef INSTRUMENT_CACHE_H
+#define INSTRUMENT_CACHE_H
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Misc/XMLStore.h"
+
+
+/* Instruments loaded from the banks, kept in memory in the compact binary form
+ * (see XMLtree::encode) and filed under their full path. A program change served
+ * from here neither reads nor unpacks nor parses the file, but just rebuilds the
+ * tree from the snapshot. Instruments are added when first loaded, and (when
+ * enabled) all instruments of the current bank are preloaded in the background,
+ * as long as there is room left.
+ *
+ * - all functions are thread-safe; each fetch() yields a tree of its own
+ * - an entry is dropped when the file's modification time has changed
+ * - the total size is bounded; least recently used entries are discarded first
+ */
+class InstrumentCache
+{
+    public:
+        InstrumentCache();
+       ~InstrumentCache();
+        // shall not be copied nor moved
+        InstrumentCache(InstrumentCache&&)                 = delete;
+        InstrumentCache(InstrumentCache const&)            = delete;
+        InstrumentCache& operator=(InstrumentCache&&)      = delete;
+        InstrumentCache& operator=(InstrumentCache const&) = delete;
+
+        void setLimit(size_t megabytes);   // 0 disables the cache
+        std::optional<XMLStore> fetch(std::string const& filename);
+        void preload(std::vector<std::string> filenames);
+        void forget(std::string const& filename);
+        size_t clear();                    // returns the number of entries removed
+
+        struct Usage
+        {
+            size_t entries;
+            size_t bytes;
+            size_t limit;
+            size_t hits;
+            size_t misses;
+            size_t preloaded;
+        };
+        Usage usage() const;
+
+    private:
+        struct Store;
+        std::shared_ptr<Store> store;  // shared with running preload tasks
+};
+
+#endif /*INSTRUMENT_CACHE_H*/
@@ -0,0 +1,189 @@
+/*
+    NotePool.cpp - preallocated memory for objects built while playing notes
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/NotePool.h"
+#include "globals.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+using std::atomic;
+
+
+namespace { // implementation details
+
+    const uint     MAX_CHUNKS = 32;         // one per engine instance (see InstanceManager)
+    const size_t   HEADER     = 16;         // keeps the payload aligned for any scalar type
+    const uint32_t ON_HEAP    = 0xffffffff;
+
+    struct SizeClass
+    {
+        size_t   blockSize;                 // including the header
+        uint32_t blocksPerChunk;            // reserved for each engine instance
+    };
+
+    // unison state with all voices at maximum unison, aligned to cache lines by PooledBlock
+    constexpr size_t FULL_UNISON_STATE = (NotePool::UNISON_ARRAYS * NUM_VOICES * MAX_UNISON * sizeof(float)
+                                          + PooledBlock::CACHE_LINE + HEADER + 1023) / 1024 * 1024;
+    static_assert(FULL_UNISON_STATE > 32768, "size classes must be ascending");
+
+    const SizeClass SIZES[] = {
+        {   64, 2048 },   // Filter
+        {  128, 1024 },   // LFO
+        {  256, 1024 },   // PADnote, SVFilter
+        {  384, 2048 },   // Envelope, AnalogFilter
+        {  512,  256 },
+        { 1024,  256 },   // SUBnote
+        { 1536,  256 },   // FormantFilter
+        { 2048, 1024 },   // sample buffers for unison and voice output (256 frames)
+        { 4096,  512 },   // ...same with 512 frames; SUBnote filter parameters
+        { 6144,  384 },   // ADnote, including sub-voices
+        { 8192,   64 },
+        {16384,  128 },   // unison state of ADnote, SUBnote filter bank
+        {32768,   32 },
+        {FULL_UNISON_STATE, 32 }, // unison state of ADnote, large unison on several voices
+    };
+    const uint NUM_CLASSES = sizeof(SIZES) / sizeof(SIZES[0]);
+
+    struct Header
+    {
+        uint32_t sizeClass;
+        uint32_t index;
+    };
+
+    /* Treiber stack of free blocks. The head holds (tag << 32) | (index + 1),
+     * zero when empty; the tag is incremented on each pop to defeat ABA.
+     * The link to the next free block is kept in the unused payload. */
+    struct FreeList
+    {
+        atomic<uint64_t> head{0};
+        char* chunk[MAX_CHUNKS]{};
+        uint chunkCnt{0};
+    };
+
+    FreeList freeList[NUM_CLASSES];
+    atomic<size_t> fallbacks{0};
+    std::mutex reserveLock;
+
+
+    inline char* blockAt(uint cls, uint32_t index)
+    {
+        uint32_t perChunk = SIZES[cls].blocksPerChunk;
+        return freeList[cls].chunk[index / perChunk] + size_t(index % perChunk) * SIZES[cls].blockSize;
+    }
+
+    inline atomic<uint32_t>& linkOf(char* block)
+    {
+        return *std::launder(reinterpret_cast<atomic<uint32_t>*>(block + HEADER));
+    }
+
+    void push(uint cls, uint32_t index)
+    {
+        atomic<uint32_t>& link = linkOf(blockAt(cls, index));
+        FreeList& list = freeList[cls];
+        uint64_t head = list.head.load(std::memory_order_relaxed);
+        uint64_t top;
+        do {
+            link.store(uint32_t(head), std::memory_order_relaxed);
+            top = (head & 0xffffffff00000000u) | (index + 1);
+        }
+        while (!list.head.compare_exchange_weak(head, top, std::memory_order_release,
+                                                          std::memory_order_relaxed));
+    }
+
+    char* pop(uint cls)
+    {
+        FreeList& list = freeList[cls];
+        uint64_t head = list.head.load(std::memory_order_acquire);
+        while (uint32_t(head) != 0)
+        {
+            char* block = blockAt(cls, uint32_t(head) - 1);
+            uint32_t next = linkOf(block).load(std::memory_order_relaxed);
+            uint64_t top = (((head >> 32) + 1) << 32) | next;
+            if (list.head.compare_exchange_weak(head, top, std::memory_order_acquire,
+                                                           std::memory_order_acquire))
+                return block;
+        }
+        return nullptr;
+    }
+}
+
+
+void NotePool::reserve()
+{
+    std::lock_guard<std::mutex> guard(reserveLock);
+    for (uint cls = 0; cls < NUM_CLASSES; ++cls)
+    {
+        FreeList& list = freeList[cls];
+        if (list.chunkCnt == MAX_CHUNKS)
+            continue; // further demand served by the heap
+        uint32_t perChunk = SIZES[cls].blocksPerChunk;
+        uint32_t base = list.chunkCnt * perChunk;
+        // Note: never discarded, since blocks float freely between instances
+        list.chunk[list.chunkCnt++] = new char[SIZES[cls].blockSize * perChunk];
+        for (uint32_t i = 0; i < perChunk; ++i)
+        {
+            char* block = blockAt(cls, base + i);
+            new(block) Header{cls, base + i};
+            new(block + HEADER) atomic<uint32_t>{0};
+            push(cls, base + i);
+        }
+    }
+}
+
+
+void* NotePool::allocate(size_t size)
+{
+    size_t needed = size + HEADER;
+    for (uint cls = 0; cls < NUM_CLASSES; ++cls)
+        if (SIZES[cls].blockSize >= needed)
+            if (char* block = pop(cls))
+                return block + HEADER;
+            // else spill over into the next larger class
+
+    fallbacks.fetch_add(1, std::memory_order_relaxed);
+    char* block = static_cast<char*>(::operator new(needed));
+    new(block) Header{ON_HEAP, 0};
+    return block + HEADER;
+}
+
+
+void NotePool::release(void* payload) noexcept
+{
+    if (!payload)
+        return;
+    char* block = static_cast<char*>(payload) - HEADER;
+    Header const& header = *std::launder(reinterpret_cast<Header*>(block));
+    if (header.sizeClass == ON_HEAP)
+        ::operator delete(block);
+    else
+    {
+        new(block + HEADER) atomic<uint32_t>{0};
+        push(header.sizeClass, header.index);
+    }
+}
+
+
+size_t NotePool::fallbackCount()
+{
+    return fallbacks.load(std::memory_order_relaxed);
+}
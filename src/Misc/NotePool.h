@@ -0,0 +1,177 @@
+/*
+    NotePool.h - preallocated memory for objects built while playing notes
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef NOTEPOOL_H
+#define NOTEPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+
+/* Memory blocks for notes, envelopes, LFOs and filters, and the arrays and
+ * sample buffers these allocate while playing (see PooledArray, PooledSamples).
+ * Notes are created on note-on and discarded when finished, which happens within
+ * the audio thread (or a render thread), where calling the system allocator can
+ * block for an unpredictable time. Instead, these objects are placed into blocks
+ * drawn from fixed size classes; the memory for these blocks is reserved up-front
+ * by each SynthEngine while booting.
+ *
+ * - allocate() and release() are lock-free and can be called from any thread,
+ *   thus a note can be started by the audio thread and finished by a render thread.
+ * - Should a size class be exhausted (or the object too large), the allocation
+ *   falls back to the heap; this is counted and reported by fallbackCount().
+ * - Reserved memory is kept for the lifetime of the application.
+ */
+class NotePool
+{
+    public:
+        /* add blocks for one further engine instance; not real-time safe */
+        static void reserve();
+
+        static void* allocate(size_t size);
+        static void  release(void* block) noexcept;
+
+        /* allocations which could not be served by the pool */
+        static size_t fallbackCount();
+
+        /* arrays in the unison state block of an ADnote (see ADnote::allocateUnisonState);
+         * the largest size class is dimensioned to hold them for all voices at full unison */
+        static constexpr size_t UNISON_ARRAYS = 22;
+};
+
+
+/* Mixin to place instances of the derived class into the NotePool */
+class NotePooled
+{
+    public:
+        static void* operator new(size_t size)          { return NotePool::allocate(size); }
+        static void  operator delete(void* block)       { NotePool::release(block); }
+        // placement into storage managed elsewhere
+        static void* operator new(size_t, void* place)  { return place; }
+        static void  operator delete(void*, void*)      { }
+};
+
+
+/* Zero-initialised raw storage from the NotePool, aligned to cache lines;
+ * e.g. to hold several arrays in structure-of-arrays layout */
+class PooledBlock
+{
+        void*  raw{nullptr};
+        char*  base{nullptr};
+        size_t siz{0};
+
+    public:
+        static constexpr size_t CACHE_LINE = 64;
+
+        PooledBlock() = default;
+       ~PooledBlock() { NotePool::release(raw); }
+        // shall not be copied nor moved
+        PooledBlock(PooledBlock&&)                 = delete;
+        PooledBlock(PooledBlock const&)            = delete;
+        PooledBlock& operator=(PooledBlock&&)      = delete;
+        PooledBlock& operator=(PooledBlock const&) = delete;
+
+        /** discard existing storage and possibly allocate new storage */
+        void reset(size_t newSize =0)
+        {
+            NotePool::release(raw);
+            raw = nullptr;
+            base = nullptr;
+            siz = newSize;
+            if (siz == 0)
+                return;
+            raw = NotePool::allocate(siz + CACHE_LINE);
+            uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + CACHE_LINE - 1) & ~uintptr_t(CACHE_LINE - 1);
+            base = reinterpret_cast<char*>(aligned);
+            memset(base, 0, siz);
+        }
+
+        char*  get()  const { return base; }
+        size_t size() const { return siz; }
+};
+
+
+/* Array of value-initialised elements in NotePool storage;
+ * used like unique_ptr<T[]>, but the size is given to reset() */
+template<typename T>
+class PooledArray
+{
+        T*     elm{nullptr};
+        size_t cnt{0};
+
+    public:
+        PooledArray() = default;
+        explicit PooledArray(size_t newCnt) { reset(newCnt); }
+       ~PooledArray() { reset(); }
+
+        PooledArray(PooledArray&& other) noexcept
+            : elm{std::exchange(other.elm, nullptr)}
+            , cnt{std::exchange(other.cnt, 0)}
+        { }
+        PooledArray& operator=(PooledArray&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                elm = std::exchange(other.elm, nullptr);
+                cnt = std::exchange(other.cnt, 0);
+            }
+            return *this;
+        }
+        PooledArray(PooledArray const&)            = delete;
+        PooledArray& operator=(PooledArray const&) = delete;
+
+        /** discard existing elements and possibly create new ones */
+        void reset(size_t newCnt =0)
+        {
+            for (size_t i = cnt; i > 0; --i)
+                elm[i-1].~T();
+            NotePool::release(elm);
+            elm = nullptr;
+            cnt = newCnt;
+            if (cnt == 0)
+                return;
+            elm = static_cast<T*>(NotePool::allocate(cnt * sizeof(T)));
+            for (size_t i = 0; i < cnt; ++i)
+                new(elm + i) T{};
+        }
+
+        explicit operator bool() const { return elm != nullptr; }
+        T& operator[](size_t i)  const { return elm[i]; }
+        T*     get()             const { return elm; }
+        size_t size()            const { return cnt; }
+};
+
+
+/* Sample buffer in NotePool storage, zero initialised;
+ * can stand in for Samples (see Misc/Alloc.h) within a note */
+class PooledSamples
+    : public PooledArray<float>
+{
+    public:
+        PooledSamples(size_t buffSize =0)
+            : PooledArray<float>{buffSize}
+        { }
+};
+
+#endif /*NOTEPOOL_H*/
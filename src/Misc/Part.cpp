@@ -47,31 +47,47 @@
 #include "Synth/Resonance.h"
 #include "Misc/Part.h"
 
+#include <algorithm>
 #include <cassert>
 
 using synth::velF;
 using file::isRegularFile;
 using file::setExtension;
 using file::findLeafName;
+using file::findExtension;
+using file::findInstrumentFile;
 using func::findSplitPoint;
 using func::setAllPan;
 using func::decibel;
 using std::string;
 
+namespace { // implementation details
+
+    // spare note positions, where stolen voices fade out
+    const uint STEAL_RESERVE = 8;
+}
+
+
 Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _synth)
     : ctl{new Controller(&_synth)}
     , partID{id}
     , partoutl(_synth.buffersize)
     , partoutr(_synth.buffersize)
-    , tmpoutl(_synth.getRuntime().genMixl) // Note: alias to a global shared buffer
-    , tmpoutr(_synth.getRuntime().genMixr)
+    , silent{false}
     , microtonal{microtonal_}
     , fft{fft_}
+    , partnote{}
+    , activeVoice{}
+    , freeVoice{}
+    , activeVoices{0}
+    , freeVoices{0}
+    , stolenVoices{0}
     , prevNote{-1}
     , prevPos{0}
     , prevFreq{-1.0f}
     , prevLegatoMode{false}
     , killallnotes(false)
+    , previous{nullptr}
     , oldFilterState{-1}
     , oldFilterQstate{-1}
     , oldBendState{-1}
@@ -105,20 +121,9 @@ Part::Part(uchar id, Microtonal* microtonal_, fft::Calc& fft_, SynthEngine& _syn
         Pefxbypass[n] = false;
     }
 
-    int i, j;
-    for (i = 0; i < POLYPHONY; ++i)
-    {
-        partnote[i].status = KEY_OFF;
-        partnote[i].note = -1;
-        partnote[i].itemsplaying = 0;
-        for (j = 0; j < NUM_KIT_ITEMS; ++j)
-        {
-            partnote[i].kitItem[j].adnote = NULL;
-            partnote[i].kitItem[j].subnote = NULL;
-            partnote[i].kitItem[j].padnote = NULL;
-        }
-        partnote[i].time = 0;
-    }
+    Pvoices = 0;
+    setVoiceCapacity(POLYPHONY);
+    prng.init(synth.randomINT());
     cleanup();
     /*
      * Do we actually need the following two?
@@ -160,6 +165,8 @@ void Part::defaults(int npart)
     Pvelsns = 64;
     Pveloffs = 64;
     Pkeylimit = PART_DEFAULT_LIMIT;
+    setVoiceCapacity(POLYPHONY);
+    Psteal = PART::stealType::released;
     Pfrand = 0;
     Pvelrand = 0;
     PbreathControl = MIDI::CC::breath;
@@ -236,8 +243,8 @@ void Part::cleanup()
 {
     int enablepart = Penabled;
     Penabled = 0;
-    for (int k = 0; k < POLYPHONY; ++k)
-        KillNotePos(k);
+    while (activeVoices > 0)
+        KillNotePos(activeVoice[activeVoices - 1]);
     memset(partoutl.get(), 0, synth.bufferbytes);
     memset(partoutr.get(), 0, synth.bufferbytes);
 
@@ -373,8 +380,9 @@ void Part::setKeyAT(int note, int type, int value)
 {
     if (note < Pminkey || note > Pmaxkey)
         return;
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (uint v = 0; v < activeVoices; ++v)
     {
+        int i = activeVoice[v];
         if (partnote[i].status != KEY_OFF && partnote[i].note == note)
         {
             partnote[i].keyATtype = type;
@@ -440,6 +448,7 @@ void Part::startNewNotes(int pos, size_t item, size_t currItem, Note note, bool
     partnote[pos].kitItem[currItem].sendtoparteffect =
         (kit[item].Psendtoparteffect < NUM_PART_EFX)? kit[item].Psendtoparteffect
                                                     : NUM_PART_EFX; // direct to Part-output
+    partnote[pos].kitItem[currItem].kitIndex = item;
 
     incrementItemsPlaying(pos,currItem);
 }
@@ -465,6 +474,7 @@ void Part::startLegato(int pos, size_t item, size_t currItem, Note note)
     partnote[pos].kitItem[currItem].sendtoparteffect =
         (kit[item].Psendtoparteffect < NUM_PART_EFX)? kit[item].Psendtoparteffect
                                                     : NUM_PART_EFX; // direct to Part-output
+    partnote[pos].kitItem[currItem].kitIndex = item;
 
     partnote[prevPos].status = KEY_RELEASED; // treat legato crossfade similar to envelope-release
     incrementItemsPlaying(pos,currItem);
@@ -549,7 +559,7 @@ void Part::NoteOn(int note, int velocity, bool renote)
 
     if (Pkeymode == PART_NORMAL)
     {// Polyphony is on
-        enforcekeylimit();
+        enforcekeylimit(note);
         monoNoteHistory.clear();
     }
     else
@@ -564,15 +574,7 @@ void Part::NoteOn(int note, int velocity, bool renote)
         }
     }
     //--Find-new-free-Note-position------
-    int pos = -1;
-    for (int i = 0; i < POLYPHONY; ++i)
-    {
-        if (partnote[i].status == KEY_OFF)
-        {
-            pos = i;
-            break;
-        }
-    }
+    int pos = claimVoice(note);
     if (pos == -1)
     {
         synth.getRuntime().Log("Too many notes - notes > polyphony");
@@ -590,10 +592,10 @@ void Part::NoteOn(int note, int velocity, bool renote)
     }
     else if ((Pkeymode & MIDI_NOT_LEGATO) == PART_MONO)
     {// if the mode is 'mono' turn off all other notes
-        for (int i = 0; i < POLYPHONY; ++i)
+        for (uint v = 0; v < activeVoices; ++v)
         {
-            if (partnote[i].status == KEY_PLAYING)
-                ReleaseNotePos(i);
+            if (partnote[activeVoice[v]].status == KEY_PLAYING)
+                ReleaseNotePos(activeVoice[v]);
         }
         ReleaseSustainedKeys();
     }
@@ -751,8 +753,9 @@ void Part::NoteOff(int note) //release the key
     monoNoteHistory.remove(note);
     reactivate = reactivate && !monoNoteHistory.empty();
 
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (uint v = 0; v < activeVoices; ++v)
     {   //first note in, is first out if there are same note multiple times
+        int i = activeVoice[v];
         if (partnote[i].status == KEY_PLAYING && partnote[i].note == note)
         {
             if (ctl->sustain.sustain)
@@ -901,17 +904,18 @@ void Part::ReleaseSustainedKeys()
             // Sustain controller manipulation would respawn same note repeatedly without this check.
             monoNoteHistoryRecall(); // To play most recent still held note.
 
-    for (int i = 0; i < POLYPHONY; ++i)
-        if (partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
-            ReleaseNotePos(i);
+    for (uint v = 0; v < activeVoices; ++v)
+        if (partnote[activeVoice[v]].status == KEY_RELEASED_AND_SUSTAINED)
+            ReleaseNotePos(activeVoice[v]);
 }
 
 
 // Release all keys
 void Part::ReleaseAllKeys()
 {
-    for (int i = 0; i < POLYPHONY; ++i)
+    for (uint v = 0; v < activeVoices; ++v)
     {
+        int i = activeVoice[v];
         if (partnote[i].status != KEY_RELEASED
             && partnote[i].status != KEY_OFF) //thanks to Frank Neumann
             ReleaseNotePos(i);
@@ -956,6 +960,12 @@ void Part::KillNotePos(int pos)
     partnote[pos].note = -1;
     partnote[pos].time = 0;
     partnote[pos].itemsplaying = 0;
+    if (partnote[pos].stolen)
+    {
+        partnote[pos].stolen = false;
+        --stolenVoices;
+    }
+    partnote[pos].retired = false;
 
     for (int j = 0; j < NUM_KIT_ITEMS; ++j)
     {
@@ -980,59 +990,219 @@ void Part::KillNotePos(int pos)
         ctl->portamento.noteusing = -1;
         ctl->portamento.used = 0;
     }
+    for (uint v = 0; v < activeVoices; ++v)
+        if (activeVoice[v] == uint(pos))
+        {   // the others stay in order of age
+            memmove(&activeVoice[v], &activeVoice[v + 1], (activeVoices - v - 1) * sizeof(uint));
+            --activeVoices;
+            freeVoice[freeVoices++] = pos;
+            break;
+        }
 }
 
 
-void Part::enforcekeylimit()
+// Take a free note position into use, stealing a voice when all are in use.
+// Returns -1 if there is none.
+int Part::claimVoice(int note)
 {
-    // release old keys if the number of notes>keylimit
-    int notecount = 0;
-    for (int i = 0; i < POLYPHONY; ++i)
+    if (activeVoices - stolenVoices >= Pvoices)
     {
-        if (partnote[i].status == KEY_PLAYING
-            || partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
-            notecount++;
+        int victim = chooseVictim(note, false);
+        if (victim >= 0)
+        {   // quickly fade out, as done for legato
+            for (size_t item = 0; item < partnote[victim].itemsplaying; ++item)
+            {
+                if (partnote[victim].kitItem[item].adnote)
+                    partnote[victim].kitItem[item].adnote->legatoFadeOut();
+                if (partnote[victim].kitItem[item].subnote)
+                    partnote[victim].kitItem[item].subnote->legatoFadeOut();
+                if (partnote[victim].kitItem[item].padnote)
+                    partnote[victim].kitItem[item].padnote->legatoFadeOut();
+            }
+            partnote[victim].status = KEY_RELEASED;
+            partnote[victim].note = -1;  // no longer reacts to its key
+            partnote[victim].stolen = true;
+            ++stolenVoices;
+        }
     }
-    while (notecount > Pkeylimit)
-    {   // find out the oldest note
-        int oldestnotepos = 0;
-        int maxtime = 0;
+    if (freeVoices == 0)
+    {   // spare positions all still fading, cut the oldest short
+        for (uint v = 0; v < activeVoices; ++v)
+            if (partnote[activeVoice[v]].stolen)
+            {
+                KillNotePos(activeVoice[v]);
+                break;
+            }
+        if (freeVoices == 0)
+            return -1;
+    }
+    uint pos = freeVoice[--freeVoices];
+    activeVoice[activeVoices++] = pos;
+    return pos;
+}
 
-        for (int i = 0; i < POLYPHONY; ++i)
+
+// Pick the voice to make way for the given note, according to Psteal;
+// heldOnly considers just keys still held (or sustained)
+int Part::chooseVictim(int note, bool heldOnly)
+{
+    int oldest = -1;
+    int oldestReleased = -1;
+    int sameKey = -1;
+    int quietest = -1;
+    float lowest = 0;
+    for (uint v = 0; v < activeVoices; ++v)
+    {
+        int pos = activeVoice[v];
+        PartNotes const& voice = partnote[pos];
+        if (voice.stolen || voice.status == KEY_OFF)
+            continue;
+        if (Pkeymode != PART_NORMAL && pos == prevPos)
+            continue; // needed to connect mono and legato notes
+        bool held = (voice.status == KEY_PLAYING || voice.status == KEY_RELEASED_AND_SUSTAINED);
+        if (heldOnly && !held)
+            continue;
+        if (oldest < 0)
+            oldest = pos;
+        if (!held && oldestReleased < 0)
+            oldestReleased = pos;
+        if (voice.note == note && sameKey < 0)
+            sameKey = pos;
+        if (voice.time > 0) // otherwise its level is not yet known
         {
-            if ((partnote[i].status == KEY_PLAYING
-                || partnote[i].status == KEY_RELEASED_AND_SUSTAINED)
-                && partnote[i].time > maxtime)
+            float level = voiceLevel(pos);
+            if (quietest < 0 || level < lowest)
             {
-                maxtime = partnote[i].time;
-                oldestnotepos = i;
+                quietest = pos;
+                lowest = level;
             }
         }
-        ReleaseNotePos(oldestnotepos);
+    }
+    if (Psteal == PART::stealType::quietest && quietest >= 0)
+        return quietest;
+    if (Psteal == PART::stealType::sameKey && sameKey >= 0)
+        return sameKey;
+    return (oldestReleased >= 0)? oldestReleased : oldest;
+}
+
+
+float Part::voiceLevel(int pos)  const
+{
+    float level = 0;
+    for (size_t item = 0; item < partnote[pos].itemsplaying; ++item)
+    {
+        PartNotes::KitItemNotes const& notes = partnote[pos].kitItem[item];
+        if (notes.adnote)
+            level = std::max(level, notes.adnote->getLevel());
+        if (notes.subnote)
+            level = std::max(level, notes.subnote->getLevel());
+        if (notes.padnote)
+            level = std::max(level, notes.padnote->getLevel());
+    }
+    return level;
+}
+
+
+void Part::enforcekeylimit(int note)
+{
+    // release keys if the number of notes>keylimit
+    int notecount = 0;
+    for (uint v = 0; v < activeVoices; ++v)
+    {
+        PartNotes const& voice = partnote[activeVoice[v]];
+        if (!voice.stolen && (voice.status == KEY_PLAYING
+                              || voice.status == KEY_RELEASED_AND_SUSTAINED))
+            notecount++;
+    }
+    while (notecount > Pkeylimit)
+    {   // oldest, or as chosen by the stealing policy
+        int victim = chooseVictim(note, true);
+        if (victim < 0)
+            break;
+        ReleaseNotePos(victim);
         --notecount;
     }
 }
 
 
+// Change the number of voices; kills all notes playing, thus
+// only to be called while the part is not computed
+void Part::setVoiceCapacity(uint voices)
+{
+    voices = std::clamp(voices, uint(MIN_POLYPHONY), uint(MAX_POLYPHONY));
+    if (partnote && voices == Pvoices)
+        return;
+    if (partnote)
+        while (activeVoices > 0)
+            KillNotePos(activeVoice[activeVoices - 1]);
+
+    uint slots = voices + STEAL_RESERVE;
+    partnote.reset(new PartNotes[slots]);
+    activeVoice.reset(new uint[slots]);
+    freeVoice.reset(new uint[slots]);
+    for (uint pos = 0; pos < slots; ++pos)
+    {
+        partnote[pos].status = KEY_OFF;
+        partnote[pos].note = -1;
+        partnote[pos].time = 0;
+        partnote[pos].itemsplaying = 0;
+        partnote[pos].stolen = false;
+        partnote[pos].retired = false;
+        for (int j = 0; j < NUM_KIT_ITEMS; ++j)
+        {
+            partnote[pos].kitItem[j].adnote = NULL;
+            partnote[pos].kitItem[j].subnote = NULL;
+            partnote[pos].kitItem[j].padnote = NULL;
+        }
+        freeVoice[pos] = slots - 1 - pos; // lowest position is used first
+    }
+    Pvoices = voices;
+    activeVoices = 0;
+    freeVoices = slots;
+    stolenVoices = 0;
+    prevPos = 0;
+    ctl->portamento.noteusing = -1;
+}
+
+
 // Compute Part samples and store them in the partoutl[] and partoutr[]
 void Part::ComputePartSmps()
 {
-    assert(tmpoutl.get() == synth.getRuntime().genMixl.get());
-    assert(tmpoutr.get() == synth.getRuntime().genMixr.get());
-
-    for (int nefx = 0; nefx < NUM_PART_EFX + 1; ++nefx)
-    {
-        memset(partfxinputl[nefx].get(), 0, synth.sent_bufferbytes);
-        memset(partfxinputr[nefx].get(), 0, synth.sent_bufferbytes);
+    // Note: alias to shared buffers of the computing thread
+    ScratchBuffers& scratch = synth.scratch();
+    Samples& tmpoutl = scratch.genMixl;
+    Samples& tmpoutr = scratch.genMixr;
+    DSPProfiler& profiler = synth.profiler;
+    DSPProfiler::Ticks partStart = DSPProfiler::now();
+
+    if (activeVoices == 0 && !killallnotes && partEffectsIdle() && !previous)
+    {   // nothing playing and all effect tails have died away
+        memset(partoutl.get(), 0, synth.sent_bufferbytes);
+        memset(partoutr.get(), 0, synth.sent_bufferbytes);
+        silent = true;
+        ctl->updateportamento();
+        profiler.addPart(partID, DSPProfiler::now() - partStart);
+        return;
     }
 
-    for (int k = 0; k < POLYPHONY; ++k)
+    // which of the effect inputs received any sound
+    bool fxSilent[NUM_PART_EFX + 1];
+    bool previousSilent[NUM_PART_EFX + 1];
+    clearEffectInputs(fxSilent);
+    if (previous)
+        previous->clearEffectInputs(previousSilent);
+
+    for (uint v = 0; v < activeVoices; )
     {
+        int k = activeVoice[v];
         int oldFilterState;
         int oldBendState;
         int oldModulationState;
         if (partnote[k].status == KEY_OFF)
+        {   // claimed, but no note was started
+            KillNotePos(k);
             continue;
+        }
         int noteplay = 0; // 0 if there is nothing activated
         partnote[k].time++;
         int keyATtype = partnote[k].keyATtype;
@@ -1070,10 +1240,18 @@ void Part::ComputePartSmps()
             ctl->setmodwheel(keyATvalue);
         }
 
+        // retired notes still go through the effects of their own instrument
+        bool toPrevious = partnote[k].retired && previous;
+        Samples* fxinputl = toPrevious? previous->partfxinputl : partfxinputl;
+        Samples* fxinputr = toPrevious? previous->partfxinputr : partfxinputr;
+        bool* fxinSilent  = toPrevious? previousSilent : fxSilent;
+
         // get the sampledata of the note and kill it if it's finished
         for (size_t item = 0; item < partnote[k].itemsplaying; ++item)
         {
             int sendcurrenttofx = partnote[k].kitItem[item].sendtoparteffect;
+            uint kitIndex = partnote[k].kitItem[item].kitIndex;
+            DSPProfiler::Ticks mark;
             ADnote *adnote = partnote[k].kitItem[item].adnote;
             SUBnote *subnote = partnote[k].kitItem[item].subnote;
             PADnote *padnote = partnote[k].kitItem[item].padnote;
@@ -1081,14 +1259,19 @@ void Part::ComputePartSmps()
             if (adnote)
             {
                 noteplay++;
+                mark = DSPProfiler::now();
                 adnote->noteout(tmpoutl.get(), tmpoutr.get());
+                profiler.addEngine(partID, kitIndex, DSPProfiler::addSynth, DSPProfiler::now() - mark);
                 for (int i = 0; i < synth.sent_buffersize; ++i)
                 {   // add the ADnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    fxinputl[sendcurrenttofx][i] += tmpoutl[i];
+                    fxinputr[sendcurrenttofx][i] += tmpoutr[i];
                 }
+                fxinSilent[sendcurrenttofx] = false;
                 if (adnote->finished())
                 {
+                    if (adnote->culled())
+                        profiler.addCulled(partID, DSPProfiler::addSynth);
                     delete partnote[k].kitItem[item].adnote;
                     partnote[k].kitItem[item].adnote = NULL;
                 }
@@ -1097,14 +1280,19 @@ void Part::ComputePartSmps()
             if (subnote)
             {
                 noteplay++;
+                mark = DSPProfiler::now();
                 subnote->noteout(tmpoutl.get(), tmpoutr.get());
+                profiler.addEngine(partID, kitIndex, DSPProfiler::subSynth, DSPProfiler::now() - mark);
                 for (int i = 0; i < synth.sent_buffersize; ++i)
                 {   // add the SUBnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    fxinputl[sendcurrenttofx][i] += tmpoutl[i];
+                    fxinputr[sendcurrenttofx][i] += tmpoutr[i];
                 }
+                fxinSilent[sendcurrenttofx] = false;
                 if (subnote->finished())
                 {
+                    if (subnote->culled())
+                        profiler.addCulled(partID, DSPProfiler::subSynth);
                     delete partnote[k].kitItem[item].subnote;
                     partnote[k].kitItem[item].subnote = NULL;
                 }
@@ -1113,14 +1301,19 @@ void Part::ComputePartSmps()
             if (padnote)
             {
                 noteplay++;
+                mark = DSPProfiler::now();
                 padnote->noteout(tmpoutl.get(), tmpoutr.get());
+                profiler.addEngine(partID, kitIndex, DSPProfiler::padSynth, DSPProfiler::now() - mark);
                 for (int i = 0 ; i < synth.sent_buffersize; ++i)
                 {   // add the PADnote to part(mix)
-                    partfxinputl[sendcurrenttofx][i] += tmpoutl[i];
-                    partfxinputr[sendcurrenttofx][i] += tmpoutr[i];
+                    fxinputl[sendcurrenttofx][i] += tmpoutl[i];
+                    fxinputr[sendcurrenttofx][i] += tmpoutr[i];
                 }
+                fxinSilent[sendcurrenttofx] = false;
                 if (padnote->finished())
                 {
+                    if (padnote->culled())
+                        profiler.addCulled(partID, DSPProfiler::padSynth);
                     delete partnote[k].kitItem[item].padnote;
                     partnote[k].kitItem[item].padnote = NULL;
                 }
@@ -1128,7 +1321,9 @@ void Part::ComputePartSmps()
         }
         // Kill note if there is no synth on that note
         if (noteplay == 0)
-            KillNotePos(k);
+            KillNotePos(k); // ...which also removes it from the active voices
+        else
+            ++v;
 
         if (keyATtype & PART::aftertouchType::filterCutoff)
             ctl->setfiltercutoff(oldFilterState);
@@ -1141,29 +1336,20 @@ void Part::ComputePartSmps()
     }
 
     // Apply part's effects and mix them
-    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+    DSPProfiler::Ticks efxStart = DSPProfiler::now();
+    silent = applyPartEffects(fxSilent);
+    memcpy(partoutl.get(), partfxinputl[NUM_PART_EFX].get(), synth.sent_bufferbytes);
+    memcpy(partoutr.get(), partfxinputr[NUM_PART_EFX].get(), synth.sent_bufferbytes);
+    if (previous && !previous->applyPartEffects(previousSilent))
     {
-        if (!Pefxbypass[nefx])
-        {
-            partefx[nefx]->out(partfxinputl[nefx].get(), partfxinputr[nefx].get());
-            if (Pefxroute[nefx] == 2)
-            {
-                for (int i = 0; i < synth.sent_buffersize; ++i)
-                {
-                    partfxinputl[nefx + 1][i] += partefx[nefx]->efxoutl[i];
-                    partfxinputr[nefx + 1][i] += partefx[nefx]->efxoutr[i];
-                }
-            }
-        }
-        int routeto = (Pefxroute[nefx] == 0) ? nefx + 1 : NUM_PART_EFX;
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
-            partfxinputl[routeto][i] += partfxinputl[nefx][i];
-            partfxinputr[routeto][i] += partfxinputr[nefx][i];
+            partoutl[i] += previous->partfxinputl[NUM_PART_EFX][i];
+            partoutr[i] += previous->partfxinputr[NUM_PART_EFX][i];
         }
+        silent = false;
     }
-    memcpy(partoutl.get(), partfxinputl[NUM_PART_EFX].get(), synth.sent_bufferbytes);
-    memcpy(partoutr.get(), partfxinputr[NUM_PART_EFX].get(), synth.sent_bufferbytes);
+    profiler.addEngine(partID, NUM_KIT_ITEMS, DSPProfiler::partEffects, DSPProfiler::now() - efxStart);
 
     // Kill All Notes if killallnotes true
     if (killallnotes)
@@ -1174,13 +1360,71 @@ void Part::ComputePartSmps()
             partoutl[i] *= tmp;
             partoutr[i] *= tmp;
         }
-        for (int k = 0; k < POLYPHONY; ++k)
-            KillNotePos(k);
+        while (activeVoices > 0)
+            KillNotePos(activeVoice[activeVoices - 1]);
         killallnotes = 0;
         for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
             partefx[nefx]->cleanup();
+        if (previous)
+            for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+                previous->partefx[nefx]->cleanup();
     }
     ctl->updateportamento();
+    profiler.addPart(partID, DSPProfiler::now() - partStart);
+}
+
+
+void Part::clearEffectInputs(bool fxSilent[])
+{
+    for (int nefx = 0; nefx < NUM_PART_EFX + 1; ++nefx)
+    {
+        memset(partfxinputl[nefx].get(), 0, synth.sent_bufferbytes);
+        memset(partfxinputr[nefx].get(), 0, synth.sent_bufferbytes);
+        fxSilent[nefx] = true;
+    }
+}
+
+
+/* run the part effect chain over the effect inputs;
+ * the result is left in the "no effect" buffer [NUM_PART_EFX],
+ * returns true when that is silent */
+bool Part::applyPartEffects(bool fxSilent[])
+{
+    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+    {
+        if (!Pefxbypass[nefx])
+        {
+            fxSilent[nefx] = partefx[nefx]->out(partfxinputl[nefx].get(), partfxinputr[nefx].get(), fxSilent[nefx]);
+            if (Pefxroute[nefx] == 2 && !fxSilent[nefx])
+            {
+                for (int i = 0; i < synth.sent_buffersize; ++i)
+                {
+                    partfxinputl[nefx + 1][i] += partefx[nefx]->efxoutl[i];
+                    partfxinputr[nefx + 1][i] += partefx[nefx]->efxoutr[i];
+                }
+                fxSilent[nefx + 1] = false;
+            }
+        }
+        if (fxSilent[nefx])
+            continue; // nothing to pass on
+        int routeto = (Pefxroute[nefx] == 0) ? nefx + 1 : NUM_PART_EFX;
+        for (int i = 0; i < synth.sent_buffersize; ++i)
+        {
+            partfxinputl[routeto][i] += partfxinputl[nefx][i];
+            partfxinputr[routeto][i] += partfxinputr[nefx][i];
+        }
+        fxSilent[routeto] = false;
+    }
+    return fxSilent[NUM_PART_EFX];
+}
+
+
+bool Part::partEffectsIdle()  const
+{
+    for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+        if (!Pefxbypass[nefx] && !partefx[nefx]->idle())
+            return false;
+    return true;
 }
 
 
@@ -1266,8 +1510,8 @@ void Part::setkititemstatus(int kititem, int Penabled_)
     }
 
     if (resetallnotes)
-        for (int k = 0; k < POLYPHONY; ++k)
-            KillNotePos(k);
+        while (activeVoices > 0)
+            KillNotePos(activeVoice[activeVoices - 1]);
 }
 
 
@@ -1367,6 +1611,8 @@ void Part::add2XML_YoshimiPartSetup(XMLtree& xmlPart)
     xmlPart.addPar_int("channel_aftertouch", PchannelATchoice);
     xmlPart.addPar_int("key_aftertouch"    , PkeyATchoice);
     xmlPart.addPar_int("key_limit"         , Pkeylimit);
+    xmlPart.addPar_int("voices"            , Pvoices);
+    xmlPart.addPar_int("voice_steal"       , Psteal);
     xmlPart.addPar_int("random_detune"     , Pfrand);
     xmlPart.addPar_int("random_velocity"   , Pvelrand);
     xmlPart.addPar_int("destination"       , Paudiodest);
@@ -1467,16 +1713,16 @@ bool Part::saveXML(string filename, bool yoshiFormat)
 
 int Part::loadXML(string filename)
 {
-    bool marked_as_Yoshi = true;
-    filename = setExtension(filename, EXTEN::yoshInst);
-    if (!isRegularFile(filename))
-    {
-        marked_as_Yoshi = false;
-        filename = setExtension(filename, EXTEN::zynInst);
-    }
+    filename = findInstrumentFile(filename);
+    XMLStore xml{filename, synth.getRuntime().getLogger()};
+    return loadXML(xml, filename);
+}
+
 
+int Part::loadXML(XMLStore& xml, string const& filename)
+{
+    bool marked_as_Yoshi = (findExtension(filename) == EXTEN::yoshInst);
     auto& logg = synth.getRuntime().getLogger();
-    XMLStore xml{filename, logg};
     postLoadCheck(xml,synth);
     if (not xml)
     {
@@ -1527,6 +1773,79 @@ int Part::loadXML(string filename)
 }
 
 
+/* Prepare this (shadow) part to receive an instrument on behalf of the live part;
+ * loadXML() retains these settings when the instrument file does not define them. */
+void Part::inheritSettings(Part const& live)
+{
+    Pkeymode = live.Pkeymode;
+    PbreathControl = live.PbreathControl;
+    ctl->copySettings(*live.ctl);
+}
+
+
+/* Exchange the instrument with the one loaded into a shadow part; called by the
+ * SynthEngine at the start of a period. Notes already playing carry on with the
+ * parameters they were started with, which are now owned by the shadow part,
+ * and are marked as retired. They are still fed through the former part effects,
+ * which the shadow now holds as well, until these have died away; only then may
+ * the shadow be released, and any previous one must have been ended before.
+ */
+void Part::swapInstrument(Part& loaded)
+{
+    using std::swap;
+    assert(not previous);
+    for (uint v = 0; v < activeVoices; ++v)
+        partnote[activeVoice[v]].retired = true;
+
+    swap(kit, loaded.kit);
+    swap(Pname, loaded.Pname);
+    swap(Poriginal, loaded.Poriginal);
+    swap(PyoshiType, loaded.PyoshiType);
+    swap(info, loaded.info);
+    swap(Pkitmode, loaded.Pkitmode);
+    swap(PkitfadeType, loaded.PkitfadeType);
+    swap(Pdrummode, loaded.Pdrummode);
+    swap(Pfrand, loaded.Pfrand);
+    swap(Pvelrand, loaded.Pvelrand);
+    swap(Pkeymode, loaded.Pkeymode);
+    swap(PbreathControl, loaded.PbreathControl);
+
+    swap(partefx, loaded.partefx);
+    swap(Pefxroute, loaded.Pefxroute);
+    swap(Pefxbypass, loaded.Pefxbypass);
+    swap(Peffnum, loaded.Peffnum);
+
+    ctl->copySettings(*loaded.ctl);
+    prevLegatoMode = false; // never connect legato to a retired note
+    previous = &loaded;
+}
+
+
+bool Part::ringingOut()  const
+{
+    if (not previous)
+        return false;
+    for (uint v = 0; v < activeVoices; ++v)
+        if (partnote[activeVoice[v]].retired)
+            return true;
+    return not previous->partEffectsIdle();
+}
+
+
+/* stop the retired notes and the former part effects; afterwards
+ * the SynthEngine can release the part holding the former instrument */
+void Part::endRingOut()
+{
+    for (uint v = activeVoices; v-- > 0;)
+        if (partnote[activeVoice[v]].retired)
+            KillNotePos(activeVoice[v]);
+    if (previous)
+        for (int nefx = 0; nefx < NUM_PART_EFX; ++nefx)
+            previous->partefx[nefx]->cleanup();
+    previous = nullptr;
+}
+
+
 void Part::getfromXML_InstrumentData(XMLtree& xmlInstrument)
 {
     assert(xmlInstrument);
@@ -1671,8 +1990,10 @@ void Part::getfromXML(XMLtree& xmlPart)
     PchannelATchoice = xmlPart.getPar_int("channel_aftertouch", PchannelATchoice, 0, 255);
     PkeyATchoice     = xmlPart.getPar_int("key_aftertouch",     PkeyATchoice, 0, 255);
 
-    Pkeylimit = xmlPart.getPar_127("key_limit", Pkeylimit);
-    if (Pkeylimit < 1 or Pkeylimit > POLYPHONY)
+    setVoiceCapacity(xmlPart.getPar_int("voices", Pvoices, MIN_POLYPHONY, MAX_POLYPHONY));
+    Psteal = xmlPart.getPar_int("voice_steal", Psteal, PART::stealType::released, PART::stealType::sameKey);
+    Pkeylimit = xmlPart.getPar_int("key_limit", Pkeylimit, 0, MAX_POLYPHONY);
+    if (Pkeylimit < 1)
         Pkeylimit = POLYPHONY;
     Pfrand   = xmlPart.getPar_int("random_detune",   Pfrand,   0,50);
     Pvelrand = xmlPart.getPar_int("random_velocity", Pvelrand, 0,50);
@@ -1814,7 +2135,18 @@ float Part::getLimits(CommandBlock *getData)
 
         case PART::control::maxNotes:
             def = 20;
-            max = POLYPHONY;
+            max = MAX_POLYPHONY;
+            break;
+
+        case PART::control::maxVoices:
+            min = MIN_POLYPHONY;
+            def = POLYPHONY;
+            max = MAX_POLYPHONY;
+            break;
+
+        case PART::control::voiceSteal:
+            def = PART::stealType::released;
+            max = PART::stealType::sameKey;
             break;
 
         case PART::control::keyShift:
@@ -31,6 +31,7 @@
 #include "DSP/FFTwrapper.h"
 #include "Params/ParamCheck.h"
 #include "Misc/Alloc.h"
+#include "Misc/RandomGen.h"
 
 #include <memory>
 #include <string>
@@ -48,6 +49,7 @@ class Controller;
 class Microtonal;
 class EffectMgr;
 class XMLtree;
+class XMLStore;
 
 class SynthEngine;
 
@@ -98,6 +100,13 @@ class Part
 
         bool saveXML(string filename, bool yoshiFormat); // result true for load ok, otherwise false
         int  loadXML(string filename);
+        int  loadXML(XMLStore& xml, string const& filename);  // already parsed, see InstrumentCache
+
+        // gapless instrument change, see SynthEngine::setProgram()
+        void inheritSettings(Part const& live);
+        void swapInstrument(Part& loaded);
+        bool ringingOut()  const;      // notes or part effects of the previous instrument still sound
+        void endRingOut();
         void add2XML_YoshimiPartSetup(XMLtree&);
         void add2XML_YoshimiInstrument(XMLtree&);
         void getfromXML(XMLtree&);
@@ -124,7 +133,8 @@ class Part
         KitItem kit[NUM_KIT_ITEMS];
 
         // Part parameters
-        void enforcekeylimit();
+        void enforcekeylimit(int note = -1);
+        void setVoiceCapacity(uint voices);
         void setkititemstatus(int kititem, int Penabled_);
         void setVolume(float value);
         void checkVolume(float step);
@@ -153,6 +163,8 @@ class Part
         uint   PkeyATchoice;
         uchar  Pkeylimit;      // how many keys can play simultaneously,
                                // time 0 = off, the older will be released
+        uint   Pvoices;        // voice capacity, beyond that voices are stolen
+        uchar  Psteal;         // which voice is stolen, see PART::stealType
         float  Pfrand;         // Part random frequency content
         float  Pvelrand;       // Part random velocity content
         uchar  PbreathControl;
@@ -171,6 +183,7 @@ class Part
 
         Samples partoutl;
         Samples partoutr;
+        bool    silent;    // partout is all zero in this period
 
         Samples partfxinputl[NUM_PART_EFX + 1]; // Left and right signal that pass-through part effects
         Samples partfxinputr[NUM_PART_EFX + 1]; // [NUM_PART_EFX] is for "no effect" buffer
@@ -186,6 +199,8 @@ class Part
         float pangainR;
         bool  busy;
 
+        RandomGen prng; // used instead of the master PRNG when computed by the RenderPool
+
         int getLastNote()  const { return this->prevNote; }
         SynthEngine& getSynthEngine() const {return synth;}
 
@@ -197,6 +212,12 @@ class Part
         void setPan(float value);
         void KillNotePos(int pos);
         void ReleaseNotePos(int pos);
+        int  claimVoice(int note);
+        int  chooseVictim(int note, bool heldOnly);
+        float voiceLevel(int pos)  const;
+        bool partEffectsIdle()  const;
+        void clearEffectInputs(bool fxSilent[]);
+        bool applyPartEffects(bool fxSilent[]);
         void monoNoteHistoryRecall();
 
         void startNewNotes        (int pos, size_t item, size_t currItem, Note, bool portamento, float volumeAdjustment);
@@ -205,30 +226,37 @@ class Part
         float computeKitItemCrossfade(size_t item, int midiNote);
         void incrementItemsPlaying(int pos, size_t currItem);
 
-        Samples& tmpoutl;
-        Samples& tmpoutr;
-
         Microtonal* microtonal;
         fft::Calc&  fft;
 
         struct PartNotes {
             NoteStatus status;
             int note;          // if there is no note playing, "note" = -1
-            int time;
+            int time;          // periods computed, 0 for a new note
             int keyATtype;
             int keyATvalue;
             size_t itemsplaying;
+            bool stolen;       // fading out to make way for a new note
+            bool retired;      // started with an instrument since swapped out
 
             struct KitItemNotes {
                 ADnote* adnote;
                 SUBnote* subnote;
                 PADnote* padnote;
                 int sendtoparteffect;
+                uchar kitIndex;    // position in the kit, for profiling
             };
             KitItemNotes kitItem[NUM_KIT_ITEMS];
         };                     // Note: kitItems are "packed", not using the same Index as in KitItem-array
 
-        PartNotes partnote[POLYPHONY];
+        // Pvoices and a few spare slots, where stolen voices fade out;
+        // only the positions listed as active (oldest first) are computed
+        std::unique_ptr<PartNotes[]> partnote;
+        std::unique_ptr<uint[]> activeVoice;
+        std::unique_ptr<uint[]> freeVoice;
+        uint activeVoices;
+        uint freeVoices;
+        uint stolenVoices;
 
         int   prevNote;        // previous MIDI note
         int   prevPos;         // previous note pos
@@ -237,6 +265,8 @@ class Part
 
         bool  killallnotes;    // "panic" switch
 
+        Part* previous;        // holds the former instrument while ringing out, see swapInstrument()
+
         int   oldFilterState;  // these for channel aftertouch
         int   oldFilterQstate;
         int   oldBendState;
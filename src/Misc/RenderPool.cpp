@@ -0,0 +1,141 @@
+/*
+    RenderPool.cpp - computing parts concurrently on real-time worker threads
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/RenderPool.h"
+#include "Misc/SynthEngine.h"
+#include "Misc/Part.h"
+
+#include <string>
+
+using std::to_string;
+
+
+namespace { // implementation details
+
+    /* hint to the CPU that we are busy waiting */
+    inline void cpuRelax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    inline uint32_t claimIndex(uint32_t claim) { return claim & 0xffff; }
+    inline uint32_t claimCount(uint32_t claim) { return claim >> 16; }
+}
+
+
+RenderPool::RenderPool(SynthEngine& _synth, uint workerCnt)
+    : synth{_synth}
+    , numWorkers{workerCnt}
+    , worker{new Worker[workerCnt]}
+    , mainContext{&_synth.getRuntime().genScratch, nullptr}
+    , running{true}
+    , job{}
+    , cursor{0}
+    , finished{0}
+{
+    for (uint w = 0; w < numWorkers; ++w)
+    {
+        Worker& wk = worker[w];
+        wk.pool = this;
+        wk.scratch.reset(synth.buffersize);
+        wk.context.scratch = &wk.scratch;
+        sem_init(&wk.wake, 0, 0);
+        wk.launched = synth.getRuntime().startThread(&wk.thread, _runWorker, &wk, true, 0,
+                                                     "Render " + to_string(w + 1));
+        if (!wk.launched)
+            synth.getRuntime().Log("Failed to start render thread " + to_string(w + 1), _SYS_::LogError);
+    }
+}
+
+
+RenderPool::~RenderPool()
+{
+    running.store(false, std::memory_order_release);
+    for (uint w = 0; w < numWorkers; ++w)
+        if (worker[w].launched)
+        {
+            sem_post(&worker[w].wake);
+            pthread_join(worker[w].thread, NULL);
+        }
+    for (uint w = 0; w < numWorkers; ++w)
+        sem_destroy(&worker[w].wake);
+}
+
+
+void RenderPool::computeParts(uchar const* parts, uint count)
+{
+    if (count == 0)
+        return;
+    for (uint i = 0; i < count; ++i)
+        job[i] = parts[i];
+    finished.store(0, std::memory_order_relaxed);
+    cursor.store(count << 16, std::memory_order_release);
+
+    // the audio thread takes one share itself
+    uint wanted = count - 1;
+    for (uint w = 0; w < numWorkers && wanted > 0; ++w, --wanted)
+        if (worker[w].launched)
+            sem_post(&worker[w].wake);
+
+    threadContext = &mainContext;
+    runJobs(mainContext);
+    threadContext = nullptr;
+
+    while (finished.load(std::memory_order_acquire) < count)
+        cpuRelax();
+}
+
+
+void RenderPool::runJobs(Context& context)
+{
+    uint32_t claim = cursor.load(std::memory_order_acquire);
+    while (claimIndex(claim) < claimCount(claim))
+    {
+        if (!cursor.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel,
+                                                            std::memory_order_acquire))
+            continue; // claim now holds the current cursor
+
+        Part& part = *synth.part[job[claimIndex(claim)]];
+        context.prng = &part.prng;
+        part.ComputePartSmps();
+        finished.fetch_add(1, std::memory_order_release);
+        claim = cursor.load(std::memory_order_acquire);
+    }
+}
+
+
+void* RenderPool::_runWorker(void* arg)
+{
+    Worker& self = *static_cast<Worker*>(arg);
+    RenderPool& pool = *self.pool;
+    threadContext = &self.context;
+    while (true)
+    {
+        sem_wait(&self.wake);
+        if (!pool.running.load(std::memory_order_acquire))
+            break;
+        pool.runJobs(self.context);
+    }
+    return NULL;
+}
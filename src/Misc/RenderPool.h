@@ -0,0 +1,125 @@
+/*
+    RenderPool.h - computing parts concurrently on real-time worker threads
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef RENDERPOOL_H
+#define RENDERPOOL_H
+
+#include <atomic>
+#include <memory>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "globals.h"
+#include "Misc/Alloc.h"
+#include "Misc/RandomGen.h"
+
+class SynthEngine;
+
+
+/* Optional pool of real-time worker threads, used by SynthEngine::MasterAudio
+ * to compute the samples of independent parts concurrently. The audio thread
+ * publishes the list of active parts, wakes the workers and then joins in,
+ * claiming parts itself until none are left; finally it waits (spinning)
+ * for the parts claimed by the workers, before insertion and system effects
+ * are applied. No memory is allocated and no locks are taken within a period.
+ *
+ * Every thread computing a part uses its own ScratchBuffers, and while a part
+ * is computed, all random numbers drawn through the SynthEngine are taken from
+ * the part's own PRNG, so the result does not depend on the thread assignment.
+ */
+class RenderPool
+{
+    public:
+        /* what the current thread uses while computing a part */
+        struct Context
+        {
+            ScratchBuffers* scratch;
+            RandomGen*      prng;
+        };
+
+        /* Context of the calling thread; NULL unless computing on behalf of the pool */
+        static Context* current() { return threadContext; }
+
+        /* lets another thread, e.g. one loading an instrument, draw the random
+         * numbers requested through the SynthEngine from a PRNG of its own */
+        class PrngScope
+        {
+            Context context;
+            Context* outer;
+
+            public:
+                PrngScope(RandomGen& prng)
+                    : context{nullptr, &prng}
+                    , outer{threadContext}
+                    { threadContext = &context; }
+               ~PrngScope() { threadContext = outer; }
+                // shall not be copied nor moved
+                PrngScope(PrngScope&&)                 = delete;
+                PrngScope(PrngScope const&)            = delete;
+                PrngScope& operator=(PrngScope&&)      = delete;
+                PrngScope& operator=(PrngScope const&) = delete;
+        };
+
+        RenderPool(SynthEngine&, uint numWorkers);
+       ~RenderPool();
+        // shall not be copied nor moved
+        RenderPool(RenderPool&&)                 = delete;
+        RenderPool(RenderPool const&)            = delete;
+        RenderPool& operator=(RenderPool&&)      = delete;
+        RenderPool& operator=(RenderPool const&) = delete;
+
+        uint workers()  const { return numWorkers; }
+
+        /* compute the given parts; returns when all are done */
+        void computeParts(uchar const* parts, uint count);
+
+    private:
+        struct Worker
+        {
+            RenderPool*    pool{nullptr};
+            pthread_t      thread{};
+            sem_t          wake{};
+            bool           launched{false};
+            ScratchBuffers scratch{};
+            Context        context{nullptr, nullptr};
+        };
+
+        SynthEngine& synth;
+        uint numWorkers;
+        std::unique_ptr<Worker[]> worker;
+        Context mainContext;
+
+        std::atomic<bool> running;
+
+        /* Jobs are claimed by incrementing the cursor, which holds
+         * the job count in the upper and the next index in the lower half.
+         * Once all jobs are claimed, index == count, and a stale claim
+         * can never succeed. */
+        uchar job[NUM_MIDI_PARTS];
+        std::atomic<uint32_t> cursor;
+        std::atomic<uint32_t> finished;
+
+        static inline thread_local Context* threadContext{nullptr};
+
+        void runJobs(Context&);
+        static void* _runWorker(void*);
+};
+
+#endif /*RENDERPOOL_H*/
@@ -44,6 +44,7 @@
 #endif
 
 #include "Misc/Alloc.h"
+#include "Misc/NotePool.h"
 #include "Misc/SynthEngine.h"
 #include "Misc/Config.h"
 #include "Params/Controller.h"
@@ -58,10 +59,12 @@
 #include "Params/ADnoteParameters.h"
 #include "Params/PADnoteParameters.h"
 #include "Interface/InterfaceAnchor.h"
+#include "Misc/BuildScheduler.h"
 
 using file::isRegularFile;
 using file::setExtension;
 using file::findLeafName;
+using file::findInstrumentFile;
 using file::createEmptyFile;
 using file::deleteFile;
 using file::make_legit_filename;
@@ -102,6 +105,136 @@ namespace { // Global implementation internal history data
 }
 
 
+namespace { namespace mix { // kernels of the mixing stage, simple loops left to auto-vectorisation
+
+    struct Meter
+    {
+        float& peakL;
+        float& peakR;
+        float& rmsL;
+        float& rmsR;
+    };
+
+    inline void applyRamp(float* __restrict smpL, float* __restrict smpR
+                         ,float const* __restrict gainL, float const* __restrict gainR, int cnt)
+    {
+        for (int i = 0; i < cnt; ++i)
+        {
+            smpL[i] *= gainL[i];
+            smpR[i] *= gainR[i];
+        }
+    }
+
+    inline void addScaled(float* __restrict dest, float const* __restrict src, float gain, int cnt)
+    {
+        for (int i = 0; i < cnt; ++i)
+            dest[i] += src[i] * gain;
+    }
+
+    inline void add(float* __restrict dest, float const* __restrict src, int cnt)
+    {
+        for (int i = 0; i < cnt; ++i)
+            dest[i] += src[i];
+    }
+
+    /* where a part's sound goes; targets not used are NULL */
+    struct PartRouting
+    {
+        float const* rampL{nullptr};    // per sample gain while volume/panning moves,
+        float const* rampR{nullptr};
+        float gainL{0}, gainR{0};       // ...else constant gain
+        float* directL{nullptr};        // separate part output
+        float* directR{nullptr};
+        float* mainL{nullptr};
+        float* mainR{nullptr};
+        uint   sends{0};                // inputs of system effects
+        float* sendL[NUM_SYS_EFX];
+        float* sendR[NUM_SYS_EFX];
+        float  sendVol[NUM_SYS_EFX];
+    };
+
+    /* part gain in place, with peak metering */
+    template<bool RAMP>
+    inline void partGain(float* __restrict smpL, float* __restrict smpR
+                        ,float const* __restrict rampL, float const* __restrict rampR
+                        ,float gainL, float gainR, float& peakL, float& peakR, int cnt)
+    {
+        float pL = peakL, pR = peakR;
+        for (int i = 0; i < cnt; ++i)
+        {
+            float l = smpL[i] * (RAMP? rampL[i] : gainL);
+            float r = smpR[i] * (RAMP? rampR[i] : gainR);
+            smpL[i] = l;
+            smpR[i] = r;
+            pL = std::max(pL, fabsf(l));
+            pR = std::max(pR, fabsf(r));
+        }
+        peakL = pL;
+        peakR = pR;
+    }
+
+    /* gain and peak metering of one part, then a branch free pass per target;
+     * the order of additions into each target is the same as before */
+    template<bool RAMP>
+    inline void part(float* smpL, float* smpR, PartRouting const& route, float& peakL, float& peakR, int cnt)
+    {
+        partGain<RAMP>(smpL, smpR, route.rampL, route.rampR, route.gainL, route.gainR, peakL, peakR, cnt);
+        if (route.directL)
+        {
+            memcpy(route.directL, smpL, cnt * sizeof(float));
+            memcpy(route.directR, smpR, cnt * sizeof(float));
+        }
+        for (uint s = 0; s < route.sends; ++s)
+        {
+            addScaled(route.sendL[s], smpL, route.sendVol[s], cnt);
+            addScaled(route.sendR[s], smpR, route.sendVol[s], cnt);
+        }
+        if (route.mainL)
+        {
+            add(route.mainL, smpL, cnt);
+            add(route.mainR, smpR, cnt);
+        }
+    }
+
+    inline void meter(float const* __restrict mainL, float const* __restrict mainR, int cnt, Meter& meter)
+    {
+        float peakL = meter.peakL, peakR = meter.peakR;
+        float rmsL = meter.rmsL, rmsR = meter.rmsR;
+        for (int i = 0; i < cnt; ++i)
+        {
+            peakL = std::max(peakL, fabsf(mainL[i]));
+            peakR = std::max(peakR, fabsf(mainR[i]));
+            rmsL += mainL[i] * mainL[i];
+            rmsR += mainR[i] * mainR[i];
+        }
+        meter.peakL = peakL; meter.peakR = peakR;
+        meter.rmsL = rmsL; meter.rmsR = rmsR;
+    }
+
+    /* master volume, optional mono fold-down and metering, in one pass */
+    inline void master(float* __restrict mainL, float* __restrict mainR, float volume, bool mono, int cnt, Meter& meter)
+    {
+        float peakL = meter.peakL, peakR = meter.peakR;
+        float rmsL = meter.rmsL, rmsR = meter.rmsR;
+        for (int i = 0; i < cnt; ++i)
+        {
+            float l = mainL[i] * volume;
+            float r = mainR[i] * volume;
+            if (mono)
+                l = r = (l + r) * 0.5f;
+            mainL[i] = l;
+            mainR[i] = r;
+            peakL = std::max(peakL, fabsf(l));
+            peakR = std::max(peakR, fabsf(r));
+            rmsL += l * l;
+            rmsR += r * r;
+        }
+        meter.peakL = peakL; meter.peakR = peakR;
+        meter.rmsL = rmsL; meter.rmsR = rmsR;
+    }
+}}//(End)mixing stage kernels
+
+
 
 SynthEngine::SynthEngine(uint instanceID)
     : uniqueId{instanceID}
@@ -160,6 +293,7 @@ SynthEngine::SynthEngine(uint instanceID)
     , ctl{NULL}
     , microtonal{this}
     , fft{}
+    , renderPool{}
     , textMsgBuffer{TextMsgBuffer::instance()}
     , VUpeak{}
     , VUcopy{}
@@ -179,6 +313,12 @@ SynthEngine::SynthEngine(uint instanceID)
     , monotonicBeat{0.0}
     , bpm{90}
     , bpmAccurate{false}
+    // instrumentSwap[]
+    , released{nullptr}
+    , awaitingGui{}
+    , programLoad{}
+    , releasing{}
+    , programSwapTime{0}
 {
     union {
         uint32_t u32 = 0x11223344;
@@ -209,10 +349,23 @@ SynthEngine::~SynthEngine()
 #ifdef GUI_FLTK
     shutdownGui();
 #endif
+    renderPool.reset(); // workers must be gone before the parts
 
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
         if (part[npart])
             delete part[npart];
+    for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+    {   // only after their notes are gone
+        delete instrumentSwap[npart].ringing;
+        delete instrumentSwap[npart].loaded.load();
+    }
+    for (ShadowPart* shadow = released.load(); shadow; )
+    {
+        ShadowPart* next = shadow->next;
+        delete shadow;
+        shadow = next;
+    }
+    awaitingGui.clear();
 
     for (int nefx = 0; nefx < NUM_INS_EFX; ++nefx)
         if (insefx[nefx])
@@ -275,11 +428,16 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
     fadeStep = 1.0f / 0.1f / samplerate_f; // 100ms for 0 to 1
     fadeStepShort = 1.0f / 0.005f / samplerate_f; // 5ms for 0 to 1
     ControlStep = 127.0f / 0.2f / samplerate_f; // 200ms for 0 to 127
+    setNoteCull();
+    instrumentCache.setLimit(Runtime.instrumentCacheSize);
 
     fft.reset(new fft::Calc(oscilsize));
 
     sem_init(&partlock, 0, 1);
 
+    // notes are built within the audio thread from these blocks
+    NotePool::reserve();
+
     for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
     {
         part[npart] = new Part(npart, &microtonal, *fft, *this);
@@ -288,6 +446,7 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
             Runtime.Log("Failed to allocate new Part");
             goto bail_out;
         }
+        instrumentSwap[npart].seed = randomINT();
     }
 
     // Insertion Effects init
@@ -315,14 +474,20 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
      * were being made every time an add or sub note
      * was processed. Now global so treat with care!
      */
-    Runtime.genTmp1.reset(buffersize);
-    Runtime.genTmp2.reset(buffersize);
-    Runtime.genTmp3.reset(buffersize);
-    Runtime.genTmp4.reset(buffersize);
+    Runtime.genScratch.reset(buffersize);
+    mixGainl.reset(buffersize);
+    mixGainr.reset(buffersize);
+    for (int nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
+    {
+        sysefxInl[nefx].reset(buffersize);
+        sysefxInr[nefx].reset(buffersize);
+    }
 
-    // similar to above but for parts
-    Runtime.genMixl.reset(buffersize);
-    Runtime.genMixr.reset(buffersize);
+    if (Runtime.renderThreads > 0)
+    {
+        renderPool.reset(new RenderPool(*this, Runtime.renderThreads));
+        Runtime.Log("Computing parts with " + asString(Runtime.renderThreads) + " additional threads");
+    }
 
     defaults();
     ClearNRPNs();
@@ -380,6 +545,7 @@ bool SynthEngine::Init(uint audiosrate, int audiobufsize)
 
     // we seem to need this here only for first time startup :(
     bank.setCurrentBankID(Runtime.tempBank, false);
+    preloadBank(Runtime.currentRoot, Runtime.currentBank);
     return true;
 
 
@@ -611,6 +777,9 @@ void SynthEngine::setReproducibleState(int seed)
                         if (not kitItem.adpars->VoicePar[v].Enabled) continue;
                         kitItem.adpars->VoicePar[v].OscilSmp->reseed(randomINT());
                         kitItem.adpars->VoicePar[v].FMSmp->reseed(randomINT());
+                        // note-on must not depend on background build timing
+                        kitItem.adpars->VoicePar[v].OscilSmp->buildTables();
+                        kitItem.adpars->VoicePar[v].FMSmp->buildTables();
                     }
                 if (kitItem.padpars and kitItem.Ppadenabled)
                     {
@@ -621,6 +790,13 @@ void SynthEngine::setReproducibleState(int seed)
                         kitItem.padpars->activate_wavetable();
                     }
             }
+    // derived seeds; must not draw from the master PRNG
+    for (int p = 0; p < NUM_MIDI_PARTS; ++p)
+    {
+        if (part[p])
+            part[p]->prng.init(uint32_t(seed) + p + 1);
+        instrumentSwap[p].seed = uint32_t(seed) + NUM_MIDI_PARTS + p + 1;
+    }
     Runtime.Log("SynthEngine("+to_string(uniqueId)+"): reseeded with "+to_string(seed));
 }
 
@@ -1053,6 +1229,9 @@ int SynthEngine::setRootBank(int root, int banknum, bool inplace)
         }
     }
 
+    if (ok)
+        preloadBank(Runtime.currentRoot, Runtime.currentBank);
+
     int msgID = NO_MSG;
     if (not inplace)
         msgID = textMsgBuffer.push(name);
@@ -1097,15 +1276,12 @@ int SynthEngine::setProgramByName(CommandBlock& cmd)
     {
         using Millisec = std::chrono::duration<int, std::milli>;
         auto duration = duration_cast<Millisec>(steady_clock::now() - startTime);
-        name += ("  Time " + to_string(duration.count()) + "ms");
+        name += ("  Time " + to_string(duration.count()) + "ms (swap " + to_string(programSwapTime) + "ms)");
     }
 
     msgID = textMsgBuffer.push(name);
     if (not ok)
-    {
-        msgID |= 0xFF0000;
-        partonoffLock(npart, 2); // as it was
-    }
+        msgID |= 0xFF0000; // the previous instrument stays in place
     else
     {
         Runtime.sessionSeen[TOPLEVEL::XML::Instrument] = true;
@@ -1119,7 +1295,7 @@ int SynthEngine::setProgramByName(CommandBlock& cmd)
 int SynthEngine::setProgramFromBank(CommandBlock& cmd, bool inplace)
 {
     steady_clock::time_point startTime;
-    if (not inplace and Runtime.showTimes)
+    if (Runtime.showTimes)
         startTime = steady_clock::now();
 
     int instrument = int(cmd.data.value);
@@ -1143,7 +1319,7 @@ int SynthEngine::setProgramFromBank(CommandBlock& cmd, bool inplace)
     }
     else
     {
-        ok = setProgram(fname, npart);
+        ok = setProgram(fname, npart, inplace);
         if (not inplace)
         {
             if (not ok)
@@ -1151,37 +1327,222 @@ int SynthEngine::setProgramFromBank(CommandBlock& cmd, bool inplace)
         }
     }
 
-    int msgID = NO_MSG;
-    if (not inplace)
+    string timing;
+    if (ok and Runtime.showTimes)
     {
-        if (ok and Runtime.showTimes)
-        {
-            using Millisec = std::chrono::duration<int, std::milli>;
-            auto duration = duration_cast<Millisec>(steady_clock::now() - startTime);
-            name += ("  Time " + to_string(duration.count()) + "ms");
-        }
-        msgID = textMsgBuffer.push(name);
+        using Millisec = std::chrono::duration<int, std::milli>;
+        auto duration = duration_cast<Millisec>(steady_clock::now() - startTime);
+        timing = "  Time " + to_string(duration.count()) + "ms (swap " + to_string(programSwapTime) + "ms)";
     }
+    int msgID = NO_MSG;
+    if (not inplace)
+        msgID = textMsgBuffer.push(name + timing);
+    else if (not timing.empty())
+        Runtime.Log("Part " + to_string(npart + 1) + " program change" + timing);
     if (not ok)
-    {
-        msgID |= 0xFF0000;
-        partonoffLock(npart, 2); // as it was
-    }
+        msgID |= 0xFF0000; // the previous instrument stays in place
     else
         partonoffLock(npart, 1);
     return msgID;
 }
 
 
-bool SynthEngine::setProgram(string const& fname, int npart)
+namespace {
+    // how long setProgram() waits for the audio thread to take over an instrument
+    const int SWAP_TIMEOUT_ms = 1000;
+
+    // steps the seed for each instrument loaded into a part
+    const uint32_t SEED_STEP = 0x9E3779B9;
+}
+
+/*
+ * Program change without a gap: the instrument is loaded into a shadow part
+ * on the calling thread, while the part carries on playing. At the start of
+ * the next period the audio thread swaps it in, see swapLoadedInstruments();
+ * notes still sounding then ring out with the previous instrument. When called
+ * in place, we are on the audio thread already and swap right away; the former
+ * instrument is freed later, see disposeReleasedInstruments().
+ *
+ * Loading must not draw from the master PRNG, which belongs to the audio thread;
+ * the shadow part uses a PRNG of its own, seeded from a sequence for each part.
+ */
+bool SynthEngine::setProgram(string const& fname, int npart, bool inPlace)
 {
+    std::unique_lock<std::mutex> guard(programLoad, std::defer_lock);
+    if (not inPlace)
+        guard.lock(); // the audio thread never waits for another load
     // switch active part (UI will do the same on returns_update)
     getRuntime().currentPart = npart;
     interchange.undoRedoClear();
-    bool ok = true;
-    if (!part[npart]->loadXML(fname))
-        ok = false;
-    return ok;
+    InstrumentSwap& handover = instrumentSwap[npart];
+
+    RandomGen loadPrng;
+    loadPrng.init(handover.seed.fetch_add(SEED_STEP, std::memory_order_relaxed));
+    std::unique_ptr<ShadowPart> loaded{new ShadowPart};
+    {
+        RenderPool::PrngScope scope{loadPrng};
+        loaded->part.reset(new Part(npart, &microtonal, *fft, *this));
+        loaded->part->inheritSettings(*part[npart]);
+        string filename = findInstrumentFile(fname);
+        if (std::optional<XMLStore> cached = instrumentCache.fetch(filename))
+        {
+            if (!loaded->part->loadXML(*cached, filename))
+                return false;
+        }
+        else if (!loaded->part->loadXML(filename))
+            return false;
+    }
+    for (int item = 0; item < NUM_KIT_ITEMS; ++item)
+        if (loaded->part->kit[item].padpars)
+            loaded->part->kit[item].padpars->awaitWavetable();
+
+    steady_clock::time_point loadedTime = steady_clock::now();
+    if (inPlace)
+    {
+        while (handover.busy.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield(); // only while setProgram() swaps, see below
+        if (ShadowPart* pending = handover.loaded.exchange(nullptr, std::memory_order_acq_rel))
+            takeInstrument(npart, pending); // requested earlier
+        takeInstrument(npart, loaded.release());
+        handover.busy.clear(std::memory_order_release);
+    }
+    else
+    {
+        handover.done.store(false, std::memory_order_relaxed);
+        handover.loaded.store(loaded.release(), std::memory_order_release);
+        for (int waited = 0; not handover.done.load(std::memory_order_acquire) and waited < SWAP_TIMEOUT_ms; ++waited)
+            sleep_for(1000us);
+        if (not handover.done.load(std::memory_order_acquire))
+        {
+            if (ShadowPart* pending = handover.loaded.exchange(nullptr, std::memory_order_acq_rel))
+            {   // audio is not running; swap while the part is switched off
+                partonoffLock(npart, -1);
+                while (handover.busy.test_and_set(std::memory_order_acquire))
+                    sleep_for(100us);
+                takeInstrument(npart, pending);
+                handover.busy.clear(std::memory_order_release);
+                partonoffLock(npart, 2);
+            }
+            else
+                while (not handover.done.load(std::memory_order_acquire))
+                    sleep_for(1000us); // was claimed just now
+        }
+        deleteReleasedShadows();
+    }
+    using Millisec = std::chrono::duration<int, std::milli>;
+    programSwapTime = duration_cast<Millisec>(steady_clock::now() - loadedTime).count();
+
+    // publish the part effects of the new instrument
+    if (npart == Runtime.currentPart)
+        pushEffectUpdate(npart);
+    return true;
+}
+
+
+/*
+ * Called at the start of each period: swap in instruments loaded by setProgram(),
+ * and release the previous ones, once all of their notes and part effects have
+ * died away. Should another instrument arrive before that, these are stopped.
+ */
+void SynthEngine::swapLoadedInstruments()
+{
+    for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+    {
+        InstrumentSwap& handover = instrumentSwap[npart];
+        if (not handover.ringing and not handover.loaded.load(std::memory_order_relaxed))
+            continue;
+        if (handover.busy.test_and_set(std::memory_order_acquire))
+            continue; // setProgram() swaps right now; try again next period
+        if (handover.ringing and not part[npart]->ringingOut())
+        {
+            part[npart]->endRingOut();
+            releaseShadow(handover.ringing);
+            handover.ringing = nullptr;
+        }
+        if (ShadowPart* loaded = handover.loaded.exchange(nullptr, std::memory_order_acq_rel))
+            takeInstrument(npart, loaded);
+        handover.busy.clear(std::memory_order_release);
+    }
+}
+
+
+/* with instrumentSwap[npart].busy held */
+void SynthEngine::takeInstrument(int npart, ShadowPart* loaded)
+{
+    InstrumentSwap& handover = instrumentSwap[npart];
+    if (handover.ringing)
+    {
+        part[npart]->endRingOut();
+        releaseShadow(handover.ringing);
+    }
+    part[npart]->swapInstrument(*loaded->part);
+    loaded->generation = handover.generation.fetch_add(1); // also publishes the swap to the GUI
+    handover.ringing = loaded; // now holding the previous instrument
+    handover.done.store(true, std::memory_order_release);
+}
+
+
+/* A shadow part no longer playing is handed on without taking a lock or
+ * freeing memory, since this happens on the audio thread. It will be deleted
+ * by deleteReleasedShadows(), when the GUI no longer refers to the parameters
+ * it holds. */
+void SynthEngine::releaseShadow(ShadowPart* shadow)
+{
+    shadow->next = released.load(std::memory_order_relaxed);
+    while (not released.compare_exchange_weak(shadow->next, shadow, std::memory_order_release, std::memory_order_relaxed))
+    { }
+}
+
+
+/* Any GUI editor for a part takes its parameter objects after guiBindsPart()
+ * and drops them all before guiReleasesPart(); a former instrument may be
+ * deleted when the GUI has since been bound to a later one, or not at all. */
+void SynthEngine::deleteReleasedShadows()
+{
+    std::list<std::unique_ptr<ShadowPart>> disposable;
+    {
+        std::lock_guard<std::mutex> guard(releasing);
+        for (ShadowPart* shadow = released.exchange(nullptr, std::memory_order_acquire); shadow; )
+        {
+            ShadowPart* next = shadow->next;
+            awaitingGui.emplace_back(shadow);
+            shadow = next;
+        }
+        for (auto pos = awaitingGui.begin(); pos != awaitingGui.end(); )
+        {
+            uint bound = instrumentSwap[(*pos)->part->partID].guiGeneration.load();
+            if (bound == InstrumentSwap::UNBOUND or bound > (*pos)->generation)
+                disposable.splice(disposable.end(), awaitingGui, pos++);
+            else
+                ++pos;
+        }
+    }
+}   // deleted here, outside the lock
+
+
+void SynthEngine::guiBindsPart(int npart)
+{
+    InstrumentSwap& handover = instrumentSwap[npart];
+    handover.guiGeneration.store(handover.generation.load());
+    std::atomic_thread_fence(std::memory_order_seq_cst); // before the GUI reads the parameter pointers
+    deleteReleasedShadows();
+}
+
+
+void SynthEngine::guiReleasesPart(int npart)
+{
+    instrumentSwap[npart].guiGeneration.store(InstrumentSwap::UNBOUND);
+    deleteReleasedShadows();
+}
+
+
+/* An in place program change (LV2 freewheeling, offline render) swaps on the
+ * audio thread, which can not free the former instrument; this is picked up
+ * later from a thread that may block and free. Cheap when nothing is pending. */
+void SynthEngine::disposeReleasedInstruments()
+{
+    if (released.load(std::memory_order_relaxed))
+        deleteReleasedShadows();
 }
 
 
@@ -1479,6 +1840,29 @@ void SynthEngine::ListSettings(list<string>& msg_buf)
     msg_buf.push_back("  Number of available parts "
                     + asString(Runtime.numAvailableParts));
 
+    if (renderPool)
+        msg_buf.push_back("  Parts computed with " + asString(renderPool->workers()) + " additional threads");
+    else
+        msg_buf.push_back("  Parts computed by audio thread only");
+
+    msg_buf.push_back("  Note allocations beyond pool "
+                    + asString(NotePool::fallbackCount()));
+
+    if (Runtime.noteCullTime > 0)
+        msg_buf.push_back("  Released notes stopped after " + asString(Runtime.noteCullTime)
+                        + "ms below " + asString(Runtime.noteCullLevel) + "dB");
+    else
+        msg_buf.push_back("  Released notes play until their envelope ends");
+
+    for (task::Priority prio : {task::INTERACTIVE, task::BULK})
+    {
+        task::RunnerBackend::Statistics stats = task::RunnerBackend::statistics(prio);
+        msg_buf.push_back(string(prio == task::INTERACTIVE? "  Interactive" : "  Bulk") + " background tasks "
+                        + asString(stats.tasks) + ", wait ms avg " + asString(float(stats.avgWait))
+                        + " max " + asString(float(stats.maxWait)) + ", run ms avg " + asString(float(stats.avgRun))
+                        + " max " + asString(float(stats.maxRun)));
+    }
+
     msg_buf.push_back("  Current part " + asString(Runtime.currentPart + 1));
 
     msg_buf.push_back("  Current part's channel " + asString((int)part[Runtime.currentPart]->Prcvchn + 1));
@@ -2097,6 +2481,34 @@ char SynthEngine::partonoffRead(uint npart)
 }
 
 
+/* While volume or panning of the part is still moving towards its target,
+ * fill the per sample gains into mixGainl/r and return true; otherwise the
+ * gain stays constant throughout the buffer. */
+bool SynthEngine::rampPartGain(Part& thePart, uchar panLaw)
+{
+    float Step = ControlStep;
+    if (!(thePart.Ppanning - thePart.TransPanning > Step) && !(thePart.TransPanning - thePart.Ppanning > Step)
+     && !(thePart.Pvolume - thePart.TransVolume > Step) && !(thePart.TransVolume - thePart.Pvolume > Step))
+        return false;
+
+    float relvolume = thePart.ctl->expression.relvolume;
+    for (int i = 0; i < sent_buffersize; ++i)
+    {
+        if (thePart.Ppanning - thePart.TransPanning > Step)
+            thePart.checkPanning(Step, panLaw);
+        else if (thePart.TransPanning - thePart.Ppanning > Step)
+            thePart.checkPanning(-Step, panLaw);
+        if (thePart.Pvolume - thePart.TransVolume > Step)
+            thePart.checkVolume(Step);
+        else if (thePart.TransVolume - thePart.Pvolume > Step)
+            thePart.checkVolume(-Step);
+        mixGainl[i] = thePart.pannedVolLeft() * relvolume;
+        mixGainr[i] = thePart.pannedVolRight() * relvolume;
+    }
+    return true;
+}
+
+
 // Master audio out (the final sound)
 int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_MIDI_PARTS + 1], int to_process)
 {
@@ -2108,8 +2520,6 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     float *mainL = outl[NUM_MIDI_PARTS]; // tiny optimisation
     float *mainR = outr[NUM_MIDI_PARTS]; // makes code clearer
 
-    Samples& tmpmixl = Runtime.genMixl;
-    Samples& tmpmixr = Runtime.genMixr;
     sent_buffersize = buffersize;
     sent_bufferbytes = bufferbytes;
     sent_buffersize_f = buffersize_f;
@@ -2124,6 +2534,7 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     memset(mainL, 0, sent_bufferbytes);
     memset(mainR, 0, sent_bufferbytes);
 
+    profiler.beginCycle(Runtime.numAvailableParts);
     uchar sound = audioOut.load();
     switch (sound)
     {
@@ -2162,7 +2573,10 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     }
 
 
+    DSPProfiler::Ticks mark = DSPProfiler::now();
     interchange.mediate();
+    swapLoadedInstruments();
+    mark = profiler.lap(DSPProfiler::mediate, mark);
     char partLocal[NUM_MIDI_PARTS];
     /*
      * This isolates the loop from part changes so that when a low
@@ -2191,14 +2605,40 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
     else
     {
         // Compute part samples and store them ->partoutl,partoutr
-        for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+        if (renderPool)
         {
-            if (partLocal[npart])
+            uchar active[NUM_MIDI_PARTS];
+            uint count = 0;
+            for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+            {
+                if (partLocal[npart])
+                    active[count++] = npart;
+            }
+            renderPool->computeParts(active, count);
+        }
+        else
+        {
+            for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
             {
-                legatoPart = npart;
-                part[npart]->ComputePartSmps();
+                if (partLocal[npart])
+                {
+                    legatoPart = npart;
+                    part[npart]->ComputePartSmps();
+                }
             }
         }
+        mark = profiler.lap(DSPProfiler::parts, mark);
+
+        /*
+         * Silence propagation: a part without sound, where also all effect
+         * tails have decayed, marks its buffer as silent. This is passed on
+         * through the insertion and system effects, which then skip their
+         * processing, and all mixing of silent buffers is skipped.
+         */
+        bool partSilent[NUM_MIDI_PARTS];
+        for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+            partSilent[npart] = !partLocal[npart] || part[npart]->silent;
+
         // Insertion effects
         int nefx;
         for (nefx = 0; nefx < NUM_INS_EFX; ++nefx)
@@ -2207,182 +2647,189 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
             {
                 int efxpart = Pinsparts[nefx];
                 if (part[efxpart]->Penabled)
-                    insefx[nefx]->out(part[efxpart]->partoutl.get(),
-                                      part[efxpart]->partoutr.get());
+                    partSilent[efxpart] = insefx[nefx]->out(part[efxpart]->partoutl.get(),
+                                                            part[efxpart]->partoutr.get(),
+                                                            partSilent[efxpart]);
             }
         }
+        mark = profiler.lap(DSPProfiler::insertEffects, mark);
+
+        /*
+         * Fused mixing stage: one pass over each part buffer applies volume
+         * and panning (after insertion effects) and feeds the direct out,
+         * the part VU, the sends into the system effect inputs and the mains.
+         * The system effect returns are added to the mains afterwards.
+         */
+        bool sysefxActive[NUM_SYS_EFX];
+        bool sysefxSilent[NUM_SYS_EFX]; // input, later output
+        for (nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
+        {
+            sysefxActive[nefx] = sysefx[nefx]->geteffect() && syseffEnable[nefx];
+            sysefxSilent[nefx] = true;
+            if (sysefxActive[nefx])
+            {
+                memset(sysefxInl[nefx].get(), 0, sent_bufferbytes);
+                memset(sysefxInr[nefx].get(), 0, sent_bufferbytes);
+            }
+        }
+        bool mainSilent = true;
 
-        // Apply the part volumes and pannings (after insertion effects)
         uchar panLaw = Runtime.panLaw;
         for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
         {
             if (!partLocal[npart])
+            {
+                if (part[npart]->Paudiodest & 2)
+                {   // silent, but may still be connected
+                    memset(outl[npart], 0, sent_bufferbytes);
+                    memset(outr[npart], 0, sent_bufferbytes);
+                }
+                VUpeak.values.parts[npart] = -1.0f;
+                VUpeak.values.partsR[npart] = -1.0f;
                 continue;
+            }
+            Part& thisPart = *part[npart];
 
-            float Step = ControlStep;
-            for (int i = 0; i < sent_buffersize; ++i)
+            if (partSilent[npart])
+            {   // keep volume/panning smoothing going, but there's nothing to scale
+                rampPartGain(thisPart, panLaw);
+                if (thisPart.Paudiodest & 2)
+                {
+                    memset(outl[npart], 0, sent_bufferbytes);
+                    memset(outr[npart], 0, sent_bufferbytes);
+                }
+                continue;
+            }
+            mix::PartRouting route;
+            bool ramp = rampPartGain(thisPart, panLaw);
+            if (ramp)
             {
-                if (part[npart]->Ppanning - part[npart]->TransPanning > Step)
-                    part[npart]->checkPanning(Step, panLaw);
-                else if (part[npart]->TransPanning - part[npart]->Ppanning > Step)
-                    part[npart]->checkPanning(-Step, panLaw);
-                if (part[npart]->Pvolume - part[npart]->TransVolume > Step)
-                    part[npart]->checkVolume(Step);
-                else if (part[npart]->TransVolume - part[npart]->Pvolume > Step)
-                    part[npart]->checkVolume(-Step);
-                part[npart]->partoutl[i] *= (part[npart]->pannedVolLeft() * part[npart]->ctl->expression.relvolume);
-                part[npart]->partoutr[i] *= (part[npart]->pannedVolRight() * part[npart]->ctl->expression.relvolume);
+                route.rampL = mixGainl.get();
+                route.rampR = mixGainr.get();
             }
-
-        }
-        // System effects
-        for (nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
-        {
-            if (!sysefx[nefx]->geteffect())
-                continue; // is disabled
-
-            // Clear the samples used by the system effects
-            memset(tmpmixl.get(), 0, sent_bufferbytes);
-            memset(tmpmixr.get(), 0, sent_bufferbytes);
-            if (!syseffEnable[nefx])
-                continue; // is off
-
-            // Mix the channels according to the part settings about System Effect
-            for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+            else
             {
-                if (partLocal[npart]               // it's enabled
-                 && Psysefxvol[nefx][npart]        // it's sending an output
-                 && (part[npart]->Paudiodest & 1)) // it's connected to the main outs
+                route.gainL = thisPart.pannedVolLeft() * thisPart.ctl->expression.relvolume;
+                route.gainR = thisPart.pannedVolRight() * thisPart.ctl->expression.relvolume;
+            }
+            if (thisPart.Paudiodest & 2)
+            {   // separate part output
+                route.directL = outl[npart];
+                route.directR = outr[npart];
+            }
+            if (thisPart.Paudiodest & 1)
+            {   // connected to the main outs
+                mainSilent = false;
+                route.mainL = mainL;
+                route.mainR = mainR;
+                for (nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
                 {
-                    // the output volume of each part to system effect
-                    float vol = sysefxvol[nefx][npart];
-                    for (int i = 0; i < sent_buffersize; ++i)
-                    {
-                        tmpmixl[i] += part[npart]->partoutl[i] * vol;
-                        tmpmixr[i] += part[npart]->partoutr[i] * vol;
+                    if (sysefxActive[nefx] && Psysefxvol[nefx][npart])
+                    {   // the output volume of each part to system effect
+                        route.sendL[route.sends] = sysefxInl[nefx].get();
+                        route.sendR[route.sends] = sysefxInr[nefx].get();
+                        route.sendVol[route.sends] = sysefxvol[nefx][npart];
+                        ++route.sends;
+                        sysefxSilent[nefx] = false;
                     }
                 }
             }
+            if (ramp)
+                mix::part<true>(thisPart.partoutl.get(), thisPart.partoutr.get(), route
+                               ,VUpeak.values.parts[npart], VUpeak.values.partsR[npart], sent_buffersize);
+            else
+                mix::part<false>(thisPart.partoutl.get(), thisPart.partoutr.get(), route
+                                ,VUpeak.values.parts[npart], VUpeak.values.partsR[npart], sent_buffersize);
+        }
+
+        mark = profiler.lap(DSPProfiler::mixing, mark);
+
+        // System effects
+        for (nefx = 0; nefx < NUM_SYS_EFX; ++nefx)
+        {
+            if (!sysefxActive[nefx])
+                continue; // is disabled or off
+            float* efxInL = sysefxInl[nefx].get();
+            float* efxInR = sysefxInr[nefx].get();
 
             // system effect send to next ones
             for (int nefxfrom = 0; nefxfrom < nefx; ++nefxfrom)
             {
                 if (!syseffEnable[nefxfrom])
                     continue; // is off
-                if (Psysefxsend[nefxfrom][nefx])
+                if (Psysefxsend[nefxfrom][nefx] && !(sysefxActive[nefxfrom] && sysefxSilent[nefxfrom]))
                 {
                     float v = sysefxsend[nefxfrom][nefx];
-                    for (int i = 0; i < sent_buffersize; ++i)
-                    {
-                        tmpmixl[i] += sysefx[nefxfrom]->efxoutl[i] * v;
-                        tmpmixr[i] += sysefx[nefxfrom]->efxoutr[i] * v;
-                    }
+                    mix::addScaled(efxInL, sysefx[nefxfrom]->efxoutl.get(), v, sent_buffersize);
+                    mix::addScaled(efxInR, sysefx[nefxfrom]->efxoutr.get(), v, sent_buffersize);
+                    sysefxSilent[nefx] = false;
                 }
             }
-            sysefx[nefx]->out(tmpmixl.get(), tmpmixr.get());
+            sysefxSilent[nefx] = sysefx[nefx]->out(efxInL, efxInR, sysefxSilent[nefx]);
+            if (sysefxSilent[nefx])
+                continue; // decayed, nothing to add
 
             // Add the System Effect to sound output
+            mainSilent = false;
             float outvol = sysefx[nefx]->sysefxgetvolume();
-            for (int i = 0; i < sent_buffersize; ++i)
-            {
-                mainL[i] += tmpmixl[i] * outvol;
-                mainR[i] += tmpmixr[i] * outvol;
-            }
+            mix::addScaled(mainL, efxInL, outvol, sent_buffersize);
+            mix::addScaled(mainR, efxInR, outvol, sent_buffersize);
         }
 
-        for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
-        {
-            if (part[npart]->Paudiodest & 2){    // Copy separate parts
-
-                for (int i = 0; i < sent_buffersize; ++i)
-                {
-                    outl[npart][i] = part[npart]->partoutl[i];
-                    outr[npart][i] = part[npart]->partoutr[i];
-                }
-            }
-            if (part[npart]->Paudiodest & 1)    // Mix wanted parts to mains
-            {
-                for (int i = 0; i < sent_buffersize; ++i)
-                {   // the volume did not change
-                    mainL[i] += part[npart]->partoutl[i];
-                    mainR[i] += part[npart]->partoutr[i];
-                }
-            }
-        }
+        mark = profiler.lap(DSPProfiler::systemEffects, mark);
 
         // Insertion effects for Master Out
         for (nefx = 0; nefx < NUM_INS_EFX; ++nefx)
         {
             if (Pinsparts[nefx] == -2)
-                insefx[nefx]->out(mainL, mainR);
+                mainSilent = insefx[nefx]->out(mainL, mainR, mainSilent);
         }
+        mark = profiler.lap(DSPProfiler::insertEffects, mark);
 
         // Master volume, and all output fade
         float cStep = ControlStep;
-        for (int idx = 0; idx < sent_buffersize; ++idx)
+        mix::Meter mainMeter{VUpeak.values.vuOutPeakL, VUpeak.values.vuOutPeakR
+                            ,VUpeak.values.vuRmsPeakL, VUpeak.values.vuRmsPeakR};
+        bool fading = (sound == _SYS_::mute::Fading); // fadeLevel must also have been set
+        if (!fading && !(Pvolume - TransVolume > cStep) && !(TransVolume - Pvolume > cStep))
+        {   // settled: volume, mono and metering in one pass
+            mix::master(mainL, mainR, volume, masterMono, sent_buffersize, mainMeter);
+        }
+        else
         {
-            if (Pvolume - TransVolume > cStep)
-            {
-                TransVolume += cStep;
-                volume = decibel<-40>(1.0f - TransVolume/96.0f);
-            }
-            else if (TransVolume - Pvolume > cStep)
+            for (int idx = 0; idx < sent_buffersize; ++idx)
             {
-                TransVolume -= cStep;
-                volume = decibel<-40>(1.0f - TransVolume/96.0f);
-            }
-            mainL[idx] *= volume; // apply Master Volume
-            mainR[idx] *= volume;
-            if (sound == _SYS_::mute::Fading) // fadeLevel must also have been set
-            {
-                for (uint npart = 0; npart < (Runtime.numAvailableParts); ++npart)
+                if (Pvolume - TransVolume > cStep)
                 {
-                    if (part[npart]->Paudiodest & 2)
-                    {
-                        outl[npart][idx] *= fadeLevel;
-                        outr[npart][idx] *= fadeLevel;
-                    }
+                    TransVolume += cStep;
+                    volume = decibel<-40>(1.0f - TransVolume/96.0f);
                 }
-                mainL[idx] *= fadeLevel;
-                mainR[idx] *= fadeLevel;
-                fadeLevel -= fadeStep;
-            }
-            if (masterMono)
-                mainL[idx] = mainR[idx] = (mainL[idx] + mainR[idx]) / 2.0;
-        }
-
-        // Peak calculation for mixed outputs
-        float absval;
-        for (int idx = 0; idx < sent_buffersize; ++idx)
-        {
-            if ((absval = fabsf(mainL[idx])) > VUpeak.values.vuOutPeakL)
-                VUpeak.values.vuOutPeakL = absval;
-            if ((absval = fabsf(mainR[idx])) > VUpeak.values.vuOutPeakR)
-                VUpeak.values.vuOutPeakR = absval;
-
-            // RMS Peak
-            VUpeak.values.vuRmsPeakL += mainL[idx] * mainL[idx];
-            VUpeak.values.vuRmsPeakR += mainR[idx] * mainR[idx];
-        }
-
-        // Peak computation for part vu meters
-        for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
-        {
-            if (partLocal[npart])
-            {
-                for (int idx = 0; idx < sent_buffersize; ++idx)
+                else if (TransVolume - Pvolume > cStep)
+                {
+                    TransVolume -= cStep;
+                    volume = decibel<-40>(1.0f - TransVolume/96.0f);
+                }
+                mainL[idx] *= volume; // apply Master Volume
+                mainR[idx] *= volume;
+                if (fading)
                 {
-                    if ((absval = fabsf(part[npart]->partoutl[idx])) > VUpeak.values.parts[npart])
-                        VUpeak.values.parts[npart] = absval;
-                    if ((absval = fabsf(part[npart]->partoutr[idx])) > VUpeak.values.partsR[npart])
-                        VUpeak.values.partsR[npart] = absval;
+                    mainL[idx] *= fadeLevel;
+                    mainR[idx] *= fadeLevel;
+                    mixGainl[idx] = fadeLevel;
+                    fadeLevel -= fadeStep;
                 }
+                if (masterMono)
+                    mainL[idx] = mainR[idx] = (mainL[idx] + mainR[idx]) * 0.5f;
             }
-            else
+            if (fading)
             {
-                VUpeak.values.parts[npart] = -1.0f;
-                VUpeak.values.partsR[npart] = -1.0f;
+                for (uint npart = 0; npart < Runtime.numAvailableParts; ++npart)
+                {
+                    if (part[npart]->Paudiodest & 2)
+                        mix::applyRamp(outl[npart], outr[npart], mixGainl.get(), mixGainl.get(), sent_buffersize);
+                }
             }
+            mix::meter(mainL, mainR, sent_buffersize, mainMeter);
         }
 
         VUcount += sent_buffersize;
@@ -2413,8 +2860,10 @@ int SynthEngine::MasterAudio(float *outl [NUM_MIDI_PARTS + 1], float *outr [NUM_
             }
         }
 
+        profiler.lap(DSPProfiler::mixing, mark);
         LFOtime += sent_buffersize; // update the LFO's time
     }
+    profiler.endCycle(sent_buffersize, samplerate);
     return sent_buffersize;
 }
 
@@ -2475,6 +2924,26 @@ void SynthEngine::fetchMeterData()
 
 
 // Parameter control
+void SynthEngine::setNoteCull()
+{
+    noteCull.set(Runtime.noteCullLevel, Runtime.noteCullTime, samplerate);
+}
+
+
+/* Parse all instruments of the bank in the background (when enabled),
+ * so that program changes within this bank find them in memory. */
+void SynthEngine::preloadBank(size_t rootID, size_t bankID)
+{
+    if (not Runtime.instrumentPreload)
+        return;
+    vector<string> files;
+    for (uint slot = 0; slot < MAX_INSTRUMENTS_IN_BANK; ++slot)
+        if (not bank.emptyslot(rootID, bankID, slot))
+            files.push_back(bank.getFullPath(rootID, bankID, slot));
+    instrumentCache.preload(std::move(files));
+}
+
+
 void SynthEngine::setPvolume(float control_value)
 {
     Pvolume = control_value;
@@ -37,10 +37,17 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <atomic>
+#include <limits>
+#include <mutex>
 
 #include "Misc/RandomGen.h"
+#include "Misc/RenderPool.h"
+#include "Misc/DSPProfiler.h"
 #include "Misc/Microtonal.h"
 #include "Misc/Bank.h"
+#include "Misc/InstrumentCache.h"
+#include "Synth/NoteCull.h"
 #include "DSP/FFTwrapper.h"
 #include "Interface/InterChange.h"
 #include "Interface/MidiLearn.h"
@@ -125,7 +132,10 @@ class SynthEngine
         int  setRootBank(int root, int bank, bool inplace = false);
         int  setProgramByName(CommandBlock&);
         int  setProgramFromBank(CommandBlock&, bool inplace = false);
-        bool setProgram(string const& fname, int npart);
+        bool setProgram(string const& fname, int npart, bool inPlace = false);
+        void guiBindsPart(int npart);     // GUI editors are about to take the parameter objects
+        void guiReleasesPart(int npart);  // GUI editors no longer refer to any of them
+        void disposeReleasedInstruments(); // from a non-audio thread, after in place program changes
         int  ReadBankRoot();
         int  ReadBank();
         void SetPartChanForVector(uchar npart, uchar nchan);
@@ -240,6 +250,12 @@ class SynthEngine
         Controller* ctl;
         Microtonal microtonal;
         unique_ptr<fft::Calc> fft;
+        unique_ptr<RenderPool> renderPool;
+        DSPProfiler profiler;
+        NoteCull::Setting noteCull;
+        void setNoteCull();
+        InstrumentCache instrumentCache;
+        void preloadBank(size_t rootID, size_t bankID);
         TextMsgBuffer& textMsgBuffer;
 
         // peaks for VU-meters
@@ -290,6 +306,12 @@ class SynthEngine
         float sysefxvol[NUM_SYS_EFX][NUM_MIDI_PARTS];
         float sysefxsend[NUM_SYS_EFX][NUM_SYS_EFX];
 
+        Samples sysefxInl[NUM_SYS_EFX]; // sum of all sends into each system effect
+        Samples sysefxInr[NUM_SYS_EFX];
+        Samples mixGainl;               // per sample gains while a part fades
+        Samples mixGainr;
+        bool rampPartGain(Part&, uchar panLaw);
+
         int keyshift;
 
     public:
@@ -310,11 +332,55 @@ class SynthEngine
         float bpm;           // used by Echo Effect
         bool  bpmAccurate;   // Set to false by engines that can't provide an accurate BPM value.
 
+        // gapless program change, see setProgram()
+        struct ShadowPart
+        {
+            std::unique_ptr<Part> part; // first the loaded instrument, after the swap the former one
+            uint generation{0};         // of the former instrument
+            ShadowPart* next{nullptr};  // when released by the audio thread
+        };
+        struct InstrumentSwap
+        {
+            static constexpr uint UNBOUND = std::numeric_limits<uint>::max();
+
+            std::atomic<ShadowPart*> loaded{nullptr}; // handed over to the audio thread
+            std::atomic<bool>  done{false};           // has been swapped in
+            std::atomic_flag   busy = ATOMIC_FLAG_INIT; // swap in progress
+            ShadowPart* ringing{nullptr};             // former instrument, while its notes and effects ring out
+            std::atomic<uint> generation{0};          // counts the instruments swapped in
+            std::atomic<uint> guiGeneration{UNBOUND}; // GUI editors may refer to this and later instruments
+            std::atomic<uint32_t> seed{0};            // for loading the next instrument
+        };
+        InstrumentSwap instrumentSwap[NUM_MIDI_PARTS];
+        std::atomic<ShadowPart*> released;          // former instruments no longer playing
+        std::list<std::unique_ptr<ShadowPart>> awaitingGui;
+        std::mutex programLoad;
+        std::mutex releasing;                       // guards awaitingGui
+        int programSwapTime;                        // ms from loaded to swapped in, for Runtime.showTimes
+        void swapLoadedInstruments();
+        void takeInstrument(int npart, ShadowPart* loaded);
+        void releaseShadow(ShadowPart*);
+        void deleteReleasedShadows();
+
 
         RandomGen prng;
+
+        // parts computed by the RenderPool draw from their own PRNG
+        RandomGen& activePrng()
+        {
+            RenderPool::Context* context = RenderPool::current();
+            return context? *context->prng : prng;
+        }
     public:
-        float numRandom()   { return prng.numRandom(); }
-        uint32_t randomINT(){ return prng.randomINT(); }   // random number in the range 0...INT_MAX
+        float numRandom()   { return activePrng().numRandom(); }
+        uint32_t randomINT(){ return activePrng().randomINT(); }   // random number in the range 0...INT_MAX
+
+        // intermediary buffers for the thread computing notes and parts
+        ScratchBuffers& scratch()
+        {
+            RenderPool::Context* context = RenderPool::current();
+            return context and context->scratch? *context->scratch : Runtime.genScratch;
+        }
         void setReproducibleState(int value);
         void swapTestPADtable();
 };
@@ -0,0 +1,282 @@
+/*
+    TestBenchmark.h - timing the SynthEngine on a fixed set of scenarios
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+
+#include "Misc/SynthEngine.h"
+#include "Misc/Part.h"
+#include "Misc/FileMgrFuncs.h"
+#include "Misc/FormatFuncs.h"
+#include "Effects/EffectMgr.h"
+#include "Params/SUBnoteParameters.h"
+#include "Misc/Alloc.h"
+
+
+namespace test {
+
+using std::string;
+using std::vector;
+
+/* Renders a fixed corpus of instruments from the distributed banks, each
+ * stressing one part of the engine, at several buffer sizes and levels of
+ * polyphony. For each combination, the time per sample and the number of
+ * voices one core could sustain in real time are logged and written as
+ * tab separated lines into the results file:
+ *
+ *   scenario  buffersize  polyphony  ns/sample  voices/core
+ *
+ * When a baseline (a results file from an earlier run) is given, each result
+ * slower than the baseline by more than the threshold is reported as regression;
+ * a case found only in the baseline or only in the results is a failure as well.
+ * Launched through the CLI test context, like the TestInvoker sound calculation.
+ */
+class Benchmark
+{
+    public:
+        struct Result
+        {
+            string scenario;
+            size_t buffersize;
+            size_t polyphony;
+            double nsPerSample;
+            double voicesPerCore;
+        };
+
+    private:
+        enum Setup
+        {
+            AS_LOADED,
+            EFFECTS,                 // with all system and two insertion effects
+            FULL_BANK,               // SUBnote with all harmonics and filter stages, stereo
+        };
+
+        struct Scenario
+        {
+            const char* name;
+            const char* instrument;  // relative to the bank root
+            Setup setup;
+        };
+
+        static constexpr Scenario SCENARIOS[] = {
+            {"adsynth",  "SynthPiano/0111-Grand Piano v3.xiz",                  AS_LOADED},
+            {"subsynth", "Will_Godfrey_Companion/0069-Multi Rushes.xiz",        AS_LOADED},
+            {"subbank",  "Will_Godfrey_Companion/0069-Multi Rushes.xiz",        FULL_BANK},
+            {"padsynth", "Will_Godfrey_Companion/0084-Cathedral Pipe Organ.xiz",AS_LOADED},
+            {"effects",  "Pads/0001-Sine Pad.xiz",                              EFFECTS  },
+        };
+        static constexpr size_t BUFFERSIZES[] = {64, 256, 1024};
+        static constexpr size_t VOICES[]      = {1, 8, 32};
+
+        SynthEngine& synth;
+        string corpus;
+        float  duration;
+
+    public:
+        Benchmark(SynthEngine& synth_, string const& corpusDir, float duration_)
+            : synth{synth_}
+            , corpus{findCorpus(corpusDir)}
+            , duration{duration_}
+        { }
+
+        vector<Result> run()
+        {
+            vector<Result> results;
+            if (corpus.empty())
+            {
+                log("no bank corpus found");
+                return results;
+            }
+            for (Scenario const& scenario : SCENARIOS)
+            {
+                if (not prepare(scenario))
+                    continue;
+                for (size_t buffersize : BUFFERSIZES)
+                {
+                    if (buffersize > size_t(synth.buffersize))
+                    {   // can only compute up to the engine's buffersize per call
+                        log(string{"skipping "} + scenario.name + " buffer " + func::asString(buffersize)
+                           + ", engine buffersize is " + func::asString(synth.buffersize));
+                        continue;
+                    }
+                    for (size_t polyphony : VOICES)
+                    {
+                        results.push_back(measure(scenario.name, buffersize, polyphony));
+                        Result const& r = results.back();
+                        log(string{r.scenario} + " buffer " + func::asString(r.buffersize)
+                           + " voices " + func::asString(r.polyphony)
+                           + " speed " + func::asCompactString(r.nsPerSample) + " ns/Sample"
+                           + " capacity " + func::asCompactString(r.voicesPerCore) + " voices/core");
+                    }
+                }
+            }
+            return results;
+        }
+
+        static bool write(vector<Result> const& results, string const& filename)
+        {
+            std::ofstream out{filename, std::ios_base::trunc};
+            for (Result const& r : results)
+                out << r.scenario << '\t' << r.buffersize << '\t' << r.polyphony << '\t'
+                    << r.nsPerSample << '\t' << r.voicesPerCore << '\n';
+            return out.good();
+        }
+
+        /* return the number of failures: results slower than the baseline by more
+         * than threshold, and cases missing on either side */
+        size_t compare(vector<Result> const& results, string const& baselineFile, float threshold)
+        {
+            std::map<string, double> baseline;
+            std::ifstream in{baselineFile};
+            if (not in)
+            {
+                log("can not read baseline \"" + baselineFile + "\"");
+                return 0;
+            }
+            string line;
+            while (std::getline(in, line))
+            {
+                std::istringstream fields{line};
+                Result r;
+                if (fields >> r.scenario >> r.buffersize >> r.polyphony >> r.nsPerSample)
+                    baseline[key(r)] = r.nsPerSample;
+            }
+            size_t regressions = 0;
+            size_t missing = 0;
+            std::set<string> measured;
+            for (Result const& r : results)
+            {
+                measured.insert(key(r));
+                auto found = baseline.find(key(r));
+                if (found == baseline.end() or found->second <= 0)
+                {
+                    ++missing;
+                    log("MISSING " + key(r) + " has no baseline entry");
+                    continue;
+                }
+                double change = r.nsPerSample / found->second - 1.0;
+                if (change > threshold)
+                {
+                    ++regressions;
+                    log("REGRESSION " + key(r) + " slower by " + func::asCompactString(float(change * 100)) + "%");
+                }
+            }
+            for (auto const& entry : baseline)
+                if (not measured.count(entry.first))
+                {
+                    ++missing;
+                    log("MISSING " + entry.first + " in the baseline, but not measured");
+                }
+            log("regressions " + func::asString(regressions) + " missing " + func::asString(missing)
+               + " threshold " + func::asCompactString(threshold * 100) + "% against \"" + baselineFile + "\"");
+            return regressions + missing;
+        }
+
+    private:
+        void log(string const& msg) { synth.getRuntime().Log("TEST::Benchmark " + msg); }
+
+        static string key(Result const& r)
+        {
+            return r.scenario + "/" + func::asString(r.buffersize) + "/" + func::asString(r.polyphony);
+        }
+
+        static string findCorpus(string const& given)
+        {
+            string candidates[] = {given, file::extendLocalPath("/banks"),
+                                   "/usr/share/yoshimi/banks", "/usr/local/share/yoshimi/banks"};
+            for (string const& dir : candidates)
+                if (not dir.empty() and file::isDirectory(dir))
+                    return dir;
+            return "";
+        }
+
+        /* a clean engine with just the scenario instrument in part 1 */
+        bool prepare(Scenario const& scenario)
+        {
+            synth.defaults();
+            string instrument = corpus + "/" + scenario.instrument;
+            if (not synth.part[0]->loadXML(instrument))
+            {
+                log("can not load \"" + instrument + "\", skipping " + scenario.name);
+                return false;
+            }
+            if (scenario.setup == EFFECTS)
+            {
+                int type = EFFECT::type::reverb - EFFECT::type::none;
+                for (int nefx = 0; nefx < NUM_SYS_EFX; ++nefx, ++type)
+                {
+                    synth.sysefx[nefx]->changeeffect(type); // reverb, echo, chorus, phaser
+                    synth.setPsysefxvol(0, nefx, 100);
+                }
+                synth.insefx[0]->changeeffect(EFFECT::type::distortion - EFFECT::type::none);
+                synth.insefx[1]->changeeffect(EFFECT::type::dynFilter - EFFECT::type::none);
+                synth.Pinsparts[0] = synth.Pinsparts[1] = 0;
+            }
+            if (scenario.setup == FULL_BANK)
+            {   // the biquad bank at its widest: 64 chains of 5 sections per channel
+                Part::KitItem& kit = synth.part[0]->kit[0];
+                kit.Psubenabled = true;
+                for (int n = 0; n < MAX_SUB_HARMONICS; ++n)
+                    kit.subpars->Phmag[n] = 100;
+                kit.subpars->Pnumstages = 5;
+                kit.subpars->Pstereo = true;
+            }
+            synth.setReproducibleState(0); // also builds PAD wavetables
+            return true;
+        }
+
+        Result measure(string const& name, size_t buffersize, size_t polyphony)
+        {
+            Samples buffer{2 * (NUM_MIDI_PARTS + 1) * buffersize};
+            float* buffL[NUM_MIDI_PARTS + 1];
+            float* buffR[NUM_MIDI_PARTS + 1];
+            for (size_t i = 0; i <= NUM_MIDI_PARTS; ++i)
+            {
+                buffL[i] = &buffer[(2 * i    ) * buffersize];
+                buffR[i] = &buffer[(2 * i + 1) * buffersize];
+            }
+            synth.setReproducibleState(0);
+            for (size_t v = 0; v < polyphony; ++v)
+                synth.NoteOn(0, 36 + (v * 7) % 72, 100); // stacked fifths over 6 octaves
+
+            size_t cycles = size_t(ceilf(duration * synth.samplerate / buffersize));
+            size_t samples = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t c = 0; c < cycles; ++c)
+                samples += synth.MasterAudio(buffL, buffR, int(buffersize));
+            double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            synth.ShutUp();
+
+            double nsPerSample = samples? nanos / samples : 0;
+            double realtime = nsPerSample > 0? 1e9 / (synth.samplerate * nsPerSample) : 0;
+            return Result{name, buffersize, polyphony, nsPerSample, polyphony * realtime};
+        }
+};
+
+}// namespace test
+#endif /*TEST_BENCHMARK_H*/
@@ -35,6 +35,8 @@
 #include <ctime>
 
 #include "Misc/TestSequence.h"
+#include "Misc/TestBenchmark.h"
+#include "Misc/TestKernels.h"
 #include "Misc/SynthEngine.h"
 #include "Misc/CliFuncs.h"
 #include "Misc/Alloc.h"
@@ -190,6 +192,17 @@ namespace { // local implementation details
         return name;
     }
 
+    inline string getPath(string cliInput)
+    {
+        string path;
+        for (char c : cliInput)
+        {
+            if (::isspace(c)) break;
+            path += c;
+        }
+        return path;
+    }
+
     /* Bounce the resulting MIDI note when repeating a scale step up or down.
      * At the end of the value range, this sequence proceeds mirrored downwards:
      * 0..127,126..1,0..127... */
@@ -216,6 +229,7 @@ namespace { // local implementation details
 class TestInvoker
 {
     midiVal chan;            // MIDI channel (1..16)
+    int    channels;         // number of consecutive MIDI channels to play each test note on
     midiVal pitch;           // MIDI note
     midiVal velocity;
     float  duration;         // in seconds; overall extension of the individual test calculation
@@ -227,6 +241,11 @@ class TestInvoker
     float  swapWave;         // capture secondary PAD-wavetable and swap it after that offset time(fraction)
     size_t chunksize;        // number of samples to calculate at once. Note: < SynthEngine.buffersize
     string targetFilename;   // RAW file to write generated samples; "" => just calculate, don't write to file
+    string benchmarkFile;    // run the benchmark suite instead and write results here
+    string baselineFile;     // results of an earlier benchmark run to compare with
+    float  threshold;        // slowdown against the baseline reported as regression
+    string corpusDir;        // bank root holding the benchmark instruments; "" => search
+    int    kernelRounds;     // check the vectorised kernels against the scalar code; 0 => off
 
     size_t smpCnt;
 
@@ -235,6 +254,7 @@ class TestInvoker
 
     TestInvoker() :
         chan{1},
+        channels{1},
         pitch{60},       // C4
         velocity{64},
         duration{1.0},   // 1sec
@@ -246,6 +266,11 @@ class TestInvoker
         swapWave{0.0},
         chunksize{0},    // 0 means: initialise to SynthEngine.buffersize
         targetFilename{""},
+        benchmarkFile{""},
+        baselineFile{""},
+        threshold{0.1},
+        corpusDir{""},
+        kernelRounds{0},
         smpCnt{0}
     { }
 
@@ -277,6 +302,7 @@ class TestInvoker
                                            //--------------------------------+cmdID--------+descriptive-name----+default+min+max--+converter-func-----
             return doTreatParameter<midiVal>(operation, this->pitch,         "note",       "MIDI Note",              60,   0,127,  string2int127,       input, response)
                 || doTreatParameter<midiVal>(operation, this->chan,          "channel",    "MIDI Channel",            1,   1, 16,  limited(1,16),       input, response)
+                || doTreatParameter<int>    (operation, this->channels,      "parts",      "Parallel channels",       1,   1, 16,  limited(1,16),       input, response)
                 || doTreatParameter<midiVal>(operation, this->velocity,      "velocity",   "MIDI Velocity",          64,   0,127,  string2int127,       input, response)
                 || doTreatParameter<float>  (operation, this->duration,      "duration",   "Overall duration(secs)",1.0,   0, 10,  limited(0.01f,10.0f),input, response)
                 || doTreatParameter<float>  (operation, this->holdfraction,  "holdfraction","Note hold (fraction)", 0.8,   0,1.0,  limited(0.1f,1.0f),  input, response)
@@ -287,6 +313,11 @@ class TestInvoker
                 || doTreatParameter<float>  (operation, this->swapWave,      "swapwave",   "Swap PADtable after",   0.0,   0,0.9,  limited(0.0f,0.9f),  input, response)
                 || doTreatParameter<size_t> (operation, this->chunksize,     "buffersize", "Smps per call",        bfsz,   1,bfsz, limited(1,bfsz),     input, response)
                 || doTreatParameter<string> (operation, this->targetFilename,"target",     "Target RAW-filename",    "",  "","?",  getFilename,         input, response)
+                || doTreatParameter<string> (operation, this->benchmarkFile, "benchmark",  "Benchmark results file", "",  "","?",  getPath,             input, response)
+                || doTreatParameter<string> (operation, this->baselineFile,  "baseline",   "Benchmark baseline file","",  "","?",  getPath,             input, response)
+                || doTreatParameter<float>  (operation, this->threshold,     "threshold",  "Regression threshold", 0.1,   0,1.0,  limited(0.0f,1.0f),  input, response)
+                || doTreatParameter<string> (operation, this->corpusDir,     "corpus",     "Benchmark bank root",    "",  "","?",  getPath,             input, response)
+                || doTreatParameter<int>    (operation, this->kernelRounds,  "kernels",    "Kernel check rounds",     0,   0,10000,limited(0,10000),   input, response)
                  ;
         }
 
@@ -298,6 +329,7 @@ class TestInvoker
                      + (repetitions > 1? asString(repetitions)+"·":"")
                      + asMidiNoteString(pitch)
                      + (repetitions == 1? "" : scalestep==0? "" : " "+asString(scalestep) + (scalestep > 0? "⤴":"⤵"))
+                     + (channels > 1? " ×"+asString(channels):"")
                      + " "+(duration < 1.0? asCompactString(duration*1000)+"ms" : asCompactString(duration)+"s")
                      + (aOffset or aHold? " +("+percent(aOffset)+"/"+percent(aHold)+")":"")
                      + (swapWave? " swap("+percent(swapWave)+")!":"")
@@ -312,6 +344,7 @@ class TestInvoker
                                                            )
                                                          : asMidiNoteString(pitch))
                      + " on Ch."+asString(int(chan))
+                     + (channels > 1? "+"+asString(channels-1):"")
                      + (velocity!=64? " vel."+asString(int(velocity)):"")
                      + (repetitions > 1? " each ":" for ")
                      + (duration < 1.0? asCompactString(duration*1000)+"ms" : asCompactString(duration)+"s")
@@ -350,10 +383,54 @@ class TestInvoker
                                   +" notes "+asString(repetitions)
                                   +" buffer "+asString(chunksize)
                                   +" rate "+asString(synth.samplerate)
+                                  +" parts "+asString(channels)
+                                  +" threads "+asString(synth.renderPool? synth.renderPool->workers() : 0)
                                   );
             output.maybeWrite();
         }
 
+        bool benchmarkRequested()  const { return not benchmarkFile.empty(); }
+        bool kernelCheckRequested() const { return kernelRounds > 0; }
+
+        /* Alternative test run: compare the vectorised unison kernels
+         * bit by bit against the former scalar code (see TestKernels.h).
+         */
+        void performKernelCheck(SynthEngine& synth)
+        {
+            synth.getRuntime().Log("TEST::Kernels Launch");
+            KernelCheck check;
+            size_t failed = check.run(size_t(kernelRounds));
+            if (failed)
+                synth.getRuntime().Log("TEST::Kernels mismatch: " + check.failure);
+            synth.getRuntime().Log(string{"TEST::Kernels "}
+                                  +(failed? "FAILED" : "Complete")
+                                  +" kernel "+check.kernel()
+                                  +" rounds "+asString(kernelRounds)
+                                  +" failed "+asString(failed)
+                                  );
+        }
+
+        /* Alternative test run: time the benchmark scenarios (see TestBenchmark.h)
+         * for the current test duration each, write the results and possibly
+         * check them against a baseline.
+         */
+        void performBenchmark(SynthEngine& synth)
+        {
+            synth.getRuntime().Log("TEST::Benchmark Launch");
+            Benchmark bench{synth, corpusDir, duration};
+            auto results = bench.run();
+            if (not Benchmark::write(results, benchmarkFile))
+                synth.getRuntime().Log("TEST::Benchmark failed to write \"" + benchmarkFile + "\"");
+            size_t failures = baselineFile.empty()? 0 : bench.compare(results, baselineFile, threshold);
+            synth.getRuntime().Log(string{"TEST::Benchmark "}
+                                  +(failures? "FAILED" : "Complete")
+                                  +" results "+asString(results.size())
+                                  +(baselineFile.empty()? "" : " failures "+asString(failures))
+                                  +" rate "+asString(synth.samplerate)
+                                  +" threads "+asString(synth.renderPool? synth.renderPool->workers() : 0)
+                                  );
+        }
+
 
 
     private:
@@ -392,11 +469,13 @@ class TestInvoker
             TestSequence::Event noteOn =  [&, noteSlot]()
                                           {
                                               *noteSlot = noteScale();    //  draw next note from sequence
-                                              synth.NoteOn(chan-1, *noteSlot, velocity);
+                                              for (int c=0; c<channels; ++c)
+                                                  synth.NoteOn((chan-1+c) % NUM_MIDI_CHANNELS, *noteSlot, velocity);
                                           };
             TestSequence::Event noteOff = [&, noteSlot]()
                                           {
-                                              synth.NoteOff(chan-1, *noteSlot);
+                                              for (int c=0; c<channels; ++c)
+                                                  synth.NoteOff((chan-1+c) % NUM_MIDI_CHANNELS, *noteSlot);
                                           };
 
             testSeq.addNote(noteOn,noteOff, hold, offset);
@@ -503,7 +582,7 @@ inline bool TestInvoker::doTreatParameter(ParamOp operation, VAL& theParameter,
         switch (operation)
         {
             case SET:
-                if (input.isalnum() || '-' == input.peek() || '.' == input.peek())
+                if (input.isalnum() || '-' == input.peek() || '.' == input.peek() || '/' == input.peek())
                 {
                     resVal = parseVal(input);
                     input.skipChars();
@@ -0,0 +1,153 @@
+/*
+    TestKernels.h - check the vectorised inner loops against the scalar code
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef TEST_KERNELS_H
+#define TEST_KERNELS_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstring>
+
+#include "globals.h"
+#include "Synth/UnisonKernels.h"
+#include "Misc/FormatFuncs.h"
+
+
+namespace test {
+
+using std::string;
+using std::vector;
+
+/* The unison kernels (see UnisonKernels.h) promise results bit identical
+ * to the former scalar code. This check feeds random wavetables, phases,
+ * frequencies and buffer lengths both through the kernels selected for
+ * this CPU and through the scalar reference, and compares the output
+ * samples and the final phase bit by bit. The mixing loops are compared
+ * against the former per-channel loops in the same way. The references live
+ * in UnisonKernels.cpp, to be compiled with the same floating point flags.
+ * Launched through the CLI test context, like the TestInvoker sound calculation.
+ */
+class KernelCheck
+{
+        std::mt19937 rand;     // fixed seed => failures can be reproduced
+
+        size_t choose(size_t lo, size_t hi) { return std::uniform_int_distribution<size_t>{lo, hi}(rand); }
+        float  sample()   { return std::uniform_real_distribution<float>{-1.0f, 1.0f}(rand); }
+        float  fraction() { return std::uniform_real_distribution<float>{0.0f, 1.0f}(rand); }
+
+        static bool sameBits(vector<float> const& a, vector<float> const& b)
+        {
+            return a.size() == b.size()
+               and 0 == memcmp(a.data(), b.data(), a.size() * sizeof(float));
+        }
+
+        static bool sameBits(float a, float b) { return 0 == memcmp(&a, &b, sizeof(float)); }
+
+    public:
+        string failure;        // description of the first mismatch
+
+        KernelCheck()
+            : rand{0x5EED}
+            , failure{}
+        { }
+
+        const char* kernel() const { return unison::kernelName(); }
+
+        /* @return number of rounds with any mismatch */
+        size_t run(size_t rounds)
+        {
+            size_t failed = 0;
+            for (size_t r = 0; r < rounds; ++r)
+                if (not checkInterpolation(r) or not checkMixing(r))
+                    ++failed;
+            return failed;
+        }
+
+    private:
+        bool mismatch(size_t round, string what)
+        {
+            if (failure.empty())
+                failure = what + " (round " + func::asString(round) + ")";
+            return false;
+        }
+
+        bool checkInterpolation(size_t round)
+        {
+            size_t tableSize = size_t{1} << choose(8, 14);
+            vector<float> wave(tableSize + 1);
+            for (float& smp : wave)
+                smp = sample();
+            wave[tableSize] = wave[0];
+
+            int   freqhi = int(choose(0, tableSize / 2));
+            float freqlo = fraction();
+            if (freqlo >= 1.0f)
+                freqlo = 0.0f;
+            int   posHiVec = int(choose(0, tableSize - 1)), posHiRef = posHiVec;
+            float posLoVec = fraction(),                    posLoRef = posLoVec;
+            if (posLoVec >= 1.0f)
+                posLoVec = posLoRef = 0.0f;
+
+            size_t cnt = choose(1, 4096);
+            vector<float> outVec(cnt), outRef(cnt);
+            // several calls in sequence, as for consecutive buffers
+            for (int call = 0; call < 3; ++call)
+            {
+                unison::interpolateLinear      (wave.data(), tableSize, posHiVec, posLoVec, freqhi, freqlo, outVec.data(), cnt);
+                unison::interpolateLinearScalar(wave.data(), tableSize, posHiRef, posLoRef, freqhi, freqlo, outRef.data(), cnt);
+                if (not sameBits(outVec, outRef))
+                    return mismatch(round, "interpolation samples differ, table " + func::asString(tableSize)
+                                          + " buffer " + func::asString(cnt) + " step " + func::asString(freqhi));
+                if (posHiVec != posHiRef or not sameBits(posLoVec, posLoRef))
+                    return mismatch(round, "interpolation phase differs, table " + func::asString(tableSize)
+                                          + " buffer " + func::asString(cnt) + " step " + func::asString(freqhi));
+            }
+            return true;
+        }
+
+        bool checkMixing(size_t round)
+        {
+            size_t cnt = choose(1, 4096);
+            vector<float> smps(cnt), mixL(cnt), mixR(cnt);
+            for (size_t i = 0; i < cnt; ++i)
+            {
+                smps[i] = sample();
+                mixL[i] = sample();
+                mixR[i] = sample();
+            }
+            float gainL = sample(), gainR = sample();
+
+            vector<float> refL{mixL}, refR{mixR}, vecL{mixL}, vecR{mixR};
+            unison::mixStereo      (smps.data(), gainL, gainR, vecL.data(), vecR.data(), cnt);
+            unison::mixStereoScalar(smps.data(), gainL, gainR, refL.data(), refR.data(), cnt);
+            if (not sameBits(vecL, refL) or not sameBits(vecR, refR))
+                return mismatch(round, "stereo mix differs, buffer " + func::asString(cnt));
+
+            unison::mixMono      (smps.data(), vecL.data(), cnt);
+            unison::mixMonoScalar(smps.data(), refL.data(), cnt);
+            if (not sameBits(vecL, refL))
+                return mismatch(round, "mono mix differs, buffer " + func::asString(cnt));
+            return true;
+        }
+};
+
+}// namespace test
+#endif /*TEST_KERNELS_H*/
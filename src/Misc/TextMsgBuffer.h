@@ -2,6 +2,7 @@
     TextMsgBuffer.h
 
     Copyright 2014-2023, Will Godfrey, Ichthyostega
+    Copyright 2026, Will Godfrey & others
 
     This file is part of yoshimi, which is free software: you can
     redistribute it and/or modify it under the terms of the GNU General
@@ -24,12 +25,9 @@
 //#define REPORT_MISCMSG
 // for testing message list leaks
 
-//#define MAX_MSG
-// for finding out the most we actually use
-
-#include <list>
+#include <atomic>
 #include <string>
-#include <semaphore.h>
+#include <thread>
 #include <iostream>
 
 #include "globals.h"
@@ -43,7 +41,11 @@
  * the same 'live' ID, but if they do, the second one will get an
  * empty string.
  *
- * Both calls will block, but should be very quick;
+ * The IDs are positions in a fixed table of slots, each claimed and
+ * released by an atomic state change, thus neither call will block.
+ * The text storage of each slot is allocated up front, so pushing
+ * a text up to TEXT_RESERVE characters does not allocate; longer
+ * texts are still accepted, but counted as oversized.
  *
  * Normally a message will clear before the next one arrives so the
  * message numbers should remain very low even over multiple instances.
@@ -54,22 +56,42 @@
  */
 class TextMsgBuffer
 {
-        sem_t lock;
-        std::list<std::string> buffer;
+    public:
+        static constexpr size_t SLOTS        = NO_MSG;   // 255 (NO_MSG) denotes an invalid entry
+        static constexpr size_t TEXT_RESERVE = 512;
 
-        TextMsgBuffer()
-            : lock{}
-            , buffer{}
+        struct Stats
         {
-            sem_init(&lock, 0, 1);
-            initBuffer();
-        }
+            size_t full;        // push failed, as all slots were in use
+            size_t oversized;   // texts longer than TEXT_RESERVE
+            size_t leaked;      // messages never fetched, found by clear()
+            size_t highWater;   // highest slot ever used
+        };
+
+    private:
+        enum SlotState : uchar { FREE, WRITING, READY, READING };
 
-        ~TextMsgBuffer()
+        struct alignas(64) Slot
         {
-            sem_destroy(&lock);
+            std::atomic<uchar> state{FREE};
+            std::string text;
+        };
+
+        Slot slot[SLOTS];
+
+        std::atomic<size_t> cntFull{0};
+        std::atomic<size_t> cntOversized{0};
+        std::atomic<size_t> cntLeaked{0};
+        std::atomic<size_t> highWater{0};
+
+        TextMsgBuffer()
+        {
+            for (Slot& s : slot)
+                s.text.reserve(TEXT_RESERVE);
         }
 
+       ~TextMsgBuffer() = default;
+
     public:
         /* Meyer's Singleton */
         static TextMsgBuffer& instance()
@@ -77,125 +99,88 @@ class TextMsgBuffer
             static TextMsgBuffer singleton{};
             return singleton;
         }
-#ifdef MAX_MSG
-    int count;
-#endif
+
         void clear();
-        int push(std::string text);
+        int push(std::string const& text);
         std::string fetch(int pos, bool remove = true);
 
+        Stats stats()  const
+        {
+            return Stats{cntFull.load(), cntOversized.load(), cntLeaked.load(), highWater.load()};
+        }
+
     private:
-        void initBuffer();
+        bool claim(Slot& s, uchar from, uchar to)
+        {
+            uchar expected = from;
+            return s.state.compare_exchange_strong(expected, to, std::memory_order_acquire);
+        }
 };
 
 
-inline void TextMsgBuffer::initBuffer()
-{
-    for (int i = 0; i < NO_MSG; ++i)
-        buffer.push_back("");
-    /*
-     * We immediately fill the list, as we use the list position
-     * to provide the ID for reading. Therefore once it has been
-     * started entries can only be modified in-place not added
-     * or removed.
-     * We use 255 (NO_MSG) to denote an invalid entry.
-     */
-#ifdef MAX_MSG
-    count = 0;
-#endif
-}
-
-
 inline void TextMsgBuffer::clear()
 { // catches message leaks - Shirley knot :@)
+    size_t leaks = 0;
+    for (Slot& s : slot)
+        if (claim(s, READY, WRITING))
+        {
+            s.text.clear();
+            s.state.store(FREE, std::memory_order_release);
+            ++leaks;
+        }
+    cntLeaked += leaks;
 #ifdef REPORT_MISCMSG
-    std::cout << "TextMsgBuffer cleared" << std::endl;
-#endif
-    std::list<std::string>::iterator it = buffer.begin();
-    for (it = buffer.begin(); it != buffer.end(); ++it)
-        *it = "";
-#ifdef MAX_MSG
-    count = 0;
-    std::cout << "max " << count << std::endl;
+    std::cout << "TextMsgBuffer cleared, " << leaks << " leaked" << std::endl;
 #endif
 }
 
 
-inline int TextMsgBuffer::push(std::string _text)
+inline int TextMsgBuffer::push(std::string const& text)
 {
-    if (_text.empty())
+    if (text.empty())
         return NO_MSG;
-    sem_wait(&lock);
-
-    std::string text = _text;
-    std::list<std::string>::iterator it = buffer.begin();
-    int idx = 0;
-
-    while (it != buffer.end())
+    for (size_t idx = 0; idx < SLOTS; ++idx)
     {
-        if (*it == "")
-        {
-            *it = text;
+        Slot& s = slot[idx];
+        if (s.state.load(std::memory_order_relaxed) != FREE or not claim(s, FREE, WRITING))
+            continue;
+        if (text.size() > TEXT_RESERVE)
+            ++cntOversized;
+        s.text.assign(text);  // reuses the reserved storage
+        s.state.store(READY, std::memory_order_release);
+
+        size_t max = highWater.load(std::memory_order_relaxed);
+        while (idx > max and not highWater.compare_exchange_weak(max, idx, std::memory_order_relaxed))
+        { }
 #ifdef REPORT_MISCMSG
-            std::cout << "Msg In " << int(idx) << " >" << text << "<" << std::endl;
+        std::cout << "Msg In " << idx << " >" << text << "<" << std::endl;
 #endif
-            break;
-        }
-        ++ it;
-        ++ idx;
-    }
-    if (it == buffer.end())
-    {
-        std::cerr << "TextMsgBuffer is full :(" << std::endl;
-        idx = -1;
-    }
-
-    int result = idx; // in case of a new entry before return
-    sem_post(&lock);
-#ifdef MAX_MSG
-    if (result > 0) // don't want background ones
-        std::cout << "last " << result << std::endl;
-    if (result > count)
-    {
-        count = result;
-        std::cout << "max " << count << std::endl;
+        return int(idx);
     }
-#endif
-    return result;
+    ++cntFull;  // see stats(); no console output, as this may run on the audio thread
+    return -1;
 }
 
 
-inline std::string TextMsgBuffer::fetch(int _pos, bool remove)
+inline std::string TextMsgBuffer::fetch(int pos, bool remove)
 {
-    if (_pos >= NO_MSG)
+    if (pos < 0 or pos >= NO_MSG)
         return "";
-    sem_wait(&lock);
-
-    int pos = _pos;
-    std::list<std::string>::iterator it = buffer.begin();
-    int idx = 0;
-
-    while (it != buffer.end())
-    {
-        if (idx == pos)
-        {
-#ifdef REPORT_MISCMSG
-            std::cout << "Msg Out " << int(idx) << " >" << *it << "<" << std::endl;
-#endif
-            break;
-        }
-        ++ it;
-        ++ idx;
-    }
+    Slot& s = slot[pos];
     std::string result;
-    if (idx == pos)
+    while (not claim(s, READY, READING))
     {
-        if (remove)
-            swap (result, *it); // in case of a new entry before return
-        else
-            result = *it;
+        if (s.state.load(std::memory_order_relaxed) != READING)
+            return result; // nothing there
+        std::this_thread::yield(); // another reader just copies the text
     }
-    sem_post(&lock);
+    result = s.text;
+    if (remove)
+        s.text.clear();   // retains capacity
+#ifdef REPORT_MISCMSG
+    std::cout << "Msg Out " << pos << " >" << result << "<" << std::endl;
+#endif
+    s.state.store(remove? FREE : READY, std::memory_order_release);
     return result;
 }
 
@@ -14,25 +14,38 @@
   You should have received a copy of the GNU General Public License
   along with this program; if not, write to the Free Software Foundation,
   Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+  Modified 2026 for offline rendering: 32bit float samples
 */
 
 #include <cstdio>
 #include <cstring>
-#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
 #include "WavFile.h"
 
-/*  ######## currently none of this is used
-WavFile::WavFile(string filename, int samplerate, int channels)
-    :sampleswritten(0), samplerate(samplerate), channels(channels),
-      file(fopen(filename.c_str(), "w"))
+namespace {
+    const size_t   HEADER_SIZE   = 56;   // RIFF + fmt + fact + data chunk headers
+    const uint16_t FORMAT_FLOAT  = 3;    // WAVE_FORMAT_IEEE_FLOAT
+    const uint16_t SAMPLE_BYTES  = sizeof(float);
+    const size_t   BLOCK_FRAMES  = 256;  // interleave in blocks of this size
+
+    void put16(FILE *file, uint16_t val) { fwrite(&val, 2, 1, file); }
+    void put32(FILE *file, uint32_t val) { fwrite(&val, 4, 1, file); }
+}
+
+
+WavFile::WavFile(std::string const& filename, unsigned int samplerate, unsigned int channels)
+    :frameswritten(0), samplerate(samplerate), channels(channels),
+      file(fopen(filename.c_str(), "wb"))
 
 {
     if (file)
     {
         //making space for the header written at destruction
-        char tmp[44];
-        memset(tmp, 0, 44 * sizeof(char));
-        fwrite(tmp, 1, 44, file);
+        char tmp[HEADER_SIZE];
+        memset(tmp, 0, HEADER_SIZE);
+        fwrite(tmp, 1, HEADER_SIZE, file);
     }
 }
 
@@ -41,33 +54,27 @@ WavFile::~WavFile()
 {
     if (file)
     {
-
-        unsigned int chunksize;
+        uint32_t blockalign = SAMPLE_BYTES * channels;
+        uint32_t datasize = uint32_t(std::min<size_t>(frameswritten * blockalign, UINT32_MAX - HEADER_SIZE));
         rewind(file);
 
         fwrite("RIFF", 4, 1, file);
-        chunksize = sampleswritten * 4 + 36;
-        fwrite(&chunksize, 4, 1, file);
-
+        put32(file, datasize + HEADER_SIZE - 8);
         fwrite("WAVEfmt ", 8, 1, file);
-        chunksize = 16;
-        fwrite(&chunksize, 4, 1, file);
-        unsigned short int formattag = 1;     //uncompressed wave
-        fwrite(&formattag, 2, 1, file);
-        unsigned short int nchannels = channels;     //stereo
-        fwrite(&nchannels, 2, 1, file);
-        unsigned int samplerate_ = samplerate;         //samplerate
-        fwrite(&samplerate_, 4, 1, file);
-        unsigned int bytespersec = samplerate * 2 * channels;         //bytes/sec
-        fwrite(&bytespersec, 4, 1, file);
-        unsigned short int blockalign = 2 * channels;    //2 channels * 16 bits/8
-        fwrite(&blockalign, 2, 1, file);
-        unsigned short int bitspersample = 16;
-        fwrite(&bitspersample, 2, 1, file);
+        put32(file, 16);
+        put16(file, FORMAT_FLOAT);
+        put16(file, channels);
+        put32(file, samplerate);
+        put32(file, samplerate * blockalign);      //bytes/sec
+        put16(file, blockalign);
+        put16(file, SAMPLE_BYTES * 8);             //bits per sample
+
+        fwrite("fact", 4, 1, file);                // required for non-PCM formats
+        put32(file, 4);
+        put32(file, uint32_t(datasize / blockalign));
 
         fwrite("data", 4, 1, file);
-        chunksize = sampleswritten * blockalign;
-        fwrite(&chunksize, 4, 1, file);
+        put32(file, datasize);
 
         fclose(file);
         file = NULL;
@@ -77,27 +84,34 @@ WavFile::~WavFile()
 
 bool WavFile::good() const
 {
-    return file;
+    return file and not ferror(file);
 }
 
 
-void WavFile::writeStereoSamples(int nsmps, short int *smps)
+void WavFile::writeStereoSamples(size_t nsmps, float const* smpsL, float const* smpsR)
 {
-    if (file)
+    if (not file)
+        return;
+    float block[2 * BLOCK_FRAMES];
+    for (size_t done = 0; done < nsmps; done += BLOCK_FRAMES)
     {
-        fwrite(smps, nsmps, 4, file);
-        sampleswritten += nsmps;
+        size_t cnt = std::min(BLOCK_FRAMES, nsmps - done);
+        for (size_t i = 0; i < cnt; ++i)
+        {
+            block[2*i    ] = smpsL[done + i];
+            block[2*i + 1] = smpsR[done + i];
+        }
+        fwrite(block, 2 * SAMPLE_BYTES, cnt, file);
     }
+    frameswritten += nsmps;
 }
 
 
-void WavFile::writeMonoSamples(int nsmps, short int *smps)
+void WavFile::writeMonoSamples(size_t nsmps, float const* smps)
 {
     if (file)
     {
-        fwrite(smps, nsmps, 2, file);
-        sampleswritten += nsmps;
+        fwrite(smps, SAMPLE_BYTES, nsmps, file);
+        frameswritten += nsmps;
     }
 }
-*/
-
@@ -18,27 +18,43 @@
   You should have received a copy of the GNU General Public License
   along with this program; if not, write to the Free Software Foundation,
   Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+
+  Modified 2026 for offline rendering: 32bit float samples
 */
 
 #ifndef WAVFILE_H
 #define WAVFILE_H
+
+#include <cstdio>
+#include <cstddef>
 #include <string>
 
+/* Sound file in RIFF/WAVE format with 32bit float samples,
+ * as produced by the SynthEngine, so that no clipping occurs.
+ * The header is written on destruction, when the length is known.
+ * Note: assumes a little-endian host, as does the rest of Yoshimi's file IO.
+ */
 class WavFile
 {
     public:
-        WavFile(std::string filename, int samplerate, int channels);
-        ~WavFile();
+        WavFile(std::string const& filename, unsigned int samplerate, unsigned int channels);
+       ~WavFile();
+        // shall not be copied nor moved
+        WavFile(WavFile&&)                 = delete;
+        WavFile(WavFile const&)            = delete;
+        WavFile& operator=(WavFile&&)      = delete;
+        WavFile& operator=(WavFile const&) = delete;
 
         bool good() const;
+        size_t framesWritten() const { return frameswritten; }
 
-        void writeMonoSamples(int nsmps, short int *smps);
-        void writeStereoSamples(int nsmps, short int *smps);
+        void writeMonoSamples(size_t nsmps, float const* smps);
+        void writeStereoSamples(size_t nsmps, float const* smpsL, float const* smpsR);
 
     private:
-        int   sampleswritten;
-        int   samplerate;
-        int   channels;
-        FILE *file;
+        size_t       frameswritten;
+        unsigned int samplerate;
+        unsigned int channels;
+        FILE        *file;
 };
 #endif
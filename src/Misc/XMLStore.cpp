@@ -33,13 +33,24 @@
 
 #include <mxml.h>
 #include <zlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <utility>
 #include <algorithm>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 using file::saveText;
+using file::saveData;
+using file::renameFile;
+using file::deleteFile;
 using file::loadGzipped;
 using file::saveGzipped;
 using file::findExtension;
@@ -51,6 +62,7 @@ using func::asString;
 
 using std::optional;
 using std::string;
+using std::vector;
 using std::move;
 
 
@@ -241,6 +253,219 @@ namespace { // internal details of MXML integration
 }//(End)internal details
 
 
+
+namespace { // compact binary form of the tree
+
+    /* The tree of elements, attributes and text content, laid out as flat tables:
+     *   Header | string offsets | nodes (pre-order) | attributes | string pool
+     * Every distinct string is stored once (NUL terminated), which for parameter
+     * names and typical values like "0" or "yes" removes most of the volume.
+     * All fields are fixed size in native byte order and aligned, so a mapped
+     * file can be read in place; a file from a different architecture is rejected.
+     */
+    const char     BIN_MAGIC[8]   = {'Y','O','S','H','I','B','I','N'};
+    const uint32_t BIN_VERSION    = 1;
+    const uint32_t BIN_BYTE_ORDER = 0x01020304;
+    const uint32_t NO_STRING      = UINT32_MAX;
+    const uint32_t TEXT_NODE      = 1u << 31;   // flag in BinNode::name: opaque text content
+
+    struct BinHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t numStrings;
+        uint32_t numNodes;
+        uint32_t numAttribs;
+        uint32_t poolSize;
+    };
+
+    struct BinNode
+    {
+        uint32_t name;        // string index, or text with TEXT_NODE flag
+        uint32_t numAttribs;  // taken in order from the attribute table
+        uint32_t numChildren; // the nodes following, recursively
+    };
+
+    struct BinAttrib
+    {
+        uint32_t name;
+        uint32_t value;       // NO_STRING for attributes without value
+    };
+
+    uint64_t binarySize(BinHeader const& header)
+    {
+        return sizeof(BinHeader)
+             + uint64_t(header.numStrings) * sizeof(uint32_t)
+             + uint64_t(header.numNodes)   * sizeof(BinNode)
+             + uint64_t(header.numAttribs) * sizeof(BinAttrib)
+             + header.poolSize;
+    }
+
+
+    class BinWriter
+    {
+        std::unordered_map<string, uint32_t> index;
+        vector<uint32_t>  offsets;
+        string            pool;
+        vector<BinNode>   nodes;
+        vector<BinAttrib> attribs;
+
+        uint32_t intern(const char* str)
+        {
+            if (not str)
+                return NO_STRING;
+            auto [pos, added] = index.try_emplace(str, uint32_t(offsets.size()));
+            if (added)
+            {
+                offsets.push_back(uint32_t(pool.size()));
+                pool.append(str);
+                pool.push_back('\0');
+            }
+            return pos->second;
+        }
+
+    public:
+        void addElement(mxml_node_t* elm)
+        {
+            size_t slot = nodes.size();
+            nodes.push_back(BinNode{intern(mxmlGetElement(elm)), 0, 0});
+            uint32_t numAttribs = uint32_t(mxmlElementGetAttrCount(elm));
+            for (uint32_t i = 0; i < numAttribs; ++i)
+            {
+                const char* name{nullptr};
+                const char* value = mxmlElementGetAttrByIndex(elm, i, &name);
+                attribs.push_back(BinAttrib{intern(name), intern(value)});
+            }
+            uint32_t numChildren = 0;
+            for (mxml_node_t* child = mxmlGetFirstChild(elm); child; child = mxmlGetNextSibling(child))
+            {
+                if (MXML_TYPE_ELEMENT == mxmlGetType(child))
+                    addElement(child);
+                else if (MXML_TYPE_OPAQUE == mxmlGetType(child))
+                {
+                    const char* text = mxmlGetOpaque(child);
+                    nodes.push_back(BinNode{TEXT_NODE | intern(text? text:""), 0, 0});
+                }
+                else
+                    continue; // comments and the like carry no data
+                ++numChildren;
+            }
+            nodes[slot].numAttribs = numAttribs;
+            nodes[slot].numChildren = numChildren;
+        }
+
+        string render()
+        {
+            BinHeader header;
+            memcpy(header.magic, BIN_MAGIC, sizeof(BIN_MAGIC));
+            header.version    = BIN_VERSION;
+            header.byteOrder  = BIN_BYTE_ORDER;
+            header.numStrings = uint32_t(offsets.size());
+            header.numNodes   = uint32_t(nodes.size());
+            header.numAttribs = uint32_t(attribs.size());
+            header.poolSize   = uint32_t(pool.size());
+            string data;
+            data.reserve(binarySize(header));
+            data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            data.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+            data.append(reinterpret_cast<const char*>(nodes.data()),   nodes.size()   * sizeof(BinNode));
+            data.append(reinterpret_cast<const char*>(attribs.data()), attribs.size() * sizeof(BinAttrib));
+            data.append(pool);
+            return data;
+        }
+    };
+
+
+    class BinReader
+    {
+        BinHeader header;
+        uint32_t  const* offsets{nullptr};
+        BinNode   const* nodes{nullptr};
+        BinAttrib const* attribs{nullptr};
+        const char* pool{nullptr};
+        uint32_t nextNode{0};
+        uint32_t nextAttrib{0};
+        vector<uint32_t> aligned;  // copy, when the given buffer is not aligned
+
+    public:
+        BinReader(const char* data, size_t size)
+        {
+            if (not XMLStore::isBinary(data, size))
+                return;
+            memcpy(&header, data, sizeof(header));
+            if (header.version != BIN_VERSION
+                or header.byteOrder != BIN_BYTE_ORDER
+                or binarySize(header) != size
+                or (header.poolSize > 0 and data[size - 1] != '\0'))
+                return;
+            if (reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) != 0)
+            {
+                aligned.resize(size / sizeof(uint32_t) + 1);
+                memcpy(aligned.data(), data, size);
+                data = reinterpret_cast<const char*>(aligned.data());
+            }
+            const char* pos = data + sizeof(BinHeader);
+            offsets = reinterpret_cast<uint32_t const*>(pos);
+            pos += header.numStrings * sizeof(uint32_t);
+            nodes = reinterpret_cast<BinNode const*>(pos);
+            pos += header.numNodes * sizeof(BinNode);
+            attribs = reinterpret_cast<BinAttrib const*>(pos);
+            pos += header.numAttribs * sizeof(BinAttrib);
+            pool = pos;
+        }
+
+        explicit operator bool()  const { return nodes and header.numNodes > 0; }
+
+        const char* str(uint32_t idx)  const
+        {
+            if (idx >= header.numStrings or offsets[idx] >= header.poolSize)
+                return nullptr;
+            return pool + offsets[idx];
+        }
+
+        const char* topName()  const
+        {
+            return str(nodes[0].name);
+        }
+
+        /* create the next node below the given parent, including its subtree */
+        bool build(mxml_node_t* parent)
+        {
+            if (nextNode >= header.numNodes)
+                return false;
+            BinNode const& entry = nodes[nextNode++];
+            if (entry.name != NO_STRING and (entry.name & TEXT_NODE))
+            {
+                const char* text = str(entry.name & ~TEXT_NODE);
+                return text and mxmlNewOpaque(parent, text);
+            }
+            const char* name = str(entry.name);
+            if (not name or entry.numAttribs > header.numAttribs - nextAttrib)
+                return false;
+            mxml_node_t* elm = mxmlNewElement(parent, name);
+            for (uint32_t i = 0; i < entry.numAttribs; ++i)
+            {
+                BinAttrib const& attrib = attribs[nextAttrib++];
+                const char* attribName = str(attrib.name);
+                if (not attribName)
+                    return false;
+                mxmlElementSetAttr(elm, attribName, attrib.value == NO_STRING? nullptr : str(attrib.value));
+            }
+            for (uint32_t i = 0; i < entry.numChildren; ++i)
+                if (not build(elm))
+                    return false;
+            return true;
+        }
+
+        bool complete()  const
+        {
+            return nextNode == header.numNodes and nextAttrib == header.numAttribs;
+        }
+    };
+}//(End)compact binary form
+
+
 /* ==== Helper for metadata parsing and rendering ==== */
 
 string renderXmlType(TOPLEVEL::XML type)
@@ -447,6 +672,36 @@ char* XMLtree::render()
     return node? node->render() : nullptr;
 }
 
+/** Factory: create a complete document from the compact binary form.
+ * @remark buffer is owned by caller and will only be read; it may be a mapped file
+ * @return new XMLtree handle, which is empty when the data is not valid.
+ */
+XMLtree XMLtree::decode(const char* data, size_t size)
+{
+    BinReader reader{data, size};
+    if (not reader or not reader.topName())
+        return XMLtree{};
+    XMLtree document;
+    document.makeRoot(strcmp(reader.topName(), ROOT_ZYN) == 0? DT_ZYN : DT_YOSHIMI);
+    if (not reader.build(document.node->mxmlElm()) or not reader.complete())
+        return XMLtree{};
+    return document;
+}
+
+/** render the data content of a document (the top element and everything
+ *  below) into the compact binary form; the XML header is implied. */
+string XMLtree::encode()
+{
+    Node* top = node? node->findChild(ROOT_YOSHI) : nullptr;
+    if (not top and node)
+        top = node->findChild(ROOT_ZYN);
+    if (not top)
+        return string{};
+    BinWriter writer;
+    writer.addElement(top->mxmlElm());
+    return writer.render();
+}
+
 
 XMLtree XMLtree::addElm(string name)
 {
@@ -708,6 +963,11 @@ XMLStore::XMLStore(const char* xml)
     , meta{extractMetadata()}
     { }
 
+XMLStore::XMLStore(const char* data, size_t size)
+    : root{isBinary(data, size)? XMLtree::decode(data, size) : XMLtree::parse(data)}
+    , meta{extractMetadata()}
+    { }
+
 
 void XMLStore::buildXMLRoot()
 {
@@ -793,12 +1053,19 @@ namespace{
 
 XMLStore::Features XMLStore::checkfileinformation(string const& filename, Logger const& log)
 {
-    Features features;
-
     string report;
-    string xml = loadGzipped(filename, report);
+    Features features = checkfileinformation(filename, report);
     if (not report.empty())
         log(report, _SYS_::LogNotSerious);
+    return features;
+}
+
+
+XMLStore::Features XMLStore::checkfileinformation(string const& filename, string& report)
+{
+    Features features;
+
+    string xml = loadGzipped(filename, report);
 
     if (not xml.empty())
     {
@@ -982,8 +1249,109 @@ bool XMLStore::saveXMLfile(string filename, Logger const& log, uint gzipCompress
 }
 
 
+bool XMLStore::isBinary(const char* data, size_t size)
+{
+    return data and size >= sizeof(BinHeader) and memcmp(data, BIN_MAGIC, sizeof(BIN_MAGIC)) == 0;
+}
+
+
+namespace {
+    /** top element rendered as XML, to compare trees independent of the document header */
+    string renderContent(XMLStore& xml)
+    {
+        char* rendered = xml.accessTop().render();
+        string content{rendered? rendered : ""};
+        free(rendered);
+        return content;
+    }
+}
+
+/**
+ * Render tree contents into the compact binary form.
+ * Loading this again yields the same tree as loading the XML;
+ * debug builds verify this round trip on each call.
+ */
+string XMLStore::renderBinary()
+{
+    string data = root.encode();
+#ifndef NDEBUG
+    if (not data.empty())
+    {
+        XMLStore reloaded{data.data(), data.size()};
+        assert (reloaded);
+        assert (renderContent(reloaded) == renderContent(*this));
+    }
+#endif
+    return data;
+}
+
+
+/**
+ * Render tree contents into the compact binary form and write it into a file.
+ * It goes to a temporary file first, which is then renamed, so no reader
+ * ever maps a partially written file.
+ * @return true on success
+ */
+bool XMLStore::saveBinaryFile(string filename, Logger const& log)
+{
+    if (not root)
+    {
+        log("XML: empty tree -- nothing to save", _SYS_::LogNotSerious);
+        return false;
+    }
+    string data = renderBinary();
+    string temp = filename + "." + asString(int(getpid())) + ".tmp";
+    if (data.empty()
+        or saveData(data.data(), data.size(), temp) != ssize_t(data.size())
+        or not renameFile(temp, filename))
+    {
+        deleteFile(temp);
+        log("XML: Failed to save binary file \""+filename+"\"", _SYS_::LogNotSerious);
+        return false;
+    }
+    return true;
+}
+
+
+namespace {
+    /** map a file in compact binary form; nullopt if it is no such file */
+    optional<XMLtree> loadBinaryFile(string const& filename)
+    {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return std::nullopt;
+        optional<XMLtree> content;
+        struct stat st;
+        char magic[sizeof(BIN_MAGIC)];
+        if (fstat(fd, &st) == 0 and size_t(st.st_size) >= sizeof(BinHeader)
+            and pread(fd, magic, sizeof(magic), 0) == ssize_t(sizeof(magic))
+            and memcmp(magic, BIN_MAGIC, sizeof(magic)) == 0)
+        {
+            size_t size = size_t(st.st_size);
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                content.emplace(XMLtree::decode(static_cast<const char*>(mapped), size));
+                munmap(mapped, size);
+            }
+            else
+                content.emplace();
+        }
+        close(fd);
+        return content;
+    }
+}
+
+
 XMLtree XMLStore::loadFile(string filename, Logger const& log)
 {
+    if (optional<XMLtree> binary = loadBinaryFile(filename))
+    {
+        if (not *binary)
+            log("XML: File \""+filename+"\" is no valid binary data of this version", _SYS_::LogNotSerious);
+        return move(*binary);
+    }
+
     string report{};
     string xmldata = loadGzipped(filename, report);
     if (not report.empty())
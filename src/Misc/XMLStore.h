@@ -70,7 +70,9 @@ class XMLtree
         bool empty()              const { return not bool(node); }
 
         static XMLtree parse(const char*);                       // Factory: create from XML buffer
+        static XMLtree decode(const char*, size_t);              // Factory: create from compact binary form
         char* render();                                          // render XMLtree into new malloc() buffer
+        string encode();                                         // render document into compact binary form
 
         enum DocType:uint;
         XMLtree& makeRoot(DocType);                              // Root-init used by the implementation of XMLStore::buildXMLRoot()
@@ -122,6 +124,7 @@ class XMLStore
         XMLStore(TOPLEVEL::XML type, bool zynCompat =false);       // can be created empty
         XMLStore(string filename, Logger const& log);              // can be created by loading XML
         XMLStore(const char* xml);                                 // can be created from buffer with XML data
+        XMLStore(const char* data, size_t size);                   // can be created from buffer with XML or binary data
 
         // can be moved
         XMLStore(XMLStore&&)                 = default;
@@ -137,6 +140,9 @@ class XMLStore
         char* render();                                            // rendered XML into malloc() char buffer (NULL terminated)
         bool saveXMLfile(string filename, Logger const& log        // render XML and store to file, possibly compressed, return true on success
                         ,uint gzipCompressionLevel =0);
+        string renderBinary();                                     // compact binary form of the same tree, see XMLtree::encode()
+        bool saveBinaryFile(string filename, Logger const& log);   // store compact binary form to file, return true on success
+        static bool isBinary(const char* data, size_t size);
 
 
         XMLtree accessTop();
@@ -160,6 +166,7 @@ class XMLStore
 
         // opens a file without parsing the XML; just grep some meta information
         static Features checkfileinformation(std::string const& filename, Logger const& log);
+        static Features checkfileinformation(std::string const& filename, std::string& report);  // thread-safe, no logging
 
     private:
         void buildXMLRoot();
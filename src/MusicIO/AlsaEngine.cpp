@@ -52,6 +52,7 @@ AlsaEngine::AlsaEngine(SynthEngine& _synth, shared_ptr<BeatTracker> beat)
     , card_chans{2}   // got to start somewhere}
     , card_bits{0}
     , pcmWrite{nullptr}
+    , directMmap{false}
     , interleaved{}
     , audio{}
     , midi{}
@@ -82,7 +83,8 @@ bool AlsaEngine::openAudio()
                 {
                     prepBuffers();
                     // Buffers for interleaved audio only used by AlsaEngine
-                    interleaved.reset(new int[getBuffersize() * card_chans]{0});
+                    if (not directMmap)
+                        interleaved.reset(new uint8_t[getBuffersize() * frameBytes()]{0});
                     return true;
                 }
     // if anything did not go well...
@@ -405,6 +407,10 @@ bool AlsaEngine::prepHwparams()
                     + ", Alsa dictates " + asString((unsigned int)audio.period_size), _SYS_::LogNotSerious);
         runtime().buffersize = audio.period_size; // we shouldn't need to do this :(
     }
+    // with just the two channels we produce, samples can go straight into the ring buffer
+    directMmap = (axs == SND_PCM_ACCESS_MMAP_INTERLEAVED and card_chans == 2);
+    if (directMmap)
+        runtime().Log("Alsa audio writes directly into mmap buffer", _SYS_::LogNotSerious);
     return true;
 }
 
@@ -434,50 +440,8 @@ bool AlsaEngine::prepSwparams()
 
 void AlsaEngine::Interleave(int buffersize)
 {
-    size_t idx = 0;
-    bool byte_swap = (little_endian != card_endian);
-    ushort tmp16a, tmp16b;
-    size_t chans;
-    uint tmp32a, tmp32b;
-    uint shift = 0x78000000;
-    if (card_bits == 24)
-        shift = 0x780000;
-
-    if (card_bits == 16)
-    {
-        chans = card_chans / 2; // because we're pairing them on a single integer
-        for (int frame = 0; frame < buffersize; ++frame)
-        {
-            tmp16a = ushort(lrint( zynLeft[NUM_MIDI_PARTS][frame] * 0x7800));
-            tmp16b = ushort(lrint(zynRight[NUM_MIDI_PARTS][frame] * 0x7800));
-            if (byte_swap)
-            {
-                tmp16a = (short int) ((tmp16a >> 8) | (tmp16a << 8));        //TODO shouldn't that be a cast to unsigned short? IIRC, the assignment promotes to unsigned
-                tmp16b = ((tmp16b >> 8) | (tmp16b << 8));
-            }
-            interleaved[idx] = tmp16a | int(tmp16b << 16);
-            idx += chans;
-        }
-    }
-    else
-    {
-        chans = card_chans;
-        for (int frame = 0; frame < buffersize; ++frame)
-        {
-            tmp32a = uint(lrint( zynLeft[NUM_MIDI_PARTS][frame] * shift));
-            tmp32b = uint(lrint(zynRight[NUM_MIDI_PARTS][frame] * shift));
-            // how should we do an endian swap for 24 bit, 3 byte?
-            // is it really the same, just swapping the 'unused' byte?
-            if (byte_swap)
-            {
-                tmp32a = (tmp32a >> 24) | ((tmp32a << 8) & 0x00FF0000) | ((tmp32a >> 8) & 0x0000FF00) | (tmp32a << 24);
-                tmp32b = (tmp32b >> 24) | ((tmp32b << 8) & 0x00FF0000) | ((tmp32b >> 8) & 0x0000FF00) | (tmp32b << 24);
-            }
-            interleaved[idx] = int(tmp32a);
-            interleaved[idx + 1] = int(tmp32b);
-            idx += chans;
-        }
-    }
+    pcm::interleave(zynLeft[NUM_MIDI_PARTS], zynRight[NUM_MIDI_PARTS], interleaved.get(),
+                    size_t(buffersize), frameBytes(), cardFormat());
 }
 
 
@@ -526,8 +490,13 @@ void* AlsaEngine::AudioThread()
         {
             getAudio();
             int alsa_buff = getBuffersize();
-            Interleave(alsa_buff);
-            Write(alsa_buff);
+            if (directMmap)
+                WriteMmap(alsa_buff);
+            else
+            {
+                Interleave(alsa_buff);
+                Write(alsa_buff);
+            }
         }
         else
             runtime().Log("Audio pcm still not running");
@@ -539,7 +508,7 @@ void* AlsaEngine::AudioThread()
 void AlsaEngine::Write(snd_pcm_uframes_t towrite)
 {
     snd_pcm_sframes_t wrote = 0;
-    int *data = interleaved.get();
+    uint8_t *data = interleaved.get();
 
     while (towrite > 0)
     {
@@ -551,31 +520,80 @@ void AlsaEngine::Write(snd_pcm_uframes_t towrite)
             if (wrote > 0)
             {
                 towrite -= wrote;
-                data += wrote * card_chans;
+                data += wrote * frameBytes();
             }
         }
         else // (wrote < 0)
         {
-            switch (wrote)
-            {
-                case -EBADFD:
-                    alsaBad(-EBADFD, "alsa audio unfit for writing");
-                    break;
-
-                case -EPIPE:
-                    xrunRecover();
-                    break;
+            writeFailed(wrote);
+            wrote = 0;
+        }
+    }
+}
 
-                case -ESTRPIPE:
-                    Recover(wrote);
-                    break;
 
-                default:
-                    alsaBad(wrote, "alsa audio, snd_pcm_writei ==> weird state");
-                    break;
-            }
-            wrote = 0;
+/* Convert the samples directly into the hardware ring buffer; on failure,
+ * the rest of the period is dropped and the audio thread restarts the pcm. */
+void AlsaEngine::WriteMmap(snd_pcm_uframes_t towrite)
+{
+    float const* left  = zynLeft[NUM_MIDI_PARTS];
+    float const* right = zynRight[NUM_MIDI_PARTS];
+    while (towrite > 0)
+    {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(audio.handle);
+        if (avail < 0)
+        {
+            writeFailed(avail);
+            return;
+        }
+        if (avail == 0)
+        {
+            snd_pcm_wait(audio.handle, 666);
+            continue;
         }
+        const snd_pcm_channel_area_t* areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = towrite;
+        int err = snd_pcm_mmap_begin(audio.handle, &areas, &offset, &frames);
+        if (err < 0)
+        {
+            writeFailed(err);
+            return;
+        }
+        uint8_t* dest = static_cast<uint8_t*>(areas[0].addr) + (areas[0].first + offset * areas[0].step) / 8;
+        pcm::interleave(left, right, dest, frames, areas[0].step / 8, cardFormat());
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(audio.handle, offset, frames);
+        if (committed < 0 || snd_pcm_uframes_t(committed) != frames)
+        {
+            writeFailed(committed < 0? committed : -EPIPE);
+            return;
+        }
+        left += frames;
+        right += frames;
+        towrite -= frames;
+    }
+}
+
+
+void AlsaEngine::writeFailed(snd_pcm_sframes_t err)
+{
+    switch (err)
+    {
+        case -EBADFD:
+            alsaBad(-EBADFD, "alsa audio unfit for writing");
+            break;
+
+        case -EPIPE:
+            xrunRecover();
+            break;
+
+        case -ESTRPIPE:
+            Recover(err);
+            break;
+
+        default:
+            alsaBad(err, "alsa audio, snd_pcm_writei ==> weird state");
+            break;
     }
 }
 
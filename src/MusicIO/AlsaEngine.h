@@ -26,6 +26,7 @@
 #define ALSA_ENGINE_H
 
 #include "MusicIO/MusicIO.h"
+#include "MusicIO/PcmConvert.h"
 
 #include <pthread.h>
 #include <alsa/asoundlib.h>
@@ -75,6 +76,8 @@ class AlsaEngine : public MusicIO
         bool prepSwparams();
         void Interleave(int buffersize);
         void Write(snd_pcm_uframes_t towrite);
+        void WriteMmap(snd_pcm_uframes_t towrite);
+        void writeFailed(snd_pcm_sframes_t err);
         bool Recover(int err);
         bool xrunRecover();
         bool alsaBad(int op_result, string err_msg);
@@ -103,7 +106,11 @@ class AlsaEngine : public MusicIO
         using PcmOutput = snd_pcm_sframes_t(snd_pcm_t*, const void*, snd_pcm_uframes_t);
         PcmOutput* pcmWrite;
 
-        unique_ptr<int[]> interleaved; // output buffer for 16bit interleaved audio
+        bool directMmap;   // convert straight into the mmap ring buffer
+        unique_ptr<uint8_t[]> interleaved; // output buffer in card format, unless directMmap
+
+        pcm::Format cardFormat()  const { return pcm::Format{card_bits, card_endian}; }
+        size_t frameBytes()       const { return card_chans * cardFormat().sampleBytes(); }
 
         struct Audio {
             string            device{};
@@ -25,6 +25,7 @@
 #include "Misc/FormatFuncs.h"
 #include "MusicIO/JackEngine.h"
 
+#include <algorithm>
 #include <errno.h>
 #include <iostream>
 #include <string>
@@ -47,6 +48,9 @@ JackEngine::JackEngine(SynthEngine& _synth, shared_ptr<BeatTracker> beat)
     , audio{}
     , midiPort{nullptr}
     , internalbuff{0}
+    , midiQueue{}
+    , queued{0}
+    , dispatched{0}
 {
     runtime().isMultiFeed = true;
     audio.jackSamplerate = 0;
@@ -398,16 +402,19 @@ int JackEngine::processCallback(jack_nframes_t nframes)
 {
     bool okaudio = true;
     bool okmidi = true;
+    // (at least) main outputs exist, using jack audio
+    bool withAudio = audio.ports[NUM_MIDI_PARTS * 2] && audio.ports[NUM_MIDI_PARTS * 2 + 1];
 
     if (midiPort)
     {
         // input exists, using jack midi
         handleBeatValues(nframes);
-        okmidi = processMidi(nframes);
+        // with jack audio, events are dispatched at their time while rendering
+        okmidi = processMidi(nframes, withAudio);
     }
-    if (audio.ports[NUM_MIDI_PARTS * 2] && audio.ports[NUM_MIDI_PARTS * 2 + 1])
-        // (at least) main outputs exist, using jack audio
+    if (withAudio)
         okaudio = processAudio(nframes);
+    dispatchMidi(nframes); // leftovers, should audio have failed
     return (okaudio && okmidi) ? 0 : -1;
 }
 
@@ -442,26 +449,28 @@ bool JackEngine::processAudio(jack_nframes_t nframes)
         return false;
     }
 
+    /*
+     * Render the period in chunks of at most internalbuff, also split where
+     * MIDI events are due. Since event times are rounded to MIDI_GRANULE,
+     * a dense stream of events can not cause more than
+     * nframes / MIDI_GRANULE additional splits, keeping the cost bounded.
+     */
     BeatTracker::BeatValues beats(beatTracker->getBeatValues());
-    int framesize;
-    if (nframes <= internalbuff)
-    {
-        synth.setBeatValues(beats.songBeat, beats.monotonicBeat, beats.bpm);
-        framesize = sizeof(float) * nframes;
-        synth.MasterAudio(zynLeft, zynRight, nframes);
-        sendAudio(framesize, 0);
-    }
-    else
-    {
-        framesize = sizeof(float) * internalbuff;
-        for (unsigned int pos = 0; pos < nframes; pos += internalbuff)
-        {
-            float bpmInc = (float)pos * beats.bpm / (audio.jackSamplerate * 60.0f);
-            synth.setBeatValues(beats.songBeat + bpmInc, beats.monotonicBeat + bpmInc, beats.bpm);
-            synth.MasterAudio(zynLeft, zynRight, internalbuff);
-            sendAudio(framesize, pos);
-        }
+    synth.profiler.beginPeriod(); // overruns are judged against the whole JACK period
+    for (jack_nframes_t pos = 0; pos < nframes; )
+    {
+        dispatchMidi(pos);
+        jack_nframes_t chunk = std::min(nframes - pos, jack_nframes_t(internalbuff));
+        if (dispatched < queued)
+            chunk = std::min(chunk, midiQueue[dispatched].frame - pos);
+
+        float bpmInc = (float)pos * beats.bpm / (audio.jackSamplerate * 60.0f);
+        synth.setBeatValues(beats.songBeat + bpmInc, beats.monotonicBeat + bpmInc, beats.bpm);
+        jack_nframes_t done = synth.MasterAudio(zynLeft, zynRight, chunk);
+        sendAudio(sizeof(float) * done, pos);
+        pos += done;
     }
+    synth.profiler.endPeriod(synth.samplerate);
     return true;
 }
 
@@ -499,7 +508,7 @@ void JackEngine::sendAudio(int framesize, uint offset)
 }
 
 
-bool JackEngine::processMidi(jack_nframes_t nframes)
+bool JackEngine::processMidi(jack_nframes_t nframes, bool deferred)
 {
     void *portBuf = jack_port_get_buffer(midiPort, nframes);
     if (!portBuf)
@@ -512,15 +521,43 @@ bool JackEngine::processMidi(jack_nframes_t nframes)
     jack_midi_event_t jEvent;
     jack_nframes_t eventCount = jack_midi_get_event_count(portBuf);
 
+    queued = dispatched = 0;
     for (idx = 0; idx < eventCount; ++idx)
     {
-        if (!jack_midi_event_get(&jEvent, portBuf, idx))
-            if (jEvent.size >= 1 && jEvent.size <= 4) // no interest in zero sized or long events
-                handleMidi(jEvent.buffer[0], jEvent.buffer[1], jEvent.buffer[2]);
+        if (jack_midi_event_get(&jEvent, portBuf, idx))
+            continue;
+        if (jEvent.size < 1 || jEvent.size > 4) // no interest in zero sized or long events
+            continue;
+        if (deferred && queued == MAX_TIMED_EVENTS)
+        {   // flood: keep the order, but give up timing for the rest
+            dispatchMidi(nframes);
+            deferred = false;
+        }
+        if (!deferred)
+        {
+            handleMidi(jEvent.buffer[0], jEvent.buffer[1], jEvent.buffer[2]);
+            continue;
+        }
+        // jack delivers the events in time order
+        TimedEvent& event = midiQueue[queued++];
+        jack_nframes_t frame = std::min(jEvent.time, nframes - 1);
+        event.frame = frame - frame % MIDI_GRANULE;
+        for (size_t i = 0; i < 3; ++i)
+            event.data[i] = (i < jEvent.size) ? jEvent.buffer[i] : 0;
     }
     return true;
 }
 
+
+void JackEngine::dispatchMidi(jack_nframes_t upTo)
+{
+    for ( ; dispatched < queued && midiQueue[dispatched].frame <= upTo; ++dispatched)
+    {
+        TimedEvent const& event = midiQueue[dispatched];
+        handleMidi(event.data[0], event.data[1], event.data[2]);
+    }
+}
+
 void JackEngine::handleBeatValues(jack_nframes_t nframes)
 {
     jack_position_t pos;
@@ -77,7 +77,8 @@ class JackEngine : public MusicIO
         bool connectJackPorts();
         bool processAudio(jack_nframes_t nframes);
         void sendAudio(int framesize, uint offset);
-        bool processMidi(jack_nframes_t nframes);
+        bool processMidi(jack_nframes_t nframes, bool deferred);
+        void dispatchMidi(jack_nframes_t upTo);
         void handleBeatValues(jack_nframes_t nframes);
         bool latencyPrep();
         int processCallback(jack_nframes_t nframes);
@@ -103,10 +104,24 @@ class JackEngine : public MusicIO
             float        *portBuffs[2*NUM_MIDI_PARTS+2];
         };
 
+        /* MIDI events of the current period, dispatched at their frame
+         * (rounded down to MIDI_GRANULE) while rendering the audio */
+        struct TimedEvent
+        {
+            jack_nframes_t frame;
+            uchar          data[3];
+        };
+        static constexpr size_t         MAX_TIMED_EVENTS = 512;
+        static constexpr jack_nframes_t MIDI_GRANULE     = 32;
+
         jack_client_t *jackClient;
         JackAudio      audio;
         jack_port_t   *midiPort;
 
         unsigned int internalbuff;
+
+        TimedEvent midiQueue[MAX_TIMED_EVENTS];
+        size_t     queued;
+        size_t     dispatched;
 };
 #endif /*JACK_ENGINE_H*/
@@ -0,0 +1,299 @@
+/*
+    MidiFile.cpp - reading Standard MIDI Files for offline rendering
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "MusicIO/MidiFile.h"
+
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <cmath>
+
+using std::ifstream;
+
+
+namespace { // implementation details
+
+    const uint32_t DEFAULT_TEMPO = 500000;   // µs per quarter note, i.e. 120 BPM
+
+    struct RawEvent
+    {
+        uint64_t tick;
+        uint32_t order;      // position in file, keeps the sort stable across tracks
+        uint32_t tempo;      // µs per quarter, when this is a tempo change, else zero
+        uchar    data[3];
+        bool     endOfTrack;
+    };
+
+
+    /* Cursor over the chunk data; all accessors fail softly at the end */
+    class Reader
+    {
+        vector<uchar> const& buf;
+        size_t pos;
+        size_t end;
+
+    public:
+        Reader(vector<uchar> const& data, size_t start, size_t limit)
+            : buf{data}
+            , pos{start}
+            , end{std::min(limit, data.size())}
+        { }
+
+        bool   has(size_t cnt) const { return pos + cnt <= end; }
+        size_t position()      const { return pos; }
+        void   skip(size_t cnt)      { pos = std::min(pos + cnt, end); }
+
+        uchar byte()
+        {
+            return has(1)? buf[pos++] : 0;
+        }
+
+        uint32_t u16()
+        {
+            uint32_t val = byte();
+            return (val << 8) | byte();
+        }
+
+        uint32_t u32()
+        {
+            uint32_t val = u16();
+            return (val << 16) | u16();
+        }
+
+        uint32_t vlq()   // variable length quantity, at most 4 bytes
+        {
+            uint32_t val = 0;
+            for (int i = 0; i < 4 and has(1); ++i)
+            {
+                uchar b = byte();
+                val = (val << 7) | (b & 0x7f);
+                if (not (b & 0x80))
+                    break;
+            }
+            return val;
+        }
+    };
+
+
+    inline int dataBytes(uchar status)
+    {
+        uchar type = status & 0xf0;
+        return (type == 0xc0 or type == 0xd0)? 1 : 2;
+    }
+
+
+    bool readTrack(Reader& in, size_t limit, uint32_t& order, vector<RawEvent>& raw)
+    {
+        uint64_t tick = 0;
+        uchar running = 0;
+        while (in.position() < limit and in.has(1))
+        {
+            tick += in.vlq();
+            uchar status = in.byte();
+            if (status == 0xff)
+            {// meta event
+                running = 0;
+                uchar type = in.byte();
+                uint32_t len = in.vlq();
+                if (not in.has(len))
+                    return false;
+                if (type == 0x51 and len == 3)
+                {
+                    uint32_t tempo = (uint32_t(in.byte()) << 16) | in.u16();
+                    if (tempo > 0)
+                        raw.push_back(RawEvent{tick, order++, tempo, {0,0,0}, false});
+                }
+                else
+                {
+                    in.skip(len);
+                    if (type == 0x2f)
+                    {
+                        raw.push_back(RawEvent{tick, order++, 0, {0,0,0}, true});
+                        return true;
+                    }
+                }
+                continue;
+            }
+            if (status == 0xf0 or status == 0xf7)
+            {// SysEx: not forwarded
+                running = 0;
+                uint32_t len = in.vlq();
+                if (not in.has(len))
+                    return false;
+                in.skip(len);
+                continue;
+            }
+
+            RawEvent event{tick, order++, 0, {0,0,0}, false};
+            int pos = 0;
+            if (status & 0x80)
+            {
+                if (status > 0xef)
+                    return false;  // system messages are not allowed in a MIDI file
+                running = status;
+            }
+            else
+            {
+                if (not running)
+                    return false;
+                event.data[++pos] = status;  // first data byte already consumed
+            }
+            event.data[0] = running;
+            for (int i = pos; i < dataBytes(running); ++i)
+                event.data[i + 1] = in.byte() & 0x7f;
+            raw.push_back(event);
+        }
+        return true; // tolerate a missing end-of-track
+    }
+}//(End)implementation details
+
+
+
+bool MidiFile::load(string const& filename, uint rate)
+{
+    sequence.clear();
+    tempoMap.clear();
+    endFrame = 0;
+    failure.clear();
+    samplerate = rate;
+
+    ifstream file{filename, std::ios::binary};
+    if (not file)
+    {
+        failure = "can not read " + filename;
+        return false;
+    }
+    vector<uchar> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    Reader header{data, 0, data.size()};
+    if (not header.has(14)
+        or header.u32() != 0x4d546864  // "MThd"
+        or header.u32() < 6)
+    {
+        failure = filename + " is not a Standard MIDI File";
+        return false;
+    }
+    uint32_t format   = header.u16();
+    uint32_t tracks   = header.u16();
+    uint32_t division = header.u16();
+    if (format > 1)
+    {
+        failure = "MIDI file format " + std::to_string(format) + " is not supported";
+        return false;
+    }
+    if (division == 0)
+    {
+        failure = filename + " has no valid time division";
+        return false;
+    }
+
+    vector<RawEvent> raw;
+    uint32_t order = 0;
+    size_t chunk = 8 + Reader{data, 4, 8}.u32();
+    for (uint32_t track = 0; track < tracks; )
+    {
+        Reader in{data, chunk, data.size()};
+        if (not in.has(8))
+            break;
+        uint32_t id  = in.u32();
+        uint32_t len = in.u32();
+        size_t limit = in.position() + len;
+        chunk = limit;
+        if (id != 0x4d54726b)     // "MTrk"; skip alien chunks
+            continue;
+        ++track;
+        if (not readTrack(in, limit, order, raw))
+        {
+            failure = "corrupted track " + std::to_string(track) + " in " + filename;
+            return false;
+        }
+    }
+    std::sort(raw.begin(), raw.end()
+             ,[](RawEvent const& e1, RawEvent const& e2)
+                {
+                    return e1.tick < e2.tick or (e1.tick == e2.tick and e1.order < e2.order);
+                });
+
+    // walk the timeline, integrating tempo changes
+    bool smpte = division & 0x8000;
+    double secsPerTick;
+    double beatsPerTick;
+    if (smpte)
+    {
+        int fps = -int(int8_t(division >> 8));
+        double frameRate = (fps == 29)? 29.97 : fps;
+        secsPerTick = 1.0 / (frameRate * (division & 0xff));
+        beatsPerTick = secsPerTick * 2;     // nominal 120 BPM
+    }
+    else
+    {
+        secsPerTick = DEFAULT_TEMPO * 1e-6 / division;
+        beatsPerTick = 1.0 / division;
+    }
+    uint64_t lastTick = 0;
+    double secs = 0;
+    double beat = 0;
+    tempoMap.push_back(Tempo{0, 0.0, 120.0f});
+
+    for (RawEvent const& event : raw)
+    {
+        secs += (event.tick - lastTick) * secsPerTick;
+        beat += (event.tick - lastTick) * beatsPerTick;
+        lastTick = event.tick;
+        uint64_t frame = uint64_t(llround(secs * samplerate));
+        endFrame = std::max(endFrame, frame);
+
+        if (event.tempo)
+        {
+            if (smpte)
+                continue;
+            secsPerTick = event.tempo * 1e-6 / division;
+            float bpm = 60e6f / event.tempo;
+            if (tempoMap.back().frame == frame)
+                tempoMap.back().bpm = bpm;
+            else
+                tempoMap.push_back(Tempo{frame, beat, bpm});
+        }
+        else if (not event.endOfTrack)
+            sequence.push_back(Event{frame, {event.data[0], event.data[1], event.data[2]}});
+    }
+    return true;
+}
+
+
+MidiFile::Tempo const& MidiFile::tempoAt(uint64_t frame)  const
+{
+    auto next = std::upper_bound(tempoMap.begin(), tempoMap.end(), frame
+                                ,[](uint64_t f, Tempo const& t){ return f < t.frame; });
+    return *std::prev(next);  // first entry is always at frame zero
+}
+
+
+float MidiFile::beatAt(uint64_t frame)  const
+{
+    Tempo const& tempo = tempoAt(frame);
+    return float(tempo.beat + (frame - tempo.frame) * double(tempo.bpm) / (60.0 * samplerate));
+}
+
+
+float MidiFile::bpmAt(uint64_t frame)  const
+{
+    return tempoAt(frame).bpm;
+}
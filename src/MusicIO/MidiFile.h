@@ -0,0 +1,77 @@
+/*
+    MidiFile.h - reading Standard MIDI Files for offline rendering
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef MIDI_FILE_H
+#define MIDI_FILE_H
+
+#include "globals.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+
+/* Standard MIDI File (format 0 or 1), flattened into one timeline.
+ * All tracks are merged and every channel message is placed at the audio frame
+ * where it shall take effect, according to the tempo map of the file.
+ * SysEx and meta events other than tempo changes are skipped.
+ */
+class MidiFile
+{
+    public:
+        struct Event
+        {
+            uint64_t frame;
+            uchar    data[3];   // status byte and up to two data bytes
+        };
+
+        MidiFile() = default;
+
+        bool load(string const& filename, uint samplerate);
+
+        vector<Event> const& events() const { return sequence; }
+        uint64_t length()             const { return endFrame; }
+        string const& problem()       const { return failure; }
+
+        // musical position, to feed the LFO/BPM sync of the SynthEngine
+        float beatAt(uint64_t frame)  const;
+        float bpmAt(uint64_t frame)   const;
+
+    private:
+        struct Tempo
+        {
+            uint64_t frame;
+            double   beat;
+            float    bpm;
+        };
+
+        vector<Event> sequence;
+        vector<Tempo> tempoMap;
+        uint64_t      endFrame{0};
+        string        failure;
+        uint          samplerate{0};
+
+        Tempo const& tempoAt(uint64_t frame)  const;
+};
+
+#endif /*MIDI_FILE_H*/
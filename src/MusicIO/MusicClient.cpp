@@ -25,6 +25,7 @@
 #include "Misc/SynthEngine.h"
 #include "MusicIO/AlsaEngine.h"
 #include "MusicIO/JackEngine.h"
+#include "MusicIO/OfflineEngine.h"
 #include <iostream>
 #include <stdlib.h>
 #include <cassert>
@@ -67,7 +68,7 @@ catch(...)               { std::cerr << "Unidentified problem while closing Musi
 void MusicClient::createEngines(audio_driver useAudio, midi_driver useMidi)
 {
     shared_ptr<BeatTracker> beat;
-    if (useAudio == jack_audio && useMidi == jack_midi)
+    if ((useAudio == jack_audio && useMidi == jack_midi) || useAudio == offline_audio)
         beat = make_shared<SinglethreadedBeatTracker>();
     else
         beat = make_shared<MultithreadedBeatTracker>();
@@ -83,6 +84,9 @@ void MusicClient::createEngines(audio_driver useAudio, midi_driver useMidi)
             audioIO = make_shared<AlsaEngine>(synth, beat);
             break;
 #endif /*ALSA*/
+        case offline_audio:
+            audioIO = make_shared<OfflineEngine>(synth, beat);
+            break;
 #endif /*LV2*/
         default:
             audioIO.reset();
@@ -106,6 +110,10 @@ void MusicClient::createEngines(audio_driver useAudio, midi_driver useMidi)
                 midiIO = make_shared<AlsaEngine>(synth, beat);
             break;
 #endif /*ALSA*/
+        case offline_midi:
+            if (useAudio == offline_audio)
+                midiIO = audioIO;
+            break;
 #endif /*LV2*/
         default:
             midiIO.reset();
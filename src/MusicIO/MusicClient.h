@@ -37,8 +37,8 @@ using std::shared_ptr;
 using std::unique_ptr;
 using std::string;
 
-enum audio_driver { no_audio = 0, jack_audio, alsa_audio};
-enum midi_driver  { no_midi = 0, jack_midi, alsa_midi};
+enum audio_driver { no_audio = 0, jack_audio, alsa_audio, offline_audio};
+enum midi_driver  { no_midi = 0, jack_midi, alsa_midi, offline_midi};
 
 class Config;
 class MusicIO;
@@ -55,7 +55,8 @@ void MusicIO::handleMidi(uchar par0, uchar par1, uchar par2, bool in_place)
     if (synth.audioOut.load() != _SYS_::mute::Idle)
         return; // nobody listening!
 
-    bool inSync = runtime().isLV2 or (runtime().audioEngine == jack_audio and runtime().midiEngine == jack_midi);
+    bool inSync = runtime().isLV2 or (runtime().audioEngine == jack_audio and runtime().midiEngine == jack_midi)
+                                  or runtime().audioEngine == offline_audio;
 
     CommandBlock putData;
 
@@ -0,0 +1,312 @@
+/*
+    OfflineEngine.cpp - headless rendering of MIDI files into sound files
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Misc/Config.h"
+#include "Misc/Part.h"
+#include "Misc/SynthEngine.h"
+#include "Misc/FormatFuncs.h"
+#include "Misc/FileMgrFuncs.h"
+#include "Misc/WavFile.h"
+#include "Misc/XMLStore.h"
+#include "MusicIO/MidiFile.h"
+#include "MusicIO/OfflineEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <cmath>
+
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::this_thread::sleep_for;
+using std::unique_ptr;
+using std::atomic;
+using std::move;
+
+using func::asString;
+using func::asCompactString;
+
+
+namespace { // shared state of all offline engine instances
+
+    const float  TAIL_SILENCE   = 0.5;     // seconds below threshold to end the tail
+    const float  TAIL_LIMIT     = 30;      // seconds at most to render after the last event
+    const float  SILENCE_LEVEL  = 1e-5;    // about -100dB
+    const auto   STARTUP_LIMIT  = std::chrono::seconds(30);
+    const auto   HOLD_INTERVAL  = std::chrono::microseconds(200);
+
+    atomic<size_t>   nextJob{0};
+    atomic<size_t>   jobsDone{0};
+    atomic<uint64_t> soundRendered_us{0};   // total sound produced by all instances
+    steady_clock::time_point launched;
+    std::once_flag   launchOnce;
+
+    using Seconds = duration<double>;
+
+    float peakLevel(float const* smps, size_t cnt)
+    {
+        float peak = 0;
+        for (size_t i = 0; i < cnt; ++i)
+            peak = std::max(peak, fabsf(smps[i]));
+        return peak;
+    }
+
+    string targetBase(string const& midiFile)
+    {
+        string dir = Config::renderTargetDir;
+        if (dir.empty())
+        {
+            size_t slash = midiFile.rfind('/');
+            dir = (slash == string::npos)? "." : midiFile.substr(0, slash);
+        }
+        return dir + "/" + file::findLeafName(midiFile);
+    }
+}
+
+
+
+OfflineEngine::OfflineEngine(SynthEngine& _synth, shared_ptr<BeatTracker> beat)
+    : MusicIO{_synth, move(beat)}
+    , samplerate{0}
+    , buffersize{0}
+    , pThread{0}
+    , initialState{}
+    , initialRoot{0}
+    , initialBank{0}
+    { }
+
+
+bool OfflineEngine::openAudio()
+{
+    samplerate = runtime().samplerate;
+    buffersize = runtime().buffersize;
+    if (not prepBuffers())
+    {
+        runtime().Log("Failed to allocate offline render buffers", _SYS_::LogError);
+        return false;
+    }
+    runtime().isMultiFeed = true;  // parts can be rendered into separate files
+    return true;
+}
+
+
+bool OfflineEngine::Start()
+{
+    std::call_once(launchOnce, []{ launched = steady_clock::now(); });
+    if (not runtime().startThread(&pThread, _RenderThread, this, false, 0, "Offline render"))
+    {
+        runtime().Log("Failed to start offline render thread", _SYS_::LogError);
+        return false;
+    }
+    return true;
+}
+
+
+void OfflineEngine::Close()
+{
+    if (pThread != 0) // wait for render thread to finish
+    {
+        runtime().runSynth = false;
+        void *ret = NULL;
+        pthread_join(pThread, &ret);
+        pThread = 0;
+    }
+}
+
+
+string OfflineEngine::audioClientName()  const
+{
+    string name{"yoshimi-offline"};
+    if (synth.getUniqueId() > 0)
+        name += "-" + asString(synth.getUniqueId());
+    return name;
+}
+
+
+void* OfflineEngine::_RenderThread(void *arg)
+{
+    return static_cast<OfflineEngine*>(arg)->RenderThread();
+}
+
+
+/* Pull the next file from the shared queue, until none is left;
+ * the instance completing the last file causes Yoshimi to exit. */
+void* OfflineEngine::RenderThread()
+{
+    if (not awaitEngineReady())
+    {
+        runtime().Log("Offline render: engine did not become ready", _SYS_::LogError);
+        runtime().runSynth.store(false, std::memory_order_release);
+        return NULL;
+    }
+    captureInitialState();
+    auto& jobs = Config::renderMidiFiles;
+    for (size_t job = nextJob++; job < jobs.size(); job = nextJob++)
+    {
+        renderFile(jobs[job]);
+        synth.disposeReleasedInstruments(); // swapped in place by program changes of the song
+        if (++jobsDone < jobs.size())
+            continue;
+        double wallTime = Seconds(steady_clock::now() - launched).count();
+        double soundTime = soundRendered_us.load() * 1e-6;
+        runtime().Log("Offline render finished: " + asString(jobs.size()) + " files, "
+                     + asCompactString(soundTime) + "s of sound in " + asCompactString(wallTime)
+                     + "s, overall realtime factor " + asCompactString(soundTime / wallTime));
+        Config::primary().runSynth.store(false, std::memory_order_release);
+    }
+    if (synth.getUniqueId() > 0)
+        runtime().runSynth.store(false, std::memory_order_release); // retire this helper instance
+    return NULL;
+}
+
+
+/* Run the engine (discarding the output) until the start-up mute
+ * has been lifted and thus MIDI input is accepted. */
+bool OfflineEngine::awaitEngineReady()
+{
+    auto deadline = steady_clock::now() + STARTUP_LIMIT;
+    while (synth.audioOut.load() != _SYS_::mute::Idle)
+    {
+        if (not runtime().runSynth.load(std::memory_order_relaxed)
+            or steady_clock::now() > deadline)
+            return false;
+        getAudio();
+        sleep_for(HOLD_INTERVAL);
+    }
+    return true;
+}
+
+
+/* The patch state loaded at start-up (instruments, effects, microtonal)
+ * is what each file starts from; MIDI program changes, controllers or
+ * patch edits done while rendering one file must not leak into the next. */
+void OfflineEngine::captureInitialState()
+{
+    XMLStore xml{TOPLEVEL::XML::State};
+    synth.add2XML(xml);
+    initialState = xml.renderBinary();
+    initialRoot = runtime().currentRoot;
+    initialBank = runtime().currentBank;
+}
+
+
+/* Called from the render thread, which is the only one running the engine */
+void OfflineEngine::restoreInitialState()
+{
+    XMLStore xml{initialState.data(), initialState.size()};
+    if (not xml)
+    {
+        runtime().Log("Offline render: unable to restore initial engine state", _SYS_::LogError);
+        return;
+    }
+    synth.defaults();
+    synth.getfromXML(xml);
+    synth.setAllPartMaps();
+    runtime().currentRoot = initialRoot;
+    runtime().currentBank = initialBank;
+}
+
+
+bool OfflineEngine::renderFile(string const& midiFile)
+{
+    MidiFile song;
+    if (not song.load(midiFile, samplerate))
+    {
+        runtime().Log("Offline render: " + song.problem(), _SYS_::LogError);
+        return false;
+    }
+    restoreInitialState();          // independent of what was rendered before
+    synth.setReproducibleState(0);
+
+    string base = targetBase(midiFile);
+    WavFile master{base + EXTEN::MSwave, samplerate, 2};
+    if (not master.good())
+    {
+        runtime().Log("Offline render: can not write " + base + EXTEN::MSwave, _SYS_::LogError);
+        return false;
+    }
+    unique_ptr<WavFile> stem[NUM_MIDI_PARTS];
+    int stemCnt = 0;
+    for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+        if (synth.partonoffRead(npart) and (synth.part[npart]->Paudiodest & 2))
+        {
+            stem[npart].reset(new WavFile{base + "-part" + asString(npart + 1) + EXTEN::MSwave, samplerate, 2});
+            ++stemCnt;
+        }
+
+    auto started = steady_clock::now();
+    auto const& events = song.events();
+    auto next = events.begin();
+    uint64_t frame = 0;
+    uint64_t silent = 0;
+    uint64_t songEnd = song.length();
+    uint64_t tailEnd = songEnd + uint64_t(TAIL_LIMIT * samplerate);
+    uint64_t tailSilence = uint64_t(TAIL_SILENCE * samplerate);
+
+    while (runtime().runSynth.load(std::memory_order_relaxed))
+    {
+        if (synth.audioOut.load() != _SYS_::mute::Idle)
+        {// hold the timeline while muted (e.g. patch set loaded through MIDI)
+            getAudio();
+            sleep_for(HOLD_INTERVAL);
+            continue;
+        }
+        for ( ; next != events.end() and next->frame <= frame; ++next)
+            handleMidi(next->data[0], next->data[1], next->data[2], true);
+
+        if (frame >= songEnd and (silent >= tailSilence or frame >= tailEnd))
+            break;
+
+        uint64_t chunk = uint64_t(buffersize);
+        if (next != events.end())
+            chunk = std::min(chunk, next->frame - frame);
+        if (frame < songEnd)
+            chunk = std::min(chunk, songEnd - frame);
+
+        float beat = song.beatAt(frame);
+        synth.setBeatValues(beat, beat, song.bpmAt(frame));
+        size_t done = size_t(synth.MasterAudio(zynLeft, zynRight, int(chunk)));
+
+        master.writeStereoSamples(done, zynLeft[NUM_MIDI_PARTS], zynRight[NUM_MIDI_PARTS]);
+        for (int npart = 0; npart < NUM_MIDI_PARTS; ++npart)
+            if (stem[npart])
+                stem[npart]->writeStereoSamples(done, zynLeft[npart], zynRight[npart]);
+
+        if (frame >= songEnd
+            and std::max(peakLevel(zynLeft[NUM_MIDI_PARTS], done),
+                         peakLevel(zynRight[NUM_MIDI_PARTS], done)) < SILENCE_LEVEL)
+            silent += done;
+        else
+            silent = 0;
+        frame += done;
+    }
+
+    double calcTime = Seconds(steady_clock::now() - started).count();
+    double soundTime = double(frame) / samplerate;
+    soundRendered_us += uint64_t(soundTime * 1e6);
+    runtime().Log("Rendered " + midiFile + " -> " + base + EXTEN::MSwave
+                 + (stemCnt? " (+" + asString(stemCnt) + " parts)" : "")
+                 + ": " + asCompactString(soundTime) + "s in " + asCompactString(calcTime)
+                 + "s, realtime factor " + asCompactString(calcTime > 0? soundTime / calcTime : 0));
+    return master.good();
+}
@@ -0,0 +1,91 @@
+/*
+    OfflineEngine.h - headless rendering of MIDI files into sound files
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef OFFLINE_ENGINE_H
+#define OFFLINE_ENGINE_H
+
+#include "MusicIO/MusicIO.h"
+
+#include <pthread.h>
+#include <string>
+
+using std::string;
+
+class SynthEngine;
+
+
+/* Audio and MIDI backend without any device: plays Standard MIDI Files through
+ * the SynthEngine as fast as the CPU allows and writes the master output, plus
+ * each part routed to a separate output, as WAV files (see Config::renderMidiFiles).
+ *
+ * - events are dispatched sample accurate, splitting engine cycles as needed
+ * - rendering continues after the end of the song until the reverb tails died away
+ * - each file starts from the engine state as found at start-up, with all
+ *   pseudo random generators reseeded, so results are repeatable
+ * - MIDI is dispatched in place, so program and bank changes take effect
+ *   exactly at the event, without depending on background threads
+ * - all engine instances with this backend share one queue of files to render;
+ *   Yoshimi exits when the last one is finished
+ * - while the engine is muted (e.g. patch set loaded through MIDI), the timeline is held
+ */
+class OfflineEngine : public MusicIO
+{
+    public:
+        // shall not be copied nor moved
+        OfflineEngine(OfflineEngine&&)                 = delete;
+        OfflineEngine(OfflineEngine const&)            = delete;
+        OfflineEngine& operator=(OfflineEngine&&)      = delete;
+        OfflineEngine& operator=(OfflineEngine const&) = delete;
+        OfflineEngine(SynthEngine&, shared_ptr<BeatTracker>);
+       ~OfflineEngine() { Close(); }
+
+
+        /* ====== MusicIO interface ======== */
+        bool openAudio()               override;
+        bool openMidi()                override { return true; }
+        bool Start()                   override;
+        void Close()                   override;
+        void registerAudioPort(int)    override { /*ignore*/ }
+
+        uint   getSamplerate()   const override { return samplerate; }
+        int    getBuffersize()   const override { return buffersize; }
+        string audioClientName() const override ;
+        int    audioClientId()   const override { return 0; }
+        string midiClientName()  const override { return audioClientName(); }
+        int    midiClientId()    const override { return 0; }
+
+    private:
+        uint      samplerate;
+        int       buffersize;
+        pthread_t pThread;
+        string    initialState;   // engine patch state (compact binary) to start each file from
+        uint      initialRoot;
+        uint      initialBank;
+
+        void* RenderThread();
+        static void* _RenderThread(void* arg);
+
+        bool awaitEngineReady();
+        void captureInitialState();
+        void restoreInitialState();
+        bool renderFile(string const& midiFile);
+};
+
+#endif /*OFFLINE_ENGINE_H*/
@@ -0,0 +1,183 @@
+/*
+    PcmConvert.cpp - float samples into integer sound card formats
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "MusicIO/PcmConvert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define HAVE_SSE2_KERNEL
+#endif
+
+using pcm::Format;
+
+
+namespace { // implementation details
+
+    /* full scale is a little below the limit, leaving some headroom */
+    const float SCALE16 = 0x7800;
+    const float SCALE24 = 0x780000;
+    const float SCALE32 = 0x78000000;
+
+    const float MAX16 = 32767.0f;
+    const float MAX24 = 8388607.0f;
+    const float MAX32 = 2147483520.0f;  // largest float below 2^31
+
+    const bool HOST_LITTLE = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
+
+    /* NaN becomes silence, as in the SSE2 path; lrintf() is undefined for it */
+    inline int32_t toInt(float smp, float scale, float limit)
+    {
+        if (std::isnan(smp))
+            return 0;
+        return int32_t(lrintf(std::clamp(smp * scale, -limit - 1, limit)));
+    }
+
+    inline void put16(uint8_t* dest, int32_t val, bool little)
+    {
+        uint16_t v = uint16_t(val);
+        if (little != HOST_LITTLE)
+            v = __builtin_bswap16(v);
+        memcpy(dest, &v, 2);
+    }
+
+    inline void put24(uint8_t* dest, int32_t val, bool little)
+    {   // packed 3 bytes
+        uint32_t v = uint32_t(val);
+        uint8_t lo = v & 0xff, mid = (v >> 8) & 0xff, hi = (v >> 16) & 0xff;
+        dest[0] = little? lo : hi;
+        dest[1] = mid;
+        dest[2] = little? hi : lo;
+    }
+
+    inline void put32(uint8_t* dest, int32_t val, bool little)
+    {
+        uint32_t v = uint32_t(val);
+        if (little != HOST_LITTLE)
+            v = __builtin_bswap32(v);
+        memcpy(dest, &v, 4);
+    }
+
+    void interleavePlain(float const* left, float const* right, uint8_t* dest,
+                         size_t frames, size_t frameBytes, Format format)
+    {
+        size_t smpBytes = format.sampleBytes();
+        for (size_t i = 0; i < frames; ++i, dest += frameBytes)
+            switch (format.bits)
+            {
+                case 16:
+                    put16(dest,            toInt(left[i],  SCALE16, MAX16), format.littleEndian);
+                    put16(dest + smpBytes, toInt(right[i], SCALE16, MAX16), format.littleEndian);
+                    break;
+                case 24:
+                    put24(dest,            toInt(left[i],  SCALE24, MAX24), format.littleEndian);
+                    put24(dest + smpBytes, toInt(right[i], SCALE24, MAX24), format.littleEndian);
+                    break;
+                default:
+                    put32(dest,            toInt(left[i],  SCALE32, MAX32), format.littleEndian);
+                    put32(dest + smpBytes, toInt(right[i], SCALE32, MAX32), format.littleEndian);
+                    break;
+            }
+    }
+
+#ifdef HAVE_SSE2_KERNEL
+    /* NaN lanes set to 0; max/min alone would turn them into negative full scale */
+    inline __m128 silenceNaN(__m128 smp)
+    {
+        return _mm_and_ps(smp, _mm_cmpord_ps(smp, smp));
+    }
+
+    /* 4 stereo frames: interleave, scale and clamp, then round to nearest (MXCSR default) */
+    inline void convert4(float const* left, float const* right, __m128 scale, __m128 lo, __m128 hi,
+                         __m128i& frames01, __m128i& frames23)
+    {
+        __m128 l = _mm_mul_ps(silenceNaN(_mm_loadu_ps(left)),  scale);
+        __m128 r = _mm_mul_ps(silenceNaN(_mm_loadu_ps(right)), scale);
+        __m128 a = _mm_unpacklo_ps(l, r);   // l0 r0 l1 r1
+        __m128 b = _mm_unpackhi_ps(l, r);   // l2 r2 l3 r3
+        frames01 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(a, lo), hi));
+        frames23 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(b, lo), hi));
+    }
+
+    /* little endian, two channels per frame: returns frames done */
+    size_t interleaveSSE2(float const* left, float const* right, uint8_t* dest,
+                          size_t frames, Format format)
+    {
+        size_t i = 0;
+        __m128i a, b;
+        if (format.bits == 16)
+        {
+            const __m128 scale = _mm_set1_ps(SCALE16);
+            const __m128 lo = _mm_set1_ps(-MAX16 - 1), hi = _mm_set1_ps(MAX16);
+            for ( ; i + 4 <= frames; i += 4, dest += 16)
+            {
+                convert4(left + i, right + i, scale, lo, hi, a, b);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packs_epi32(a, b));
+            }
+        }
+        else if (format.bits == 32)
+        {
+            const __m128 scale = _mm_set1_ps(SCALE32);
+            const __m128 lo = _mm_set1_ps(-MAX32 - 1), hi = _mm_set1_ps(MAX32);
+            for ( ; i + 4 <= frames; i += 4, dest += 32)
+            {
+                convert4(left + i, right + i, scale, lo, hi, a, b);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), a);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), b);
+            }
+        }
+        else // 24 bit: convert 4 frames into a register, then pack 3 bytes each
+        {
+            const __m128 scale = _mm_set1_ps(SCALE24);
+            const __m128 lo = _mm_set1_ps(-MAX24 - 1), hi = _mm_set1_ps(MAX24);
+            alignas(16) int32_t tmp[8];
+            for ( ; i + 4 <= frames; i += 4, dest += 24)
+            {
+                convert4(left + i, right + i, scale, lo, hi, a, b);
+                _mm_store_si128(reinterpret_cast<__m128i*>(tmp), a);
+                _mm_store_si128(reinterpret_cast<__m128i*>(tmp + 4), b);
+                for (size_t s = 0; s < 8; ++s)
+                    put24(dest + 3 * s, tmp[s], true);
+            }
+        }
+        return i;
+    }
+#endif
+}//(End)implementation details
+
+
+namespace pcm {
+
+void interleave(float const* left, float const* right, uint8_t* dest,
+                size_t frames, size_t frameBytes, Format format)
+{
+    size_t done = 0;
+#ifdef HAVE_SSE2_KERNEL
+    if (format.littleEndian and frameBytes == 2 * format.sampleBytes())
+        done = interleaveSSE2(left, right, dest, frames, format);
+#endif
+    interleavePlain(left + done, right + done, dest + done * frameBytes,
+                    frames - done, frameBytes, format);
+}
+
+}//(End)namespace pcm
@@ -0,0 +1,47 @@
+/*
+    PcmConvert.h - float samples into integer sound card formats
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PCM_CONVERT_H
+#define PCM_CONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pcm {
+
+    /* signed integer sample layout of the card */
+    struct Format
+    {
+        int  bits;          // 16, 24 (packed into 3 bytes) or 32
+        bool littleEndian;  // byte order of the card
+
+        size_t sampleBytes()  const { return bits == 24? 3 : size_t(bits) / 8; }
+    };
+
+    /* Scale the stereo pair into the card format, with saturation, and place
+     * them as the first two channels of consecutive frames, frameBytes apart.
+     * Rounding is to nearest, as lrint() did; NaN gives 0. On x86, little endian
+     * formats with two channels per frame are converted 4 frames at a time with SSE2;
+     * dev_notes/PcmConvertTest.cpp checks both paths give the same bytes. */
+    void interleave(float const* left, float const* right, uint8_t* dest,
+                    size_t frames, size_t frameBytes, Format format);
+}
+
+#endif /*PCM_CONVERT_H*/
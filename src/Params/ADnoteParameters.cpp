@@ -62,6 +62,20 @@ ADnoteParameters::ADnoteParameters(fft::Calc& fft_, SynthEngine& _synth)
     for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
         enableVoice(nvoice);
     defaults();
+    requestOscilTables(task::BULK);
+}
+
+
+/* Launch a background build of the note-on tables of all enabled voices;
+ * called from the non-audio side whenever the voice parameters may have changed */
+void ADnoteParameters::requestOscilTables(task::Priority prio)
+{
+    for (uint nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+        if (VoicePar[nvoice].Enabled)
+        {
+            VoicePar[nvoice].OscilSmp->requestTables(prio);
+            VoicePar[nvoice].FMSmp->requestTables(prio);
+        }
 }
 
 
@@ -628,6 +642,7 @@ void ADnoteParameters::getfromXML(XMLtree& xmlAddSynth)
         if (XMLtree xmlVoice = xmlAddSynth.getElm("VOICE", nvoice))
             getfromXML_voice(xmlVoice, nvoice);
     }
+    requestOscilTables(task::BULK); // tables for note-on, built in background
 }
 
 void ADnoteParameters::getfromXML_voice(XMLtree& xmlVoice, const uint nvoice)
@@ -210,6 +210,7 @@ class ADnoteParameters : public ParamBase
         float getUnisonFrequencySpreadCents(int nvoice);
         void setGlobalPan(char pan, uchar panLaw);
         void setVoicePan(int voice, char pan, uchar panLaw);
+        void requestOscilTables(task::Priority =task::INTERACTIVE);
         ADnoteGlobalParam GlobalPar;
         ADnoteVoiceParam VoicePar[NUM_VOICES];
 
@@ -401,6 +401,39 @@ void Controller::getfromXML(XMLtree& xml)
 }
 
 
+// take over the settings covered by getfromXML(), but none of the current controller values
+void Controller::copySettings(Controller const& src)
+{
+    pitchwheel.bendrange = src.pitchwheel.bendrange;
+
+    expression.receive   = src.expression.receive;
+    panning.depth        = src.panning.depth;
+    filtercutoff.depth   = src.filtercutoff.depth;
+    filterq.depth        = src.filterq.depth;
+    bandwidth.depth      = src.bandwidth.depth;
+    modwheel.depth       = src.modwheel.depth;
+    modwheel.exponential = src.modwheel.exponential;
+    fmamp.receive        = src.fmamp.receive;
+    volume.receive       = src.volume.receive;
+    setvolume(src.volume.data);
+
+    sustain.receive      = src.sustain.receive;
+
+    portamento.receive           = src.portamento.receive;
+    portamento.time              = src.portamento.time;
+    portamento.pitchthresh       = src.portamento.pitchthresh;
+    portamento.pitchthreshtype   = src.portamento.pitchthreshtype;
+    portamento.portamento        = src.portamento.portamento;
+    portamento.updowntimestretch = src.portamento.updowntimestretch;
+    portamento.proportional      = src.portamento.proportional;
+    portamento.propRate          = src.portamento.propRate;
+    portamento.propDepth         = src.portamento.propDepth;
+
+    resonancecenter.depth    = src.resonancecenter.depth;
+    resonancebandwidth.depth = src.resonancebandwidth.depth;
+}
+
+
 float Controller::getLimits(CommandBlock *getData)
 {
     float value = getData->data.value;
@@ -44,6 +44,7 @@ class Controller
 
         void add2XML(XMLtree&);
         void getfromXML(XMLtree&);
+        void copySettings(Controller const&); // those stored with an instrument
 
         // Controllers functions
         void setpitchwheel(int value);
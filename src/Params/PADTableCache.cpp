@@ -0,0 +1,244 @@
+/*
+    PADTableCache.cpp - persistent storage of rendered PADSynth wavetables
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Params/PADTableCache.h"
+#include "Params/PADnoteParameters.h"
+#include "Misc/FileMgrFuncs.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+
+namespace { // implementation details
+
+    const char     MAGIC[8]       = {'Y','O','S','P','A','D','T','B'};
+    const uint32_t FORMAT_VERSION = 1;
+    const string   EXTENSION      = ".padtab";
+
+    struct FileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t numTables;
+        uint64_t tableSize;
+        uint64_t key;
+    };
+
+    std::mutex storeLock;
+
+
+    string entryName(PADTableCache::Key key)
+    {
+        char name[17];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+        return PADTableCache::location() + "/" + name + EXTENSION;
+    }
+
+    size_t expectedSize(PADTables const& tables)
+    {
+        return sizeof(FileHeader) + tables.numTables * tables.tableSize * sizeof(float);
+    }
+
+    bool writeAll(int fd, void const* data, size_t len)
+    {
+        auto pos = static_cast<char const*>(data);
+        while (len > 0)
+        {
+            ssize_t written = write(fd, pos, len);
+            if (written <= 0)
+                return false;
+            pos += written;
+            len -= size_t(written);
+        }
+        return true;
+    }
+
+
+    struct Entry
+    {
+        string path;
+        size_t bytes;
+        time_t lastUse;
+    };
+
+    vector<Entry> listEntries()
+    {
+        vector<Entry> entries;
+        string dirName = PADTableCache::location();
+        DIR *dir = opendir(dirName.c_str());
+        if (!dir)
+            return entries;
+        while (struct dirent *fn = readdir(dir))
+        {
+            string name = fn->d_name;
+            if (name.size() <= EXTENSION.size()
+                or name.compare(name.size() - EXTENSION.size(), EXTENSION.size(), EXTENSION) != 0)
+                continue;
+            string path = dirName + "/" + name;
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0 and S_ISREG(st.st_mode))
+                entries.push_back(Entry{path, size_t(st.st_size), st.st_mtime});
+        }
+        closedir(dir);
+        return entries;
+    }
+
+    // note: storeLock held by caller
+    void evictToLimit()
+    {
+        vector<Entry> entries = listEntries();
+        size_t total = 0;
+        for (Entry const& entry : entries)
+            total += entry.bytes;
+        if (total <= PADTableCache::SIZE_LIMIT)
+            return;
+        std::sort(entries.begin(), entries.end()
+                 ,[](Entry const& e1, Entry const& e2){ return e1.lastUse < e2.lastUse; });
+        for (Entry const& entry : entries)
+        {
+            if (total <= PADTableCache::SIZE_LIMIT)
+                break;
+            if (file::deleteFile(entry.path))
+                total -= entry.bytes;
+        }
+    }
+}//(End)implementation details
+
+
+
+string PADTableCache::location()
+{
+    string local = file::localDir();
+    if (local.empty())
+        return "";
+    return local + "/padcache";
+}
+
+
+/* Fill the given (freshly allocated) tables from a cache entry, if present. */
+bool PADTableCache::load(Key key, PADTables& target)
+{
+    string path = entryName(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    bool found = false;
+    struct stat st;
+    size_t size = expectedSize(target);
+    if (fstat(fd, &st) == 0 and size_t(st.st_size) == size)
+    {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            FileHeader header;
+            memcpy(&header, mapped, sizeof(header));
+            if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+                and header.version == FORMAT_VERSION
+                and header.numTables == target.numTables
+                and header.tableSize == target.tableSize
+                and header.key == key)
+            {
+                float const* data = reinterpret_cast<float const*>(static_cast<char const*>(mapped) + sizeof(FileHeader));
+                for (size_t tab = 0; tab < target.numTables; ++tab)
+                {
+                    fft::Waveform& wave = target[tab];
+                    memcpy(&wave[0], data + tab * target.tableSize, target.tableSize * sizeof(float));
+                    wave.fillInterpolationBuffer();
+                }
+                found = true;
+            }
+            munmap(mapped, size);
+        }
+    }
+    if (found)
+        futimens(fd, nullptr); // mark as recently used
+    close(fd);
+    return found;
+}
+
+
+/* Write a new cache entry; goes to a temporary file first,
+ * which is then renamed, so readers never see partial data. */
+void PADTableCache::store(Key key, PADTables const& tables)
+{
+    string dir = location();
+    if (dir.empty())
+        return;
+    std::lock_guard<std::mutex> guard(storeLock);
+    if (not file::isDirectory(dir) and file::createDir(dir))
+        return;
+
+    string path = entryName(key);
+    string temp = path + "." + std::to_string(getpid()) + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return;
+
+    FileHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version   = FORMAT_VERSION;
+    header.numTables = uint32_t(tables.numTables);
+    header.tableSize = tables.tableSize;
+    header.key       = key;
+    bool ok = writeAll(fd, &header, sizeof(header));
+    for (size_t tab = 0; ok and tab < tables.numTables; ++tab)
+        ok = writeAll(fd, &tables[tab][0], tables.tableSize * sizeof(float));
+    ok = (close(fd) == 0) and ok;
+
+    if (ok and file::renameFile(temp, path))
+        evictToLimit();
+    else
+        file::deleteFile(temp);
+}
+
+
+PADTableCache::Usage PADTableCache::usage()
+{
+    Usage result{0, 0};
+    for (Entry const& entry : listEntries())
+    {
+        ++result.entries;
+        result.bytes += entry.bytes;
+    }
+    return result;
+}
+
+
+size_t PADTableCache::purge()
+{
+    std::lock_guard<std::mutex> guard(storeLock);
+    size_t removed = 0;
+    for (Entry const& entry : listEntries())
+        if (file::deleteFile(entry.path))
+            ++removed;
+    return removed;
+}
@@ -0,0 +1,61 @@
+/*
+    PADTableCache.h - persistent storage of rendered PADSynth wavetables
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the License,
+    or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  See the GNU General Public License (version 2
+    or later) for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef PAD_TABLE_CACHE_H
+#define PAD_TABLE_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+class PADTables;
+
+
+/* Cache of finished PADSynth wavetables, stored below the user's local directory.
+ * Rendering is a pure function of the parameters, thus each set of tables is filed
+ * under a hash of everything going into the render (see PADnoteParameters::wavetableKey).
+ * On a warm start the file is mapped into memory and copied into the new tables,
+ * instead of running the spectrum generation and IFFT for each table.
+ *
+ * - all functions are thread-safe; load() and store() are called from build tasks
+ * - failures are not reported, but just cause the tables to be rendered as usual
+ * - the total size is bounded; least recently used entries are discarded first
+ */
+class PADTableCache
+{
+    public:
+        using Key = uint64_t;
+
+        static constexpr size_t SIZE_LIMIT = size_t(256) << 20;  // bytes
+
+        static bool load(Key, PADTables& target);
+        static void store(Key, PADTables const&);
+
+        struct Usage
+        {
+            size_t entries;
+            size_t bytes;
+        };
+        static Usage usage();
+        static size_t purge();   // returns the number of entries removed
+        static std::string location();
+};
+
+#endif /*PAD_TABLE_CACHE_H*/
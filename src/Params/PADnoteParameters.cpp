@@ -44,7 +44,9 @@
 #include "Misc/SynthEngine.h"
 #include "Misc/FileMgrFuncs.h"
 #include "Misc/NumericFuncs.h"
+#include "Misc/Hash.h"
 #include "Params/PADnoteParameters.h"
+#include "Params/PADTableCache.h"
 #include "Misc/WavFile.h"
 
 using std::string;
@@ -541,15 +543,12 @@ float PADnoteParameters::calcHarmonicPositionFactor(float n)
 // Generates the long spectrum for Bandwidth mode (only amplitudes are generated;
 // phases will be random)
 vector<float> PADnoteParameters::generateSpectrum_bandwidthMode(float basefreq, size_t spectrumSize,
+                                                                vector<float> const& harmonics,
                                                                 vector<float> const& profile)
 {
     assert(spectrumSize > 1);
     vector<float> spectrum(spectrumSize, 0.0f); // zero-init
 
-    // get the harmonic structure from the oscillator
-    vector<float> harmonics(oscilgen->getSpectrumForPAD(basefreq));
-    normaliseMax(harmonics); // within 0.0 .. 1.0
-
     // derive the "perceptual" bandwidth for the given profile (a value 0 .. 1)
     float bwadjust = calcProfileBandwith(profile);
 
@@ -645,15 +644,12 @@ vector<float> PADnoteParameters::generateSpectrum_bandwidthMode(float basefreq,
 
 
 // Generates the long spectrum for non-Bandwidth modes (only amplitudes are generated; phases will be random)
-vector<float> PADnoteParameters::generateSpectrum_otherModes(float basefreq, size_t spectrumSize)
+vector<float> PADnoteParameters::generateSpectrum_otherModes(float basefreq, size_t spectrumSize,
+                                                             vector<float> const& harmonics)
 {
     assert(spectrumSize > 1);
     vector<float> spectrum(spectrumSize, 0.0f); // zero-init
 
-    // get the harmonic structure from the oscillator
-    vector<float> harmonics(oscilgen->getSpectrumForPAD(basefreq));
-    normaliseMax(harmonics); // within 0.0 .. 1.0
-
     for (size_t nh = 0; nh+1 < fft.spectrumSize(); ++nh)
     {   //for each harmonic
         float realfreq = calcHarmonicPositionFactor(nh) * basefreq;
@@ -698,14 +694,14 @@ vector<float> PADnoteParameters::generateSpectrum_otherModes(float basefreq, siz
 }
 
 
-void PADnoteParameters::buildNewWavetable(bool blocking)
+void PADnoteParameters::buildNewWavetable(bool blocking, task::Priority prio)
 {
     PADStatus::mark(PADStatus::DIRTY, synth.interchange, partID,kitID);
     if (synth.getRuntime().useLegacyPadBuild())
         mute_and_rebuild_synchronous();
     else
     if (not blocking)
-        futureBuild.requestNewBuild();
+        futureBuild.requestNewBuild(prio);
     else
     {   // Guarantee to invoke a new build NOW and block until it is ready...
         // This is tricky, since new builds can be triggered any time from the GUI
@@ -729,17 +725,16 @@ namespace { auto& NO_RESULT = std::nullopt; }
 // This is the heart of the PADSynth: generate a set of perfectly looped wavetables,
 // based on rendering a harmonic profile for each line of the base waveform spectrum.
 // Each table is generated by a single inverse FFT, but using a high resolution spectrum.
+// The tables are independent and thus rendered in parallel on the task::RunnerBackend;
+// only the harmonic structure must be retrieved beforehand, since OscilGen is stateful.
+// Finished tables are kept in the PADTableCache, to be picked up again on the next start.
 // Note: when returning the NoResult marker, the build shall be aborted and restarted.
 optional<PADTables> PADnoteParameters::render_wavetable()
 {
     PADTables newTable(Pquality);
-    const size_t spectrumSize = newTable.tableSize / 2;
+    const size_t numTables = newTable.numTables;
     PADStatus::mark(PADStatus::BUILDING, synth.interchange, partID,kitID);
 
-    // prepare storage for a very large spectrum and FFT transformer
-    fft::Calc fft{newTable.tableSize};
-    fft::Spectrum fftCoeff(spectrumSize);
-
     // (in »bandwidth mode«) build harmonic profile used for each line
     vector<float> profile = Pmode == 0? buildProfile(SIZE_HARMONIC_PROFILE)
                                       : vector<float>(); // empty dummy
@@ -751,46 +746,139 @@ optional<PADTables> PADnoteParameters::render_wavetable()
     if (Pquality.basenote %2 == 1)
         baseNoteFreq *= 1.5;
 
-    float adj[newTable.numTables]; // used to compute frequency relation to the base note frequency
-    for (size_t tabNr = 0; tabNr < newTable.numTables; ++tabNr)
-        adj[tabNr] = (Pquality.oct + 1.0f) * (float)tabNr / newTable.numTables;
+    float adj[numTables]; // used to compute frequency relation to the base note frequency
+    for (size_t tabNr = 0; tabNr < numTables; ++tabNr)
+        adj[tabNr] = (Pquality.oct + 1.0f) * (float)tabNr / numTables;
 
-    for (size_t tabNr = 0; tabNr < newTable.numTables; ++tabNr)
+    vector<vector<float>> harmonics(numTables);
+    for (size_t tabNr = 0; tabNr < numTables; ++tabNr)
     {
-        float tmp = adj[tabNr] - adj[newTable.numTables - 1] * 0.5f;
+        float tmp = adj[tabNr] - adj[numTables - 1] * 0.5f;
         float basefreqadjust = power<2>(tmp);
         float basefreq = baseNoteFreq *  basefreqadjust;
-
         newTable.basefreq[tabNr] = basefreq;
 
-        vector<float> spectrum =
-            Pmode == 0? generateSpectrum_bandwidthMode(basefreq, spectrumSize, profile)
-                      : generateSpectrum_otherModes(basefreq, spectrumSize);
+        // get the harmonic structure from the oscillator
+        harmonics[tabNr] = oscilgen->getSpectrumForPAD(basefreq);
+        normaliseMax(harmonics[tabNr]); // within 0.0 .. 1.0
+    }
 
-        for (size_t i = 1; i < spectrumSize; ++i)
-        {   // Note: each wavetable uses differently randomised phases
-            float phase = wavetablePhasePrng.numRandom() * 6.29f;
-            fftCoeff.c(i) = spectrum[i] * cosf(phase);
-            fftCoeff.s(i) = spectrum[i] * sinf(phase);
-        }
+    // The phases are randomised from a seed derived from the parameters, thus the result
+    // is reproducible and can be cached -- unless rebuilds are triggered deliberately
+    // to get a fresh variation each time, in which case the cache is bypassed.
+    PADTableCache::Key key = wavetableKey(newTable, harmonics, profile);
+    bool useCache = (PrebuildTrigger == 0);
+    if (not useCache)
+        key ^= wavetablePhasePrng.randomINT();
+    else if (PADTableCache::load(key, newTable))
+    {
+        PADStatus::mark(PADStatus::PENDING, synth.interchange, partID,kitID);
+        return newTable;
+    }
+
+    task::parallelFor(numTables, [&](size_t tabNr)
+                                    {
+                                        if (futureBuild.shallRebuild())
+                                            return; // abort remaining work
+                                        // each table randomises phases from a separate substream,
+                                        // so the result does not depend on the order of rendering
+                                        uint32_t phaseSeed = uint32_t(func::hash_bytes(&tabNr, sizeof(tabNr), key));
+                                        render_singleTable(newTable, tabNr, harmonics[tabNr], profile, phaseSeed);
+                                    });
+    if (futureBuild.shallRebuild())
+        return NO_RESULT;
+
+    if (useCache)
+        PADTableCache::store(key, newTable);
+    PADStatus::mark(PADStatus::PENDING, synth.interchange, partID,kitID);
+    return newTable;
+}
 
-        if (futureBuild.shallRebuild())
-            return NO_RESULT;
 
-        fft::Waveform& newsmp = newTable[tabNr];
-        newsmp[0] = 0.0f;                ///TODO 12/2021 (why) is this necessary? Doesn't the IFFT generate a full waveform?
+// Hash of everything going into the rendering of the wavetables.
+uint64_t PADnoteParameters::wavetableKey(PADTables const& newTable, vector<vector<float>> const& harmonics,
+                                         vector<float> const& profile)
+{
+    uint64_t key = 0;
+    auto add = [&](auto const& val){ key = func::hash_bytes(&val, sizeof(val), key); };
+    auto addAll = [&](vector<float> const& vec)
+                        {
+                            add(vec.size());
+                            key = func::hash_bytes(vec.data(), vec.size() * sizeof(float), key);
+                        };
+    add(newTable.numTables);
+    add(newTable.tableSize);
+    for (size_t tabNr = 0; tabNr < newTable.numTables; ++tabNr)
+    {
+        add(newTable.basefreq[tabNr]);
+        addAll(harmonics[tabNr]);
+    }
+    addAll(profile);
+
+    add(synth.samplerate);
+    add(Pmode);
+    add(Pbwscale);
+    add(PProfile.autoscale);
+    add(Phrpos.type);
+    add(Phrpos.par1);
+    add(Phrpos.par2);
+    add(Phrpos.par3);
+    float bandwidth = getBandwithInCent();
+    add(bandwidth);
+
+    add(resonance->Penabled);
+    if (resonance->Penabled)
+    {
+        add(resonance->Prespoints);
+        add(resonance->PmaxdB);
+        add(resonance->Pcenterfreq);
+        add(resonance->Poctavesfreq);
+        add(resonance->Pprotectthefundamental);
+        add(resonance->ctlcenter);
+        add(resonance->ctlbw);
+    }
+    return key;
+}
+
 
-        fft.freqs2smps(fftCoeff, newsmp);
-        // that's all; here is the only IFFT for the whole sample; no windows are used ;-) (Comment by original author)
+// Render one of the wavetables; may run concurrently for several tables,
+// thus spectrum and FFT calculator are private to each invocation.
+void PADnoteParameters::render_singleTable(PADTables& newTable, size_t tabNr, vector<float> const& harmonics,
+                                           vector<float> const& profile, uint32_t phaseSeed)
+{
+    const size_t spectrumSize = newTable.tableSize / 2;
+    const float basefreq = newTable.basefreq[tabNr];
 
-        normaliseSpectrumRMS(newsmp);
+    // prepare storage for a very large spectrum and FFT transformer
+    fft::Calc fft{newTable.tableSize};
+    fft::Spectrum fftCoeff(spectrumSize);
 
-        // prepare extra samples used by the linear or cubic interpolation
-        newsmp.fillInterpolationBuffer();
+    vector<float> spectrum =
+        Pmode == 0? generateSpectrum_bandwidthMode(basefreq, spectrumSize, harmonics, profile)
+                  : generateSpectrum_otherModes(basefreq, spectrumSize, harmonics);
+
+    RandomGen phasePrng;
+    phasePrng.init(phaseSeed);
+    for (size_t i = 1; i < spectrumSize; ++i)
+    {   // Note: each wavetable uses differently randomised phases
+        float phase = phasePrng.numRandom() * 6.29f;
+        fftCoeff.c(i) = spectrum[i] * cosf(phase);
+        fftCoeff.s(i) = spectrum[i] * sinf(phase);
     }
 
-    PADStatus::mark(PADStatus::PENDING, synth.interchange, partID,kitID);
-    return newTable;
+    if (futureBuild.shallRebuild())
+        return;
+
+    fft::Waveform& newsmp = newTable[tabNr];
+    newsmp[0] = 0.0f;                ///TODO 12/2021 (why) is this necessary? Doesn't the IFFT generate a full waveform?
+
+    fft.freqs2smps(fftCoeff, newsmp);
+    // that's all; here is the only IFFT for the whole sample; no windows are used ;-) (Comment by original author)
+
+    normaliseSpectrumRMS(newsmp);
+
+    // prepare extra samples used by the linear or cubic interpolation
+    newsmp.fillInterpolationBuffer();
 }
 
 
@@ -818,6 +906,22 @@ void PADnoteParameters::activate_wavetable()
 }
 
 
+/* Block until a background build is finished and install the result
+ * right away, without crossfade. Only to be used on parameters which are
+ * not yet used by the SynthEngine, e.g. an instrument being loaded.
+ */
+void PADnoteParameters::awaitWavetable()
+{
+    if (not futureBuild.isUnderway())
+        return;
+    futureBuild.blockingWait(true);
+    PADStatus::mark(PADStatus::CLEAN, synth.interchange, partID,kitID);
+    futureBuild.swap(waveTable);
+    paramsChanged();
+    sampleTime = 0;
+}
+
+
 /* automatic self-retrigger: if activated, a new wavetable background build is launched
  * after a given amount of "sample time" has passed. Moreover, some parameters may perform
  * a »random walk« by applying a small random offset on each rebuild, within a given spread.
@@ -1194,7 +1298,7 @@ void PADnoteParameters::getfromXML(XMLtree& xmlPadSynth)
     // trigger re-build of the wavetable as background task...
     waveTable.reset();           // silence existing sound from previous instruments using the same part
     futureBuild.blockingWait();  // possibly retrieve result of ongoing build without publishing (Note: blocks consecutive instrument loads from MIDI)
-    buildNewWavetable();         // launch rebuild of wavetables for the new instrument (background task)
+    buildNewWavetable(false, task::BULK); // launch rebuild of wavetables for the new instrument (background task)
     // result will be picked up from PADnote::noteout() when ready
 }
 
@@ -189,9 +189,10 @@ class PADnoteParameters : public ParamBase
         float getBandwithInCent(); // convert Pbandwith setting into cents
 
         // (re)Building the Wavetable
-        void buildNewWavetable(bool blocking =false);
+        void buildNewWavetable(bool blocking =false, task::Priority =task::INTERACTIVE);
         std::optional<PADTables> render_wavetable();
         void activate_wavetable();
+        void awaitWavetable();
         bool export2wav(std::string basefilename);
 
         vector<float> buildProfile(size_t size);
@@ -340,8 +341,12 @@ class PADnoteParameters : public ParamBase
         size_t sampleTime;
         RandomGen wavetablePhasePrng;
 
-        vector<float> generateSpectrum_bandwidthMode(float basefreq, size_t spectrumSize, vector<float> const& profile);
-        vector<float> generateSpectrum_otherModes(float basefreq, size_t spectrumSize);
+        vector<float> generateSpectrum_bandwidthMode(float basefreq, size_t spectrumSize, vector<float> const& harmonics, vector<float> const& profile);
+        vector<float> generateSpectrum_otherModes(float basefreq, size_t spectrumSize, vector<float> const& harmonics);
+        void render_singleTable(PADTables& newTable, size_t tabNr, vector<float> const& harmonics,
+                                vector<float> const& profile, uint32_t phaseSeed);
+        uint64_t wavetableKey(PADTables const& newTable, vector<vector<float>> const& harmonics,
+                              vector<float> const& profile);
 
         void maybeRetrigger();
         void mute_and_rebuild_synchronous();
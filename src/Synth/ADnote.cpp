@@ -31,6 +31,7 @@
 
 #include "Synth/Envelope.h"
 #include "Synth/ADnote.h"
+#include "Synth/UnisonKernels.h"
 #include "Synth/LFO.h"
 #include "DSP/Filter.h"
 #include "Params/ADnoteParameters.h"
@@ -120,6 +121,7 @@ ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool por
     , tSpot{0}
     , paramRNG{}
     , paramSeed{0}
+    , unisonSlot{}
     , oscposhi{}
     , oscposlo{}
     , oscfreqhi{}
@@ -131,6 +133,8 @@ ADnote::ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool por
     , unison_base_freq_rap{}
     , unison_freq_rap{}
     , unison_invert_phase{}
+    , unison_gainL{}
+    , unison_gainR{}
     , unison_vibrato{}
     , oldAmplitude{}
     , newAmplitude{}
@@ -196,22 +200,32 @@ ADnote::ADnote(ADnote *topVoice_, float freq_,
 
 
 
-namespace{ // Array-cloning helper
-    template<typename VAL>
-    using VoiceUnisonArray = std::array<unique_ptr<VAL[]>, NUM_VOICES>;
-
-    template<typename OBJ, typename VAL>
-    inline void cloneArray(VoiceUnisonArray<VAL> OBJ::*arrMember
-                          ,OBJ& newData, OBJ const& oldData
-                          ,size_t voice, size_t unisonSiz)
-    {
-        using Arr = VoiceUnisonArray<VAL>;
-        Arr const& oldArray = oldData.*arrMember;
-        Arr&       newArray = newData.*arrMember;
-
-        newArray[voice].reset(new VAL[unisonSiz]);
-        memcpy(newArray[voice].get(), oldArray[voice].get(), unisonSiz * sizeof(VAL));
-    }
+/* All unison arrays of the note; see allocateUnisonState() */
+template<class FUN>
+inline void ADnote::forEachUnisonArray(FUN fun)
+{
+    fun(oscposhi);
+    fun(oscposlo);
+    fun(oscfreqhi);
+    fun(oscfreqlo);
+    fun(oscposhiFM);
+    fun(oscposloFM);
+    fun(oscfreqhiFM);
+    fun(oscfreqloFM);
+    fun(unison_base_freq_rap);
+    fun(unison_freq_rap);
+    fun(unison_invert_phase);
+    fun(unison_gainL);
+    fun(unison_gainR);
+    fun(unison_vibrato.step);
+    fun(unison_vibrato.position);
+    fun(fm_oldSmp);
+    fun(fmfm_oldPhase);
+    fun(fmfm_oldPMod);
+    fun(fmfm_oldInterpPhase);
+    fun(fm_oldOscPhase);
+    fun(fm_oldOscPMod);
+    fun(fm_oldOscInterpPhase);
 }
 
 // Copy constructor, used only used for legato (as of 4/2022)
@@ -258,6 +272,15 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
     memcpy(unison_stereo_spread, orig.unison_stereo_spread, sizeof(unison_stereo_spread));
     memcpy(freqbasedmod, orig.freqbasedmod, sizeof(freqbasedmod));
 
+    // unison state: same layout, thus can be copied as a whole
+    memcpy(unisonSlot, orig.unisonSlot, sizeof(unisonSlot));
+    allocateUnisonState();
+    memcpy(unisonBlock.get(), orig.unisonBlock.get(), unisonBlock.size());
+    memcpy(unison_vibrato.amplitude, orig.unison_vibrato.amplitude, sizeof(unison_vibrato.amplitude));
+    for (int voice = 0; voice < NUM_VOICES; ++voice)
+        if (!orig.oscposhi[voice])
+            forEachUnisonArray([voice](auto& array){ array[voice] = nullptr; }); // killed voice
+
     allocateUnison(max_unison, synth.buffersize);
 
     for (int voice = 0; voice < NUM_VOICES; ++voice)
@@ -357,51 +380,9 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
 
         // NoteVoicePar done
 
-        int unison = unison_size[voice];
-
-        cloneArray(&ADnote::oscposhi, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscposlo, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscfreqhi, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscfreqlo, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscposhiFM, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscposloFM, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscfreqhiFM, *this, orig, voice, unison);
-        cloneArray(&ADnote::oscfreqloFM, *this, orig, voice, unison);
-
-        cloneArray(&ADnote::unison_base_freq_rap,*this, orig, voice, unison);
-        cloneArray(&ADnote::unison_freq_rap,     *this, orig, voice, unison);
-        cloneArray(&ADnote::unison_invert_phase, *this, orig, voice, unison);
-
-        unison_vibrato[voice].amplitude = orig.unison_vibrato[voice].amplitude;
-
-        unison_vibrato[voice].step.reset(new float[unison]);
-        memcpy(unison_vibrato[voice].step.get(), orig.unison_vibrato[voice].step.get(), unison * sizeof(float));
-
-        unison_vibrato[voice].position.reset(new float[unison]);
-        memcpy(unison_vibrato[voice].position.get(), orig.unison_vibrato[voice].position.get(), unison * sizeof(float));
-
-        cloneArray(&ADnote::fm_oldSmp, *this, orig, voice, unison);
-
-        if (parentFMmod != NULL)
-        {
-            if (NoteVoicePar[voice].fmEnabled == FREQ_MOD)
-            {
-                cloneArray(&ADnote::fmfm_oldPhase, *this, orig, voice, unison);
-                cloneArray(&ADnote::fmfm_oldPMod, *this, orig, voice, unison);
-                cloneArray(&ADnote::fmfm_oldInterpPhase, *this, orig, voice, unison);
-            }
-
-            if (forFM)
-            {
-                cloneArray(&ADnote::fm_oldOscPhase, *this, orig, voice, unison);
-                cloneArray(&ADnote::fm_oldOscPMod, *this, orig, voice, unison);
-                cloneArray(&ADnote::fm_oldOscInterpPhase, *this, orig, voice, unison);
-            }
-        }
-
         if (orig.subVoice[voice])
         {
-            subVoice[voice].reset(new unique_ptr<ADnote>[orig.unison_size[voice]]);
+            subVoice[voice].reset(orig.unison_size[voice]);
             for (size_t k = 0; k < orig.unison_size[voice]; ++k)
                 subVoice[voice][k].reset(new ADnote(*orig.subVoice[voice][k]
                                                , topVoice
@@ -411,7 +392,7 @@ ADnote::ADnote(ADnote const& orig, ADnote *topVoice_, float *parentFMmod_)
 
         if (orig.subFMVoice[voice])
         {
-            subFMVoice[voice].reset(new unique_ptr<ADnote>[orig.unison_size[voice]]);
+            subFMVoice[voice].reset(orig.unison_size[voice]);
             for (size_t k = 0; k < orig.unison_size[voice]; ++k)
             {
                 subFMVoice[voice][k].reset(new ADnote(*orig.subFMVoice[voice][k]
@@ -509,32 +490,38 @@ void ADnote::construct(size_t unison_total_size)
 
         // compute unison
         unison_size[nvoice] = unison;
+    }
 
-        unison_base_freq_rap[nvoice].reset(new float[unison]{0});
-        unison_freq_rap     [nvoice].reset(new float[unison]{0});
-        unison_invert_phase [nvoice].reset(new bool[unison]{false});
-        unison_vibrato[nvoice].step .reset(new float[unison]{0});
-        unison_vibrato[nvoice].position.reset(new float[unison]{0});
+    layoutUnisonState();
+    allocateUnisonState();
+
+    for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+    {
+        if (!NoteVoicePar[nvoice].enabled)
+            continue;
+
+        int unison = unison_size[nvoice];
+        bool is_pwm = adpars.VoicePar[nvoice].PFMEnabled == PW_MOD;
 
         if (unison >> is_pwm > 1)
         {
             for (int k = 0; k < unison; ++k)
             {
-                unison_vibrato[nvoice].position[k] = synth.numRandom() * 1.8f - 0.9f;
+                unison_vibrato.position[nvoice][k] = synth.numRandom() * 1.8f - 0.9f;
 
                 // Give step a random direction. The amplitude doesn't matter right
                 // now, only the sign, which will be preserved in
                 // computeNoteParameters().
                 if (synth.numRandom() < 0.5f)
-                    unison_vibrato[nvoice].step[k] = -1.0f;
+                    unison_vibrato.step[nvoice][k] = -1.0f;
                 else
-                    unison_vibrato[nvoice].step[k] = 1.0f;
+                    unison_vibrato.step[nvoice][k] = 1.0f;
 
                 if (is_pwm)
                 {
                     // Set the next position the same as this one.
-                    unison_vibrato[nvoice].position[k+1] =
-                        unison_vibrato[nvoice].position[k];
+                    unison_vibrato.position[nvoice][k+1] =
+                        unison_vibrato.position[nvoice][k];
                     ++k; // Skip an iteration.
                     // step and amplitude are handled in computeNoteParameters.
                 }
@@ -544,23 +531,14 @@ void ADnote::construct(size_t unison_total_size)
         {
             if (is_pwm)
             {
-                unison_vibrato[nvoice].position[1] = 0.0f;
+                unison_vibrato.position[nvoice][1] = 0.0f;
             }
             if (is_pwm || unison == 1)
             {
-                unison_vibrato[nvoice].position[0] = 0.0f;
+                unison_vibrato.position[nvoice][0] = 0.0f;
             }
         }
 
-        oscposhi[nvoice].reset(new int[unison]{0});// zero-init
-        oscposlo[nvoice].reset(new float[unison]{0});
-        oscfreqhi[nvoice].reset(new int[unison]{0});
-        oscfreqlo[nvoice].reset(new float[unison]{0});
-        oscposhiFM[nvoice].reset(new int[unison]{0});
-        oscposloFM[nvoice].reset(new float[unison]{0});
-        oscfreqhiFM[nvoice].reset(new int[unison]{0});
-        oscfreqloFM[nvoice].reset(new float[unison]{0});
-
         NoteVoicePar[nvoice].voice = adpars.VoicePar[nvoice].PVoice;
 
         int vc = nvoice;
@@ -621,25 +599,10 @@ void ADnote::construct(size_t unison_total_size)
         NoteVoicePar[nvoice].fmRingToSide = adpars.VoicePar[nvoice].PFMringToSide;
         NoteVoicePar[nvoice].fmVoice = adpars.VoicePar[nvoice].PFMVoice;
 
-        fm_oldSmp[nvoice].reset(new float [unison]{0}); // zero init
-
         firsttick[nvoice] = 1;
         NoteVoicePar[nvoice].delayTicks =
             (int)((expf(adpars.VoicePar[nvoice].PDelay / 127.0f
             * logf(50.0f)) - 1.0f) / synth.fixed_sample_step_f / 10.0f);
-
-        if (parentFMmod != NULL && NoteVoicePar[nvoice].fmEnabled == FREQ_MOD)
-        {
-            fmfm_oldPhase[nvoice].reset(new float [unison]{0}); // zero init
-            fmfm_oldPMod [nvoice].reset(new float [unison]{0});
-            fmfm_oldInterpPhase[nvoice].reset(new float [unison]{0});
-        }
-        if (parentFMmod != NULL && forFM)
-        {
-            fm_oldOscPhase[nvoice].reset(new float [unison]{0}); // zero init
-            fm_oldOscPMod [nvoice].reset(new float [unison]{0});
-            fm_oldOscInterpPhase[nvoice].reset(new float [unison]{0});
-        }
     }
 
     max_unison = 1;
@@ -660,8 +623,8 @@ void ADnote::construct(size_t unison_total_size)
 
 void ADnote::allocateUnison(size_t unisonCnt, size_t buffSize)
 {
-    tmpwave_unison.reset(new Samples[unisonCnt]);
-    tmpmod_unison .reset(new Samples[unisonCnt]);
+    tmpwave_unison.reset(unisonCnt);
+    tmpmod_unison .reset(unisonCnt);
     for (size_t k = 0; k < unisonCnt; ++k)
     {
         tmpwave_unison[k].reset(buffSize);
@@ -669,6 +632,39 @@ void ADnote::allocateUnison(size_t unisonCnt, size_t buffSize)
     }
 }
 
+// Each enabled voice gets arrays for its unison size, padded to full cache lines
+void ADnote::layoutUnisonState()
+{
+    const size_t LINE = PooledBlock::CACHE_LINE;
+    for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+        unisonSlot[nvoice] = NoteVoicePar[nvoice].enabled? (unison_size[nvoice] * sizeof(float) + LINE - 1) / LINE * LINE
+                                                         : 0;
+}
+
+// Carve all unison arrays from one zero-initialised block, according to the layout
+void ADnote::allocateUnisonState()
+{
+    size_t voiceBytes = 0;
+    for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+        voiceBytes += unisonSlot[nvoice];
+    size_t arrays = 0;
+    forEachUnisonArray([&](auto&){ ++arrays; });
+    assert(arrays == NotePool::UNISON_ARRAYS);
+    unisonBlock.reset(arrays * voiceBytes);
+
+    char* next = unisonBlock.get();
+    forEachUnisonArray([&](auto& array)
+    {
+        using Elm = std::remove_pointer_t<typename std::decay_t<decltype(array)>::value_type>;
+        static_assert(sizeof(Elm) <= sizeof(float));
+        for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+        {
+            array[nvoice] = unisonSlot[nvoice]? reinterpret_cast<Elm*>(next) : nullptr;
+            next += unisonSlot[nvoice];
+        }
+    });
+}
+
 void ADnote::initSubVoices(size_t unison_total_size)
 {
     for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
@@ -680,7 +676,7 @@ void ADnote::initSubVoices(size_t unison_total_size)
         {
             computePhaseOffsets(nvoice);
 
-            subVoice[nvoice].reset(new unique_ptr<ADnote>[unison_size[nvoice]]);
+            subVoice[nvoice].reset(unison_size[nvoice]);
             for (size_t k = 0; k < unison_size[nvoice]; ++k)
             {
                 float *freqmod = freqbasedmod[nvoice] ? tmpmod_unison[k].get() : parentFMmod;
@@ -698,7 +694,7 @@ void ADnote::initSubVoices(size_t unison_total_size)
             computeFMPhaseOffsets(nvoice);
 
             bool voiceForFM = NoteVoicePar[nvoice].fmEnabled == FREQ_MOD;
-            subFMVoice[nvoice].reset(new unique_ptr<ADnote>[unison_size[nvoice]]);
+            subFMVoice[nvoice].reset(unison_size[nvoice]);
             for (size_t k = 0; k < unison_size[nvoice]; ++k)
             {
                 subFMVoice[nvoice][k].reset(new ADnote(topVoice,
@@ -802,22 +798,8 @@ void ADnote::legatoFadeOut()
 // Kill a voice of ADnote
 void ADnote::killVoice(int nvoice)
 {
-    oscposhi[nvoice].reset();
-    oscposlo[nvoice].reset();
-    oscfreqhi[nvoice].reset();
-    oscfreqlo[nvoice].reset();
-    oscposhiFM[nvoice].reset();
-    oscposloFM[nvoice].reset();
-    oscfreqhiFM[nvoice].reset();
-    oscfreqloFM[nvoice].reset();
-
-    unison_base_freq_rap[nvoice].reset();
-    unison_freq_rap[nvoice].reset();
-    unison_invert_phase[nvoice].reset();
-    fm_oldSmp[nvoice].reset();
-
-    unison_vibrato[nvoice].step.reset();
-    unison_vibrato[nvoice].position.reset();
+    // storage stays within the unisonBlock until the note is discarded
+    forEachUnisonArray([nvoice](auto& array){ array[nvoice] = nullptr; });
 
     subVoice[nvoice].reset();
     subFMVoice[nvoice].reset();
@@ -837,19 +819,6 @@ void ADnote::killVoice(int nvoice)
         memset(NoteVoicePar[nvoice].voiceOut.get(), 0, synth.bufferbytes);
         // do not delete, yet: perhaps is used by another voice
 
-    if (parentFMmod != NULL && NoteVoicePar[nvoice].fmEnabled == FREQ_MOD)
-    {
-        fmfm_oldPhase[nvoice].reset();
-        fmfm_oldPMod[nvoice].reset();
-        fmfm_oldInterpPhase[nvoice].reset();
-    }
-    if (parentFMmod != NULL && forFM)
-    {
-        fm_oldOscPhase[nvoice].reset();
-        fm_oldOscPMod[nvoice].reset();
-        fm_oldOscInterpPhase[nvoice].reset();
-    }
-
     NoteVoicePar[nvoice].enabled = false;
 }
 
@@ -1258,7 +1227,7 @@ void ADnote::computeNoteParameters()
                     1.0f + (unison_base_freq_rap[nvoice][k] - 1.0f)
                     * (1.0f - unison_vibrato_a);
 
-            unison_vibrato[nvoice].amplitude = (unison_real_spread - 1.0f) * unison_vibrato_a;
+            unison_vibrato.amplitude[nvoice] = (unison_real_spread - 1.0f) * unison_vibrato_a;
 
             float increments_per_second = 1 / synth.fixed_sample_step_f;
             const float vib_speed = adpars.VoicePar[nvoice].Unison_vibrato_speed / 127.0f;
@@ -1268,27 +1237,27 @@ void ADnote::computeNoteParameters()
                 // make period to vary randomly from 50% to 200% vibrato base period
                 float vibrato_period = vibrato_base_period * power<2>(paramRNG.numRandom() * 2.0f - 1.0f);
                 float m = 4.0f / (vibrato_period * increments_per_second);
-                if (unison_vibrato[nvoice].step[k] < 0.0f)
+                if (unison_vibrato.step[nvoice][k] < 0.0f)
                     m = -m;
-                unison_vibrato[nvoice].step[k] = m;
+                unison_vibrato.step[nvoice][k] = m;
 
                 if (is_pwm)
                 {
                     // Set the next position the same as this one.
-                    unison_vibrato[nvoice].step[k+1] =
-                        unison_vibrato[nvoice].step[k];
+                    unison_vibrato.step[nvoice][k+1] =
+                        unison_vibrato.step[nvoice][k];
                     ++k; // Skip an iteration.
                 }
             }
         }
         else // No vibrato for a single voice
         {
-            unison_vibrato[nvoice].step[0] = 0.0f;
-            unison_vibrato[nvoice].amplitude = 0.0f;
+            unison_vibrato.step[nvoice][0] = 0.0f;
+            unison_vibrato.amplitude[nvoice] = 0.0f;
 
             if (is_pwm)
             {
-                unison_vibrato[nvoice].step[1]     = 0.0f;
+                unison_vibrato.step[nvoice][1]     = 0.0f;
             }
         }
 
@@ -1315,6 +1284,7 @@ void ADnote::computeNoteParameters()
                     break;
             }
         }
+        computeUnisonPanning(nvoice);
     }
 }
 
@@ -1390,8 +1360,8 @@ void ADnote::computeUnisonFreqRap(int nvoice)
     float relbw = ctl.bandwidth.relbw * bandwidthDetuneMultiplier;
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        float pos  = unison_vibrato[nvoice].position[k];
-        float step = unison_vibrato[nvoice].step[k];
+        float pos  = unison_vibrato.position[nvoice][k];
+        float step = unison_vibrato.step[nvoice][k];
         pos += step;
         if (pos <= -1.0f)
         {
@@ -1407,10 +1377,10 @@ void ADnote::computeUnisonFreqRap(int nvoice)
             (pos - 0.333333333f * pos * pos * pos) * 1.5f; // make the vibrato lfo smoother
         unison_freq_rap[nvoice][k] =
             1.0f + ((unison_base_freq_rap[nvoice][k] - 1.0f)
-            + vibrato_val * unison_vibrato[nvoice].amplitude) * relbw;
+            + vibrato_val * unison_vibrato.amplitude[nvoice]) * relbw;
 
-        unison_vibrato[nvoice].position[k] = pos;
-        step = unison_vibrato[nvoice].step[k] = step;
+        unison_vibrato.position[nvoice][k] = pos;
+        step = unison_vibrato.step[nvoice][k] = step;
     }
 }
 
@@ -1697,42 +1667,22 @@ void ADnote::fadein(Samples& smps)
  * Computes the Oscillator (Without Modulation) - LinearInterpolation
  */
 
-/* As the code here is a bit odd due to optimization, here is what happens
- * First the current position and frequency are retrieved from the running
- * state. These are broken up into high and low portions to indicate how many
- * samples are skipped in one step and how many fractional samples are skipped.
- * Outside of this method the fractional samples are just handled with floating
- * point code, but that's a bit slower than it needs to be. In this code the low
- * portions are known to exist between 0.0 and 1.0 and it is known that they are
- * stored in single precision floating point IEEE numbers. This implies that
- * a maximum of 24 bits are significant. The below code does your standard
- * linear interpolation that you'll see throughout this codebase, but by
- * sticking to integers for tracking the overflow of the low portion, around 15%
- * of the execution time was shaved off in the ADnote test.
+/* The current position and frequency are retrieved from the running state.
+ * These are broken up into high and low portions to indicate how many samples
+ * are skipped in one step and how many fractional samples are skipped.
+ * The low portions are known to exist between 0.0 and 1.0 and are tracked
+ * as 24 bit integers, which shaved off around 15% of the execution time in
+ * the ADnote test. See UnisonKernels.cpp for the vectorised loop.
  */
 inline void ADnote::computeVoiceOscillatorLinearInterpolation(int nvoice)
 {
     fft::Waveform const& smps = NoteVoicePar[nvoice].oscilSmp;
 
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
-    {
-        int    poshi  = oscposhi[nvoice][k];
-        int    poslo  = oscposlo[nvoice][k] * (1<<24);
-        int    freqhi = oscfreqhi[nvoice][k];
-        int    freqlo = oscfreqlo[nvoice][k] * (1<<24);
-        Samples& tw   = tmpwave_unison[k];
-        assert(oscfreqlo[nvoice][k] < 1.0f);
-        for (int i = 0; i < synth.sent_buffersize; ++i)
-        {
-            tw[i]  = (smps[poshi] * ((1<<24) - poslo) + smps[poshi + 1] * poslo)/(1.0f*(1<<24));
-            poslo += freqlo;
-            poshi += freqhi + (poslo>>24);
-            poslo &= 0xffffff;
-            poshi &= synth.oscilsize - 1;
-        }
-        oscposhi[nvoice][k] = poshi;
-        oscposlo[nvoice][k] = poslo/(1.0f*(1<<24));
-    }
+        unison::interpolateLinear(&smps[0], synth.oscilsize
+                                 ,oscposhi[nvoice][k], oscposlo[nvoice][k]
+                                 ,oscfreqhi[nvoice][k], oscfreqlo[nvoice][k]
+                                 ,tmpwave_unison[k].get(), synth.sent_buffersize);
 }
 
 // end of port
@@ -1747,8 +1697,8 @@ void ADnote::applyVoiceOscillatorMorph(int nvoice)
 
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples&  tw = tmpwave_unison[k];
-        Samples& mod = tmpmod_unison[k];
+        PooledSamples&  tw = tmpwave_unison[k];
+        PooledSamples& mod = tmpmod_unison[k];
 
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
@@ -1772,8 +1722,8 @@ void ADnote::applyVoiceOscillatorRingModulation(int nvoice)
         fm_oldAmplitude[nvoice] = 1.0f;
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples&  tw = tmpwave_unison[k];
-        Samples& mod = tmpmod_unison[k];
+        PooledSamples&  tw = tmpwave_unison[k];
+        PooledSamples& mod = tmpmod_unison[k];
 
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
@@ -1799,7 +1749,7 @@ void ADnote::computeVoiceModulator(int nvoice, int FMmode)
         {
             // Sub voices use voiceOut, so just pass NULL.
             subFMVoice[nvoice][k]->noteout(NULL, NULL);
-            Samples const& smps = subFMVoice[nvoice][k]->NoteVoicePar[subVoiceNumber].voiceOut;
+            PooledSamples const& smps = subFMVoice[nvoice][k]->NoteVoicePar[subVoiceNumber].voiceOut;
             // For historical/compatibility reasons we do not reduce volume here
             // if are using stereo. See same section in computeVoiceOscillator.
             memcpy(tmpmod_unison[k].get(), smps.get(), synth.bufferbytes);
@@ -1838,7 +1788,7 @@ void ADnote::applyAmplitudeOnVoiceModulator(int nvoice)
     {
         for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& unison = tmpmod_unison[k];
+            PooledSamples& unison = tmpmod_unison[k];
             for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
                 unison[i] *= interpolateAmplitude(fm_oldAmplitude[nvoice],
                                                   fm_newAmplitude[nvoice], i,
@@ -1849,7 +1799,7 @@ void ADnote::applyAmplitudeOnVoiceModulator(int nvoice)
     {
         for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& unison = tmpmod_unison[k];
+            PooledSamples& unison = tmpmod_unison[k];
             for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
                 unison[i] *= fm_newAmplitude[nvoice];
         }
@@ -1863,7 +1813,7 @@ void ADnote::normalizeVoiceModulatorFrequencyModulation(int nvoice, int FMmode)
     { // PWM modulation
         for (size_t k = 1; k < unison_size[nvoice]; k += 2)
         {
-            Samples& unison = tmpmod_unison[k];
+            PooledSamples& unison = tmpmod_unison[k];
             for (size_t i = 1; i < size_t(synth.sent_buffersize); ++i)
                 unison[i] = -unison[i];
         }
@@ -1874,7 +1824,7 @@ void ADnote::normalizeVoiceModulatorFrequencyModulation(int nvoice, int FMmode)
     {
         for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& tw = tmpmod_unison[k];
+            PooledSamples& tw = tmpmod_unison[k];
             float fmold = fm_oldSmp[nvoice][k];
             for (int i = 0; i < synth.sent_buffersize; ++i)
             {
@@ -1888,7 +1838,7 @@ void ADnote::normalizeVoiceModulatorFrequencyModulation(int nvoice, int FMmode)
     {
         for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& tw = tmpmod_unison[k];
+            PooledSamples& tw = tmpmod_unison[k];
             for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
                 tw[i] *= synth.oscil_norm_factor_pm;
         }
@@ -1901,7 +1851,7 @@ void ADnote::normalizeVoiceModulatorFrequencyModulation(int nvoice, int FMmode)
         float *tmp = parentFMmod;
         for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& tw = tmpmod_unison[k];
+            PooledSamples& tw = tmpmod_unison[k];
             for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
                 tw[i] += tmp[i];
         }
@@ -1920,7 +1870,7 @@ void ADnote::computeVoiceModulatorLinearInterpolation(int nvoice)
         float posloFM   =  oscposloFM[nvoice][k];
         int freqhiFM    = oscfreqhiFM[nvoice][k];
         float freqloFM  = oscfreqloFM[nvoice][k];
-        Samples& unison = tmpmod_unison[k];
+        PooledSamples& unison = tmpmod_unison[k];
 
         for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
         {
@@ -1949,7 +1899,7 @@ void ADnote::computeVoiceModulatorFrequencyModulation(int nvoice, int FMmode)
     // do the modulation using parent's modulator, onto a new modulator
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& unison = tmpmod_unison[k];
+        PooledSamples& unison = tmpmod_unison[k];
         int poshiFM    =  oscposhiFM[nvoice][k];
         float posloFM  =  oscposloFM[nvoice][k];
         int freqhiFM   = oscfreqhiFM[nvoice][k];
@@ -2020,7 +1970,7 @@ void ADnote::computeVoiceModulatorForFMFrequencyModulation(int nvoice)
 
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& unison = tmpmod_unison[k];
+        PooledSamples& unison = tmpmod_unison[k];
         int    poshiFM =  oscposhiFM[nvoice][k];
         float  posloFM =  oscposloFM[nvoice][k];
         int   freqhiFM = oscfreqhiFM[nvoice][k];
@@ -2102,7 +2052,7 @@ void ADnote::computeVoiceOscillatorFrequencyModulation(int nvoice)
     // do the modulation
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& unison = tmpwave_unison[k];
+        PooledSamples& unison = tmpwave_unison[k];
         int poshi    =  oscposhi[nvoice][k];
         float poslo  =  oscposlo[nvoice][k];
         int freqhi   = oscfreqhi[nvoice][k];
@@ -2154,7 +2104,7 @@ void ADnote::computeVoiceOscillatorForFMFrequencyModulation(int nvoice)
     // See computeVoiceModulatorForFMFrequencyModulation for details on how this works.
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& unison = tmpwave_unison[k];
+        PooledSamples& unison = tmpwave_unison[k];
         int poshi = oscposhi[nvoice][k];
         float poslo = oscposlo[nvoice][k];
         int freqhi = oscfreqhi[nvoice][k];
@@ -2236,7 +2186,7 @@ void ADnote::computeVoiceNoise(int nvoice)
 {
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& tw = tmpwave_unison[k];
+        PooledSamples& tw = tmpwave_unison[k];
         for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
             tw[i] = synth.numRandom() * 2.0f - 1.0f;
     }
@@ -2248,7 +2198,7 @@ void ADnote::ComputeVoicePinkNoise(int nvoice)
 {
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& tw = tmpwave_unison[k];
+        PooledSamples& tw = tmpwave_unison[k];
         float *f = &pinking[nvoice][k > 0 ? 7 : 0];
         for (int i = 0; i < synth.sent_buffersize; ++i)
         {
@@ -2274,8 +2224,8 @@ void ADnote::computeVoiceOscillator(int nvoice)
         {
             // Sub voices use voiceOut, so just pass NULL.
             subVoice[nvoice][k]->noteout(NULL, NULL);
-            Samples& smps = subVoice[nvoice][k]->NoteVoicePar[subVoiceNumber].voiceOut;
-            Samples& unison = tmpwave_unison[k];
+            PooledSamples& smps = subVoice[nvoice][k]->NoteVoicePar[subVoiceNumber].voiceOut;
+            PooledSamples& unison = tmpwave_unison[k];
             if (stereo)
             {
                 // Reduce volume due to stereo being combined to mono.
@@ -2335,7 +2285,7 @@ void ADnote::ComputeVoiceSpotNoise(int nvoice)
 {
     for (size_t k = 0; k < unison_size[nvoice]; ++k)
     {
-        Samples& unison = tmpwave_unison[k];
+        PooledSamples& unison = tmpwave_unison[k];
         for (size_t i = 0; i < size_t(synth.sent_buffersize); ++i)
         {
             if (tSpot <= 0)
@@ -2353,14 +2303,61 @@ void ADnote::ComputeVoiceSpotNoise(int nvoice)
 }
 
 
+// Stereo position and phase of each unison subvoice, as gain factors for the mix
+void ADnote::computeUnisonPanning(int nvoice)
+{
+    size_t unison = unison_size[nvoice];
+    bool is_pwm = NoteVoicePar[nvoice].fmEnabled == PW_MOD;
+    float stereo_spread = unison_stereo_spread[nvoice] * 2.0f; // between 0 and 2.0
+    for (size_t k = 0; k < unison; ++k)
+    {
+        float stereo_pos = 0.0f;
+        if (is_pwm)
+        {
+            if (unison > 2)
+                stereo_pos = k/2 / (float)((unison / 2) - 1) * 2.0f - 1.0f;
+        }
+        else if (unison > 1)
+            stereo_pos = (float) k / (float)(unison - 1) * 2.0f - 1.0f;
+        if (stereo_spread > 1.0f)
+        {
+            float stereo_pos_1 = (stereo_pos >= 0.0f) ? 1.0f : -1.0f;
+            stereo_pos = (2.0f - stereo_spread) * stereo_pos
+                          + (stereo_spread - 1.0f) * stereo_pos_1;
+        }
+        else
+            stereo_pos *= stereo_spread;
+
+        if (unison == 1 || (is_pwm && unison == 2))
+            stereo_pos = 0.0f;
+        float upan = (stereo_pos + 1.0f) * 0.5f;
+        float lvol = (1.0f - upan) * 2.0f;
+        if (lvol > 1.0f)
+            lvol = 1.0f;
+
+        float rvol = upan * 2.0f;
+        if (rvol > 1.0f)
+            rvol = 1.0f;
+
+        if (unison_invert_phase[nvoice][k])
+        {
+            lvol = -lvol;
+            rvol = -rvol;
+        }
+        unison_gainL[nvoice][k] = lvol;
+        unison_gainR[nvoice][k] = rvol;
+    }
+}
+
+
 // Compute the ADnote samples, returns 0 if the note is finished
 void ADnote::noteout(float *outl, float *outr)
 {
-    Config &Runtime = synth.getRuntime();
-    Samples& tmpwavel = Runtime.genTmp1;
-    Samples& tmpwaver = Runtime.genTmp2;
-    Samples& bypassl = Runtime.genTmp3;
-    Samples& bypassr = Runtime.genTmp4;
+    ScratchBuffers& scratch = synth.scratch();
+    Samples& tmpwavel = scratch.genTmp1;
+    Samples& tmpwaver = scratch.genTmp2;
+    Samples& bypassl = scratch.genTmp3;
+    Samples& bypassr = scratch.genTmp4;
     int i, nvoice;
     if (outl and outr)
     {
@@ -2393,62 +2390,15 @@ void ADnote::noteout(float *outl, float *outr)
         // Mix subvoices into voice
         memset(tmpwavel.get(), 0, synth.sent_bufferbytes);
         if (stereo)
-            memset(tmpwaver.get(), 0, synth.sent_bufferbytes);
-        for (size_t k = 0; k < unison_size[nvoice]; ++k)
         {
-            Samples& unison = tmpwave_unison[k];
-            if (stereo)
-            {
-                float stereo_pos = 0.0f;
-                bool is_pwm = NoteVoicePar[nvoice].fmEnabled == PW_MOD;
-                if (is_pwm)
-                {
-                    if (unison_size[nvoice] > 2)
-                        stereo_pos = k/2 / (float)((unison_size[nvoice] / 2) - 1) * 2.0f - 1.0f;
-                }
-                else
-                    if (unison_size[nvoice] > 1)
-                {
-                    stereo_pos = (float) k
-                        / (float)(unison_size[nvoice]
-                                  - 1) * 2.0f - 1.0f;
-                }
-                float stereo_spread = unison_stereo_spread[nvoice] * 2.0f; // between 0 and 2.0
-                if (stereo_spread > 1.0f)
-                {
-                    float stereo_pos_1 = (stereo_pos >= 0.0f) ? 1.0f : -1.0f;
-                    stereo_pos = (2.0f - stereo_spread) * stereo_pos
-                                  + (stereo_spread - 1.0f) * stereo_pos_1;
-                }
-                else
-                    stereo_pos *= stereo_spread;
-
-                if (unison_size[nvoice] == 1 || (is_pwm && unison_size[nvoice] == 2))
-                    stereo_pos = 0.0f;
-                float upan = (stereo_pos + 1.0f) * 0.5f;
-                float lvol = (1.0f - upan) * 2.0f;
-                if (lvol > 1.0f)
-                    lvol = 1.0f;
-
-                float rvol = upan * 2.0f;
-                if (rvol > 1.0f)
-                    rvol = 1.0f;
-
-                if (unison_invert_phase[nvoice][k])
-                {
-                    lvol = -lvol;
-                    rvol = -rvol;
-                }
-
-                for (i = 0; i < synth.sent_buffersize; ++i)
-                    tmpwavel[i] += unison[i] * lvol;
-                for (i = 0; i < synth.sent_buffersize; ++i)
-                    tmpwaver[i] += unison[i] * rvol;
-            }
-            else
-                for (i = 0; i < synth.sent_buffersize; ++i)
-                    tmpwavel[i] += unison[i];
+            memset(tmpwaver.get(), 0, synth.sent_bufferbytes);
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                unison::mixStereo(tmpwave_unison[k].get(), unison_gainL[nvoice][k], unison_gainR[nvoice][k]
+                                 ,tmpwavel.get(), tmpwaver.get(), synth.sent_buffersize);
         }
+        else
+            for (size_t k = 0; k < unison_size[nvoice]; ++k)
+                unison::mixMono(tmpwave_unison[k].get(), tmpwavel.get(), synth.sent_buffersize);
 
         // reduce the amplitude for large unison sizes
         float unison_amplitude = 1.0f / sqrtf(unison_size[nvoice]);
@@ -2679,6 +2629,16 @@ void ADnote::noteout(float *outl, float *outr)
         }
     }
 
+    // Stop a released note which stayed inaudible for a while,
+    // unless one of its voices is still waiting to start
+    if (subVoiceNr == -1 && noteStatus == NOTE_ENABLED
+        && noteGlobal.ampEnvelope->released() && !voicesDelayed()
+        && cull.silent(synth.noteCull, outl, outr, synth.sent_buffersize))
+    {
+        killNote();
+        return;
+    }
+
     // Check if the global amplitude is finished.
     // If it does, disable the note
     if (noteGlobal.ampEnvelope->finished())
@@ -2698,6 +2658,15 @@ void ADnote::noteout(float *outl, float *outr)
 }
 
 
+bool ADnote::voicesDelayed() const
+{
+    for (int nvoice = 0; nvoice < NUM_VOICES; ++nvoice)
+        if (NoteVoicePar[nvoice].enabled && NoteVoicePar[nvoice].delayTicks > 0)
+            return true;
+    return false;
+}
+
+
 // Release the key (NoteOff)
 void ADnote::releasekey()
 {
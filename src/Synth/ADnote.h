@@ -32,6 +32,8 @@
 #include "Misc/RandomGen.h"
 #include "DSP/FFTwrapper.h"
 #include "Misc/Alloc.h"
+#include "Misc/NotePool.h"
+#include "Synth/NoteCull.h"
 
 #include <memory>
 #include <array>
@@ -126,7 +128,7 @@ public:
 
 
 
-class ADnote
+class ADnote : public NotePooled
 {
         ADnote(ADnoteParameters& adpars_, Controller& ctl_, Note note_, bool portamento_
               ,ADnote *topVoice_, int subVoiceNr, int phaseOffset, float *parentFMmod_
@@ -146,6 +148,8 @@ class ADnote
         void noteout(float *outl, float *outr);
         void releasekey();
         bool finished() const { return noteStatus == NOTE_DISABLED; }
+        float getLevel() const { return noteStatus == NOTE_ENABLED? globalnewamplitude : 0.0f; } // of the amplitude envelope
+        bool culled() const { return cull.culled(); }
         void performPortamento(Note);
         void legatoFadeIn(Note);
         void legatoFadeOut();
@@ -154,6 +158,10 @@ class ADnote
     private:
         void construct(size_t unison_total_size);
         void allocateUnison(size_t unisonCnt, size_t buffSize);
+        void layoutUnisonState();
+        void allocateUnisonState();
+        template<class FUN>
+        void forEachUnisonArray(FUN);
 
         void setfreq(int nvoice, float in_freq, float pitchdetune);
         void setfreqFM(int nvoice, float in_freq, float pitchdetune);
@@ -174,9 +182,11 @@ class ADnote
         void initSubVoices(size_t unison_total_size);
         void killVoice(int nvoice);
         void killNote();
+        bool voicesDelayed() const;
         float getVoiceBaseFreq(int nvoice);
         float getFMVoiceBaseFreq(int nvoice);
         void computeVoiceOscillatorLinearInterpolation(int nvoice);
+        void computeUnisonPanning(int nvoice);
         void applyVoiceOscillatorMorph(int nvoice);
         void applyVoiceOscillatorRingModulation(int nvoice);
         void computeVoiceModulator(int nvoice, int FMmode);
@@ -214,6 +224,7 @@ class ADnote
             NOTE_ENABLED,
             NOTE_LEGATOFADEOUT
         } noteStatus;
+        NoteCull cull;
 
         // Global parameters
         struct ADnoteGlobal {
@@ -306,7 +317,7 @@ class ADnote
             bool   fmRingToSide;
             bool   fmFreqFixed;
             int    fmVoice;
-            Samples voiceOut;            // Voice Output used by other voices if use this as modulator
+            PooledSamples voiceOut;      // Voice Output used by other voices if use this as modulator
             SampleHolder fmSmp;          // Wave of the Voice. Shared by sub voices.
             int    fmPhaseOffset;
             float  fmVolume;
@@ -334,9 +345,14 @@ class ADnote
         float unison_stereo_spread[NUM_VOICES]; // stereo spread of unison subvoices (0.0=mono,1.0=max)
 
 
-        // Array-of dynamically allocated value-Arrays [voice][unison]
+        // Unison state as structure of arrays [voice][unison]:
+        // all arrays of the note are carved from a single block, aligned to cache lines,
+        // with the array for each voice padded to full cache lines (see allocateUnisonState).
+        // Voices not enabled have no arrays (NULL).
         template<typename T>
-        using VoiceUnisonArray = std::array<unique_ptr<T[]>, NUM_VOICES>;
+        using VoiceUnisonArray = std::array<T*, NUM_VOICES>;
+        PooledBlock unisonBlock;
+        size_t unisonSlot[NUM_VOICES]; // bytes per array for each voice
 
         // Wavetable reading position
         // *hi = skip/slot in the base wavetable
@@ -358,17 +374,19 @@ class ADnote
         VoiceUnisonArray<float> unison_base_freq_rap;// the unison base_value
         VoiceUnisonArray<float> unison_freq_rap;     // how the unison subvoice's frequency is changed (1.0 for no change)
         VoiceUnisonArray<bool>  unison_invert_phase; // which unison subvoice has phase inverted
+        VoiceUnisonArray<float> unison_gainL;        // stereo position and phase of the subvoice in the mix
+        VoiceUnisonArray<float> unison_gainR;
 
         // These are set by parent voices.
         float detuneFromParent;             // How much the voice should be detuned.
         float unisonDetuneFactorFromParent; // How much the voice should be detuned from unison.
 
         struct UnisonVibrato {
-            float  amplitude; // amplitude which be added to unison_freq_rap
-            unique_ptr<float[]> step;      // value which increments the position
-            unique_ptr<float[]> position;  // between -1.0 and 1.0
+            float amplitude[NUM_VOICES];       // amplitude which be added to unison_freq_rap
+            VoiceUnisonArray<float> step;      // value which increments the position
+            VoiceUnisonArray<float> position;  // between -1.0 and 1.0
         };
-        UnisonVibrato unison_vibrato[NUM_VOICES];
+        UnisonVibrato unison_vibrato;
 
         float oldAmplitude[NUM_VOICES];  // used to compute and interpolate the
         float newAmplitude[NUM_VOICES];  // amplitudes of voices and modulators
@@ -387,10 +405,10 @@ class ADnote
 
         bool forFM; // Whether this voice will be used for FM modulation.
 
-        unique_ptr<Samples[]> tmpwave_unison;
+        PooledArray<PooledSamples> tmpwave_unison;
         size_t max_unison;
 
-        unique_ptr<Samples[]> tmpmod_unison;
+        PooledArray<PooledSamples> tmpmod_unison;
         bool freqbasedmod[NUM_VOICES];
 
         float globaloldamplitude; // interpolate the amplitudes
@@ -410,8 +428,10 @@ class ADnote
         float pangainL;
         float pangainR;
 
-        VoiceUnisonArray<unique_ptr<ADnote>> subVoice;
-        VoiceUnisonArray<unique_ptr<ADnote>> subFMVoice;
+        // sub-notes for each unison subvoice [voice][unison]
+        using VoiceSubNotes = std::array<PooledArray<unique_ptr<ADnote>>, NUM_VOICES>;
+        VoiceSubNotes subVoice;
+        VoiceSubNotes subFMVoice;
 
         // Proxy-sub-Voice marker: -1 for ordinary (top-level) notes;
         // otherwise the Voice within the top-level note to attach to.
@@ -28,11 +28,12 @@
 
 #include "globals.h"
 #include "Params/ParamCheck.h"
+#include "Misc/NotePool.h"
 
 class EnvelopeParams;
 class SynthEngine;
 
-class Envelope
+class Envelope : public NotePooled
 {
     public:
         Envelope(EnvelopeParams *envpars, float basefreq_, SynthEngine *_synth);
@@ -41,6 +42,7 @@ class Envelope
         float envout();
         float envout_dB();
         int finished() { return envfinish; };
+        bool released() const { return keyreleased; }
 
     private:
         EnvelopeParams *_envpars;
@@ -30,10 +30,11 @@
 
 #include "Params/LFOParams.h"
 #include "Misc/NumericFuncs.h"
+#include "Misc/NotePool.h"
 
 class SynthEngine;
 
-class LFO
+class LFO : public NotePooled
 {
     public:
        ~LFO() = default;
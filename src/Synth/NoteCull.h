@@ -0,0 +1,78 @@
+/*
+    NoteCull.h - early retirement of inaudible notes
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef NOTECULL_H
+#define NOTECULL_H
+
+#include <cmath>
+
+#include "globals.h"
+
+
+/* A released note is normally computed until its amplitude envelope has
+ * finished, which for long release tails means many periods of output far
+ * below audibility. Each note engine feeds its final output through a
+ * NoteCull; once that stayed below the cull level for the cull time, the
+ * note is stopped. Held notes are never culled, since they may become
+ * audible again (voice delay, LFO, filter sweeps).
+ */
+class NoteCull
+{
+    public:
+        /* engine wide setting, owned by the SynthEngine */
+        struct Setting
+        {
+            float meanSquare{0};  // per sample and channel, relative to full scale
+            uint  frames{0};      // 0 means culling is disabled
+
+            void set(int level_dB, int time_ms, uint samplerate)
+            {
+                meanSquare = powf(10.0f, level_dB / 10.0f);
+                frames = uint(time_ms * 0.001f * samplerate);
+            }
+        };
+
+        bool culled() const { return retired; }
+
+        /* call with the note output of a period, when the key is released;
+         * returns true when the note shall be stopped now */
+        bool silent(Setting const& setting, float const* outl, float const* outr, int frames)
+        {
+            if (setting.frames == 0)
+                return false;
+            float sum = 0.0f;
+            for (int i = 0; i < frames; ++i)
+                sum += outl[i] * outl[i] + outr[i] * outr[i];
+            if (sum > setting.meanSquare * 2 * frames)
+            {
+                quietFrames = 0;
+                return false;
+            }
+            quietFrames += frames;
+            retired = quietFrames >= setting.frames;
+            return retired;
+        }
+
+    private:
+        uint quietFrames{0};
+        bool retired{false};
+};
+
+#endif /*NOTECULL_H*/
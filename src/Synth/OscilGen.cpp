@@ -51,6 +51,10 @@ namespace {// Implementation helpers
 
 
 OscilGen::OscilGen(fft::Calc& fft_, Resonance* res_, SynthEngine* _synth, OscilParameters* params_)
+    : OscilGen{fft_, res_, _synth, params_, false}
+{ }
+
+OscilGen::OscilGen(fft::Calc& fft_, Resonance* res_, SynthEngine* _synth, OscilParameters* params_, bool tableBuilder)
     : params{params_}
     , synth{_synth}
     , fft{fft_}
@@ -62,10 +66,31 @@ OscilGen::OscilGen(fft::Calc& fft_, Resonance* res_, SynthEngine* _synth, OscilP
     , randseed{1}
     , basePrng{}
     , harmonicPrng{}
+    , spectrumVersion{0}
+    , tables{}
+    , checkedTables{nullptr}
+    , checkedVersion{0}
+    , tablesMatching{false}
+    , freshTables{nullptr}
+    , retiredTables{nullptr}
+    , isTableBuilder{tableBuilder}
+    , tableBuilder{}
+    , builderBasefunc{tableBuilder? new fft::Spectrum(fft_.spectrumSize()) : nullptr}
+    , buildMtx{}
+    , buildDone{}
+    , buildQueued{false}
+    , buildAgain{false}
 {
     genDefaults();
 }
 
+OscilGen::~OscilGen()
+{
+    awaitTableBuilds();
+    delete freshTables.exchange(nullptr);
+    delete retiredTables.exchange(nullptr);
+}
+
 void OscilGen::changeParams(OscilParameters* params_)
 {
     params = params_;
@@ -666,7 +691,10 @@ void OscilGen::changebasefunction()
             fft.smps2freqs(tmpsmps, oscilSpectrum);
             oscilSpectrum.c(0) = 0.0f; // DC offset
         }
-        params->updatebasefuncSpectrum(oscilSpectrum);
+        if (isTableBuilder)
+            *builderBasefunc = oscilSpectrum;
+        else
+            params->updatebasefuncSpectrum(oscilSpectrum);
     }// note: no update in case of "user" base function
 
     oldbasefunc = params->Pcurrentbasefunc;
@@ -935,6 +963,16 @@ void OscilGen::shiftharmonics()
 }
 
 
+/* The table builder runs in background and thus keeps the base function
+ * spectrum it computed, instead of writing it into the shared parameters */
+fft::Spectrum const& OscilGen::basefuncSpectrum() const
+{
+    if (isTableBuilder && params->Pcurrentbasefunc != OSCILLATOR::wave::user)
+        return *builderBasefunc;
+    return params->getbasefuncSpectrum();
+}
+
+
 /* Brings the pseudo random generators within this OscilGen instance into a reproducible state.
  * The basePrng is (re)seeded through this function, called from prepare() and thus when a new
  * OscilGen instance is created, or when resetting to defaults prior to loading a preset.
@@ -956,7 +994,8 @@ void OscilGen::reseed(int value)
 void OscilGen::prepare()
 {
     // reseed local PRNGs from SynthEngine PRNG
-    reseed(synth->randomINT() + INT_MAX/2);
+    if (!isTableBuilder)
+        reseed(synth->randomINT() + INT_MAX/2);
 
     changebasefunction();
 
@@ -1011,6 +1050,7 @@ void OscilGen::prepare()
     }
     else
     {
+        fft::Spectrum const& basefunc = basefuncSpectrum();
         for (size_t j = 0; j < MAX_AD_HARMONICS; ++j)
         {
             if (params->Phmag[j] == 64)
@@ -1020,8 +1060,8 @@ void OscilGen::prepare()
                 size_t k = i * (j + 1);
                 if (k >= len)
                     break;
-                float a = params->getbasefuncSpectrum().c(i);
-                float b = params->getbasefuncSpectrum().s(i);
+                float a = basefunc.c(i);
+                float b = basefunc.s(i);
                 float c = hmag[j] * cosf(hphase[j] * k);
                 float d = hmag[j] * sinf(hphase[j] * k);
                 oscilSpectrum.c(k) += a * c - b * d;
@@ -1053,6 +1093,7 @@ void OscilGen::prepare()
 
     oldhmagtype = params->Phmagtype;
     oldharmonicshift = params->Pharmonicshift + params->Pharmonicshiftfirst * 256;
+    ++spectrumVersion;
 }
 
 
@@ -1165,7 +1206,72 @@ inline void adaptiveharmonic(Accessor spec, size_t size,
         }
     }
 }
-}//(End) implementation details (adaptive harmonics)
+
+/* Highest harmonic of the spectrum above the noise floor;
+ * buildSpectrum() uses harmonics up to spectrumSize - 2 */
+inline size_t highestHarmonic(fft::Spectrum const& spectrum)
+{
+    size_t top = spectrum.size() - 2;
+    float peak = 0.0f;
+    for (size_t i = 1; i <= top; ++i)
+        peak = std::max(peak, sqr(spectrum.c(i)) + sqr(spectrum.s(i)));
+    while (top > 1 && sqr(spectrum.c(top)) + sqr(spectrum.s(top)) <= peak * CUTOFF)
+        --top;
+    return top;
+}
+
+inline bool sameSpectrum(fft::Spectrum const& a, fft::Spectrum const& b)
+{
+    for (size_t i = 0; i <= a.size(); ++i)
+        if (a.c(i) != b.c(i) || a.s(i) != b.s(i))
+            return false;
+    return true;
+}
+
+// harmonic limits of the band-limited tables, perOctave steps below the top
+inline size_t gridLimit(size_t top, size_t perOctave, size_t step)
+{
+    return size_t(top * power<2>(-float(step) / perOctave));
+}
+
+inline size_t gridCount(size_t top, size_t perOctave)
+{
+    size_t cnt = 0;
+    size_t prev = top + 1;
+    for (size_t step = 0; ; ++step)
+    {
+        size_t limit = gridLimit(top, perOctave, step);
+        if (limit < 1)
+            return cnt;
+        if (limit < prev)
+            ++cnt;
+        prev = limit;
+    }
+}
+
+/* One table per semitone, unless the tables of one oscillator would exceed
+ * TABLE_MEMORY (large oscillator sizes with many harmonics); then coarser,
+ * down to one table per octave */
+const size_t TABLE_MEMORY = 2 << 20;
+
+inline size_t tableResolution(size_t top, size_t tableSize)
+{
+    for (size_t perOctave : {12, 6, 3, 2})
+        if (gridCount(top, perOctave) * tableSize * sizeof(float) <= TABLE_MEMORY)
+            return perOctave;
+    return 1;
+}
+
+// the limit of the table used for a note with this many harmonics below Nyquist
+inline size_t harmonicLimit(size_t top, size_t harmonics, size_t perOctave)
+{
+    size_t step = 0;
+    size_t limit = top;
+    while (limit > harmonics)
+        limit = gridLimit(top, perOctave, ++step);
+    return limit;
+}
+}//(End) implementation details (adaptive harmonics, band-limited tables)
 
 
 
@@ -1173,13 +1279,213 @@ inline void adaptiveharmonic(Accessor spec, size_t size,
 // Get the oscillator function
 void OscilGen::getWave(fft::Waveform& smps, float freqHz, bool applyResonance, bool forGUI)
 {
+    size_t maxHarmonic = SIZE_MAX;
+    if (!forGUI && tablesApplicable(applyResonance))
+    {
+        size_t harmonics = std::min(size_t(0.5f * synth->samplerate_f / freqHz), fft.spectrumSize() - 2);
+        if (getWaveFromTable(smps, harmonics))
+            return;
+        // until the tables are ready, band-limit the same way
+        size_t top = highestHarmonic(oscilSpectrum);
+        maxHarmonic = harmonicLimit(top, harmonics, tableResolution(top, fft.tableSize()));
+    }
     bool forPAD = false;
-    buildSpectrum(freqHz, applyResonance, forGUI, forPAD);
+    buildSpectrum(freqHz, applyResonance, forGUI, forPAD, maxHarmonic);
     fft.freqs2smps(outoscilSpectrum, smps);
     for (size_t i = 0; i < fft.tableSize(); ++i)
         smps[i] *= 0.25f; // correct the amplitude
 }
 
+
+/* The band-limited tables can be used when the spectrum is the same for each note;
+ * adaptive harmonics, per harmonic randomness and resonance are computed for each note.
+ */
+bool OscilGen::tablesApplicable(bool applyResonance) const
+{
+    return !params->Padaptiveharmonics
+        && params->Prand <= 64
+        && params->Pamprandtype == 0
+        && !(applyResonance && res && res->Penabled);
+}
+
+
+/* Note-on fast path: copy the band-limited table for the given number of harmonics
+ * below Nyquist. Returns false while no tables for the current spectrum are ready.
+ * Called from the audio thread only; neither allocates nor frees memory.
+ */
+bool OscilGen::getWaveFromTable(fft::Waveform& smps, size_t harmonics)
+{
+    if (!retiredTables.load(std::memory_order_acquire))
+        if (OscilTables* fresh = freshTables.exchange(nullptr, std::memory_order_acq_rel))
+        {   // the former tables will be deleted by the background build
+            retiredTables.store(tables.release(), std::memory_order_release);
+            tables.reset(fresh);
+        }
+
+    prepareIfChanged();
+    if (!tablesMatch())
+        return false;
+    fft::Waveform const* table = tables->select(harmonics);
+    if (!table)
+        return false;
+    smps = *table;
+    return true;
+}
+
+
+/* Tables are valid if rendered from exactly the current spectrum;
+ * compared only after a change of either */
+bool OscilGen::tablesMatch()
+{
+    if (!tables)
+        return false;
+    if (checkedTables != tables.get() || checkedVersion != spectrumVersion)
+    {
+        checkedTables = tables.get();
+        checkedVersion = spectrumVersion;
+        tablesMatching = sameSpectrum(tables->source, oscilSpectrum);
+    }
+    return tablesMatching;
+}
+
+
+/* Request (re)building the tables in background from the current parameters.
+ * To be called from the non-audio side after parameters have changed; while
+ * a build is underway, it is repeated when done.
+ */
+void OscilGen::requestTables(task::Priority prio)
+{
+    delete retiredTables.exchange(nullptr, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock{buildMtx};
+        if (buildQueued)
+        {
+            buildAgain = true;
+            return;
+        }
+        buildQueued = true;
+    }
+    task::RunnerBackend::schedule([this]{ runTableBuilds(); }, prio);
+}
+
+
+void OscilGen::runTableBuilds()
+{
+    if (!tableBuilder)
+        tableBuilder.reset(new OscilGen{fft, res, synth, params, true});
+    std::unique_lock<std::mutex> lock{buildMtx};
+    do
+    {
+        buildAgain = false;
+        lock.unlock();
+        publishTables(renderTables());
+        lock.lock();
+    }
+    while (buildAgain);
+    buildQueued = false;
+    buildDone.notify_all();
+}
+
+
+void OscilGen::awaitTableBuilds()
+{
+    std::unique_lock<std::mutex> lock{buildMtx};
+    while (buildQueued)
+    {
+        if (task::RunnerBackend::isWorker())
+        {   // the build may be queued behind the caller
+            lock.unlock();
+            task::RunnerBackend::helpOut();
+            lock.lock();
+        }
+        else
+            buildDone.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+
+/* Hand new tables over to the audio thread; tables it has not picked up,
+ * and those it has replaced, are deleted here in background */
+void OscilGen::publishTables(OscilTables* newTables)
+{
+    delete freshTables.exchange(newTables, std::memory_order_acq_rel);
+    delete retiredTables.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+
+/* Render the band-limited tables (in background), from the spectrum the
+ * table builder computes for the current parameters. Tables above the highest
+ * audible harmonic would all be the same and are thus omitted, so a sine needs
+ * only one table. Each table is computed exactly like getWave() does for a note
+ * with this harmonic limit, thus switching to the tables is seamless.
+ */
+OscilTables* OscilGen::renderTables()
+{
+    tableBuilder->prepare();
+    fft::Spectrum const& source = tableBuilder->oscilSpectrum;
+    size_t specLen = fft.spectrumSize();
+    std::unique_ptr<OscilTables> newTables{new OscilTables(specLen)};
+    newTables->source = source;
+
+    size_t top = highestHarmonic(source);
+    size_t perOctave = tableResolution(top, fft.tableSize());
+    for (size_t step = 0; ; ++step)
+    {
+        size_t limit = gridLimit(top, perOctave, step);
+        if (limit < 1)
+            break;
+        if (newTables->limit.empty() || limit < newTables->limit.back())
+            newTables->limit.push_back(limit);
+    }
+    newTables->waves.reserve(newTables->limit.size());
+    for (size_t i = 0; i < newTables->limit.size(); ++i)
+        newTables->waves.emplace_back(fft.tableSize());
+
+    task::parallelFor(newTables->limit.size(), [&](size_t tabNr)
+    {
+        size_t limit = newTables->limit[tabNr];
+        fft::Spectrum spectrum(specLen);
+        for (size_t i = 1; i <= limit; ++i)
+        {
+            spectrum.c(i) = source.c(i);
+            spectrum.s(i) = source.s(i);
+        }
+        // Full RMS normalize, as in buildSpectrum()
+        float sum = 0;
+        for (size_t j = 1; j < specLen; ++j)
+            sum += sqr(spectrum.c(j)) + sqr(spectrum.s(j));
+        if (sum < CUTOFF)
+            sum = 1.0f;
+        sum = 1.0f / sqrtf(sum);
+        for (size_t j = 1; j < specLen; ++j)
+        {
+            spectrum.c(j) *= sum;
+            spectrum.s(j) *= sum;
+        }
+
+        fft::Waveform& wave = newTables->waves[tabNr];
+        fft.freqs2smps(spectrum, wave);
+        for (size_t i = 0; i < fft.tableSize(); ++i)
+            wave[i] *= 0.25f; // correct the amplitude
+        wave.fillInterpolationBuffer();
+    });
+    return newTables.release();
+}
+
+
+/* Render and install the tables right away; used to make the following
+ * notes independent of background timing. Not while the engine is running. */
+void OscilGen::buildTables()
+{
+    awaitTableBuilds();
+    if (!tableBuilder)
+        tableBuilder.reset(new OscilGen{fft, res, synth, params, true});
+    delete freshTables.exchange(nullptr);
+    delete retiredTables.exchange(nullptr);
+    tables.reset(renderTables());
+}
+
+
 // Get the current spectrum for rendering in PADSynth (synth->halfoscilsize)
 // Note: Spectrum slot=0 (DC-Offset) will be discarded.
 //       In the result, index=0 is the fundamental.
@@ -1204,9 +1510,9 @@ vector<float> OscilGen::getSpectrumForPAD(float freqHz)
 // - typically invoked for each buffer to generate the Wavetable
 //   including current phase randomisation
 // - also used to generate the base spectrum for PADsynth
-void OscilGen::buildSpectrum(float freqHz, bool applyResonance, bool forGUI, bool forPAD)
+// Invoke prepare() when any parameter shaping the raw spectrum has changed
+void OscilGen::prepareIfChanged()
 {
-    assert(freqHz > 0.0);
     if (oldbasepar != params->Pbasefuncpar
         || oldbasefunc != params->Pcurrentbasefunc
         || oldhmagtype != params->Phmagtype
@@ -1243,6 +1549,13 @@ void OscilGen::buildSpectrum(float freqHz, bool applyResonance, bool forGUI, boo
 
     if (oscilupdate.checkUpdated())
         prepare();
+}
+
+
+void OscilGen::buildSpectrum(float freqHz, bool applyResonance, bool forGUI, bool forPAD, size_t maxHarmonic)
+{
+    assert(freqHz > 0.0);
+    prepareIfChanged();
 
     // start harmonic randomisation from local randseed, drawn in ADnote::ADnote()
     // see also comment at OscilGen::reseed()
@@ -1256,6 +1569,8 @@ void OscilGen::buildSpectrum(float freqHz, bool applyResonance, bool forGUI, boo
         nyquist = specLen;
     if (nyquist > specLen)
         nyquist = specLen;
+    if (maxHarmonic < nyquist - 2)
+        nyquist = maxHarmonic + 2;
 
     size_t realnyquist = nyquist;
 
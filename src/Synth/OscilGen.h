@@ -29,9 +29,15 @@
 
 #include <sys/types.h>
 #include <limits.h>
+#include <cstdint>
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 #include "DSP/FFTwrapper.h"
+#include "Misc/BuildScheduler.h"
 #include "Misc/RandomGen.h"
 #include "Misc/WaveShapeSamples.h"
 #include "Params/OscilParameters.h"
@@ -40,11 +46,44 @@
 class SynthEngine;
 
 
+/* Band-limited renderings of the oscillator spectrum, used by ADnote to avoid
+ * an inverse FFT on each note-on. There is one table per semitone of harmonic
+ * limit (fewer for large oscillator sizes, see OscilGen.cpp), highest limit first;
+ * a note picks the most complete table which does not exceed its Nyquist frequency.
+ */
+class OscilTables
+{
+    public:
+        fft::Spectrum source;             // the oscillator spectrum the tables were rendered from
+        std::vector<size_t> limit;        // highest harmonic contained in each table
+        std::vector<fft::Waveform> waves;
+
+        OscilTables(size_t spectrumSize)
+            : source{spectrumSize}
+            , limit{}
+            , waves{}
+        { }
+        // shall not be copied or moved
+        OscilTables(OscilTables&&)                 = delete;
+        OscilTables(OscilTables const&)            = delete;
+        OscilTables& operator=(OscilTables&&)      = delete;
+        OscilTables& operator=(OscilTables const&) = delete;
+
+        fft::Waveform const* select(size_t harmonics) const
+        {
+            for (size_t i = 0; i < limit.size(); ++i)
+                if (limit[i] <= harmonics)
+                    return &waves[i];
+            return nullptr;
+        }
+};
+
+
 class OscilGen : private WaveShapeSamples
 {
     public:
         OscilGen(fft::Calc&, Resonance* res_, SynthEngine* _synth, OscilParameters* params_);
-       ~OscilGen() = default;
+       ~OscilGen();
 
         // shall not be copied or moved or assigned
         OscilGen(OscilGen&&)                 = delete;
@@ -58,6 +97,8 @@ class OscilGen : private WaveShapeSamples
         void prepare();
 
         void getWave(fft::Waveform&, float freqHz, bool applyResonance =false, bool forGUI =false);
+        void requestTables(task::Priority =task::INTERACTIVE);
+        void buildTables();
         std::vector<float> getSpectrumForPAD(float freqHz);
 
         // Get just the phase of the oscillator.
@@ -85,6 +126,8 @@ class OscilGen : private WaveShapeSamples
         void forceUpdate();
 
     private:
+        OscilGen(fft::Calc&, Resonance*, SynthEngine*, OscilParameters*, bool tableBuilder);
+
         OscilParameters *params;
 
         SynthEngine *synth;
@@ -97,7 +140,18 @@ class OscilGen : private WaveShapeSamples
         // the magnituides and the phases of the sine/nonsine harmonics
 
         // OscilGen core implementation: generate the current Spectrum -> outoscilSpectrum
-        void buildSpectrum(float freqHz, bool applyResonance, bool forGUI, bool forPAD);
+        void buildSpectrum(float freqHz, bool applyResonance, bool forGUI, bool forPAD, size_t maxHarmonic =SIZE_MAX);
+        void prepareIfChanged();
+
+        // band-limited tables for note-on, rendered in background
+        bool tablesApplicable(bool applyResonance) const;
+        bool getWaveFromTable(fft::Waveform&, size_t harmonics);
+        bool tablesMatch();
+        void runTableBuilds();
+        void awaitTableBuilds();
+        OscilTables* renderTables();
+        void publishTables(OscilTables*);
+        fft::Spectrum const& basefuncSpectrum() const;
 
         // computes the basefunction and make the FFT;
         void changebasefunction();
@@ -169,6 +223,27 @@ class OscilGen : private WaveShapeSamples
 
         RandomGen basePrng;
         RandomGen harmonicPrng;
+
+        uint spectrumVersion;        // counts each prepare()
+
+        // note-on tables: only touched by the audio thread...
+        std::unique_ptr<OscilTables> tables;
+        OscilTables const* checkedTables;
+        uint checkedVersion;
+        bool tablesMatching;
+        // ...handed over from and back to the background build
+        std::atomic<OscilTables*> freshTables;
+        std::atomic<OscilTables*> retiredTables;
+
+        // background build, requested from the non-audio side on parameter changes;
+        // the spectrum is computed by a separate instance, like the GUI does
+        const bool isTableBuilder;
+        std::unique_ptr<OscilGen> tableBuilder;
+        std::unique_ptr<fft::Spectrum> builderBasefunc; // not to write the shared parameters
+        std::mutex buildMtx;
+        std::condition_variable buildDone;
+        bool buildQueued;
+        bool buildAgain;
 };
 
 // allow to mark this OscilGen as "dirty" to force recalculation of spectrum
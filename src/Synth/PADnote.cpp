@@ -489,6 +489,14 @@ void PADnote::noteout(float *outl,float *outr)
         }
     }
 
+    // Stop a released note which stayed inaudible for a while
+    if (noteStatus == NOTE_ENABLED && noteGlobal.ampEnvelope->released()
+        && cull.silent(synth.noteCull, outl, outr, synth.sent_buffersize))
+    {
+        noteStatus = NOTE_DISABLED;
+        return;
+    }
+
     // Check global envelope and discard this note when finished.
     if (noteGlobal.ampEnvelope->finished() != 0)
     {
@@ -28,6 +28,9 @@
 #ifndef PAD_NOTE_H
 #define PAD_NOTE_H
 
+#include "Misc/NotePool.h"
+#include "Synth/NoteCull.h"
+
 #include <memory>
 
 using std::unique_ptr;
@@ -42,7 +45,7 @@ class Controller;
 
 class SynthEngine;
 
-class PADnote
+class PADnote : public NotePooled
 {
     public:
         PADnote(PADnoteParameters& parameters, Controller& ctl_, Note, bool portamento_);
@@ -61,6 +64,8 @@ class PADnote
 
         void noteout(float* outl, float* outr);
         bool finished() const { return noteStatus == NOTE_DISABLED; }
+        float getLevel() const { return noteStatus == NOTE_ENABLED? globalnewamplitude : 0.0f; } // of the amplitude envelope
+        bool culled() const { return cull.culled(); }
         void releasekey();
 
     private:
@@ -84,6 +89,7 @@ class PADnote
             NOTE_ENABLED,
             NOTE_LEGATOFADEOUT
         } noteStatus;
+        NoteCull cull;
 
         unique_ptr<WaveInterpolator> waveInterpolator;
 
@@ -77,8 +77,8 @@ SUBnote::SUBnote(SUBnoteParameters& parameters, Controller& ctl_, Note note_, bo
     , volumeAdjustment{1.0f}
     , lfilter{}
     , rfilter{}
-    , tmpsmp{synth.getRuntime().genTmp1}
-    , tmprnd{synth.getRuntime().genTmp2}
+    , lbank{}
+    , rbank{}
     , oldpitchwheel{0}
     , oldbandwidth{64}
     , legatoFade{1.0f}       // Full volume
@@ -133,8 +133,8 @@ SUBnote::SUBnote(SUBnote const& orig)
     , newamplitude{orig.newamplitude}
     , lfilter{}
     , rfilter{}
-    , tmpsmp{orig.synth.getRuntime().genTmp1}
-    , tmprnd{orig.synth.getRuntime().genTmp2}
+    , lbank{}
+    , rbank{}
     , oldpitchwheel{orig.oldpitchwheel}
     , oldbandwidth{orig.oldbandwidth}
     , legatoFade{0.0f}     // Silent by default
@@ -165,15 +165,21 @@ SUBnote::SUBnote(SUBnote const& orig)
 
     if (orig.lfilter)
     {
-        lfilter.reset(new bpfilter[numstages * numharmonics]);
+        lfilter.reset(numstages * numharmonics);
         memcpy(lfilter.get(), orig.lfilter.get(),
             numstages * numharmonics * sizeof(bpfilter));
+        lbank.reset(numstages * numharmonics);
+        memcpy(lbank.get(), orig.lbank.get(),
+            numstages * numharmonics * sizeof(biquad::Section));
     }
     if (orig.rfilter)
     {
-        rfilter.reset(new bpfilter[numstages * numharmonics]);
+        rfilter.reset(numstages * numharmonics);
         memcpy(rfilter.get(), orig.rfilter.get(),
             numstages * numharmonics * sizeof(bpfilter));
+        rbank.reset(numstages * numharmonics);
+        memcpy(rbank.get(), orig.rbank.get(),
+            numstages * numharmonics * sizeof(biquad::Section));
     }
 }
 
@@ -226,6 +232,8 @@ void SUBnote::killNote()
     {
         lfilter.reset();
         rfilter.reset();
+        lbank.reset();
+        rbank.reset();
         ampEnvelope.reset();
         freqEnvelope.reset();
         bandWidthEnvelope.reset();
@@ -256,16 +264,26 @@ int SUBnote::createNewFilters()
     if (numharmonics == origNumHarmonics)
         return 0;
 
-    bpfilter *newFilter = new bpfilter[numstages * numharmonics];
+    PooledArray<bpfilter> newFilter{size_t(numstages * numharmonics)};
+    PooledArray<biquad::Section> newBank{size_t(numstages * numharmonics)};
     if (lfilter)
-        memcpy(newFilter, lfilter.get(), numstages * origNumHarmonics * sizeof(bpfilter));
-    lfilter.reset(newFilter);
+    {
+        memcpy(newFilter.get(), lfilter.get(), numstages * origNumHarmonics * sizeof(bpfilter));
+        memcpy(newBank.get(), lbank.get(), numstages * origNumHarmonics * sizeof(biquad::Section));
+    }
+    lfilter = std::move(newFilter);
+    lbank = std::move(newBank);
     if (stereo)
     {
-        newFilter = new bpfilter[numstages * numharmonics];
+        newFilter.reset(numstages * numharmonics);
+        newBank.reset(numstages * numharmonics);
         if (rfilter)
-            memcpy(newFilter, rfilter.get(), numstages * origNumHarmonics * sizeof(bpfilter));
-        rfilter.reset(newFilter);
+        {
+            memcpy(newFilter.get(), rfilter.get(), numstages * origNumHarmonics * sizeof(bpfilter));
+            memcpy(newBank.get(), rbank.get(), numstages * origNumHarmonics * sizeof(biquad::Section));
+        }
+        rfilter = std::move(newFilter);
+        rbank = std::move(newBank);
     }
 
     return numharmonics - origNumHarmonics;
@@ -309,7 +327,7 @@ void SUBnote::computeNoteParameters()
 }
 
 // Compute the filters coefficients
-void SUBnote::computefiltercoefs(bpfilter &filter, float freq, float bw, float gain)
+void SUBnote::computefiltercoefs(bpfilter const& filter, biquad::Coeffs& coef, float freq, float bw, float gain)
 {
     if (freq > synth.halfsamplerate_f - 200.0f)
     {
@@ -326,10 +344,11 @@ void SUBnote::computefiltercoefs(bpfilter &filter, float freq, float bw, float g
     if (alpha > bw)
         alpha = bw;
 
-    filter.b0 = alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.b2 = -alpha / (1.0f + alpha) * filter.amp * gain;
-    filter.a1 = -2.0f * cs / (1.0f + alpha);
-    filter.a2 = (1.0f - alpha) / (1.0f + alpha);
+    coef.b0 = alpha / (1.0f + alpha) * filter.amp * gain;
+    coef.b1 = 0.0f;
+    coef.b2 = -alpha / (1.0f + alpha) * filter.amp * gain;
+    coef.d1 = 2.0f * cs / (1.0f + alpha);          // = -a1
+    coef.d2 = -(1.0f - alpha) / (1.0f + alpha);    // = -a2
 }
 
 
@@ -342,22 +361,23 @@ void SUBnote::initfilters(int startIndex)
 
         for (int nph = 0; nph < numstages; ++nph)
         {
-            initfilter(lfilter[nph + n * numstages], hgain);
+            int idx = nph + n * numstages;
+            initfilter(lfilter[idx], lbank[idx].state, hgain);
             if (stereo)
-                initfilter(rfilter[nph + n * numstages], hgain);
+                initfilter(rfilter[idx], rbank[idx].state, hgain);
         }
     }
 }
 
-void SUBnote::initfilter(bpfilter &filter, float mag)
+void SUBnote::initfilter(bpfilter const& filter, biquad::State& state, float mag)
 {
-    filter.xn1 = 0.0f;
-    filter.xn2 = 0.0f;
+    state.x1 = 0.0f;
+    state.x2 = 0.0f;
 
     if (start == 0)
     {
-        filter.yn1 = 0.0f;
-        filter.yn2 = 0.0f;
+        state.y1 = 0.0f;
+        state.y2 = 0.0f;
     }
     else
     {
@@ -365,119 +385,20 @@ void SUBnote::initfilter(bpfilter &filter, float mag)
         float p = synth.numRandom() * TWOPI;
         if (start == 1)
             a *= synth.numRandom();
-        filter.yn1 = a * cosf(p);
-        filter.yn2 = a * cosf(p + filter.freq * TWOPI / synth.samplerate_f);
+        state.y1 = a * cosf(p);
+        state.y2 = a * cosf(p + filter.freq * TWOPI / synth.samplerate_f);
 
         // correct the error of computation the start amplitude
         // at very high frequencies
         if (filter.freq > synth.samplerate_f * 0.96f)
         {
-            filter.yn1 = 0.0f;
-            filter.yn2 = 0.0f;
+            state.y1 = 0.0f;
+            state.y2 = 0.0f;
         }
     }
 }
 
 
-// Do the filtering
-inline void SubFilterA(const float coeff[4], float &src, float work[4])
-{
-    work[3] = src*coeff[0]+work[1]*coeff[1]+work[2]*coeff[2]+work[3]*coeff[3];
-    work[1] = src;
-    src     = work[3];
-}
-
-
-inline void SubFilterB(const float coeff[4], float &src, float work[4])
-{
-    work[2] = src*coeff[0]+work[0]*coeff[1]+work[3]*coeff[2]+work[2]*coeff[3];
-    work[0] = src;
-    src     = work[2];
-}
-
-
-// ported from zynaddsubfx V 2.4.4
-//This dance is designed to minimize unneeded memory operations which can result
-//in quite a bit of wasted time
-void SUBnote::filter(bpfilter &filter, float *smps)
-{
-    if (synth.getRuntime().isLV2){
-        filterVarRun(filter, smps);
-        return;
-    }
-
-    int remainder = synth.sent_buffersize % 8;
-    int blocksize = synth.sent_buffersize - remainder;
-    float coeff[4] = {filter.b0, filter.b2,  -filter.a1, -filter.a2};
-    float work[4]  = {filter.xn1, filter.xn2, filter.yn1, filter.yn2};
-
-    for (int i = 0; i < blocksize; i += 8)
-    {
-        SubFilterA(coeff, smps[i + 0], work);
-        SubFilterB(coeff, smps[i + 1], work);
-        SubFilterA(coeff, smps[i + 2], work);
-        SubFilterB(coeff, smps[i + 3], work);
-        SubFilterA(coeff, smps[i + 4], work);
-        SubFilterB(coeff, smps[i + 5], work);
-        SubFilterA(coeff, smps[i + 6], work);
-        SubFilterB(coeff, smps[i + 7], work);
-    }
-    if (remainder > 0)
-    {
-        for (int i = blocksize; i < blocksize + remainder ; i += 2)
-        {
-            SubFilterA(coeff, smps[i + 0], work);
-            SubFilterB(coeff, smps[i + 1], work);
-        }
-    }
-    filter.xn1 = work[0];
-    filter.xn2 = work[1];
-    filter.yn1 = work[2];
-    filter.yn2 = work[3];
-}
-
-
-//Andrew Deryabin: support for variable-length runs
-//currently only for lv2 plugin
-void SUBnote::filterVarRun(SUBnote::bpfilter &filter, float *smps)
-{
-    float tmpout;
-    int runLength = synth.sent_buffersize;
-    int i = 0;
-    if (runLength >= 8){
-        float coeff[4] = {filter.b0, filter.b2,  -filter.a1, -filter.a2};
-        float work[4]  = {filter.xn1, filter.xn2, filter.yn1, filter.yn2};
-        while (runLength >= 8){
-            SubFilterA(coeff, smps[i + 0], work);
-            SubFilterB(coeff, smps[i + 1], work);
-            SubFilterA(coeff, smps[i + 2], work);
-            SubFilterB(coeff, smps[i + 3], work);
-            SubFilterA(coeff, smps[i + 4], work);
-            SubFilterB(coeff, smps[i + 5], work);
-            SubFilterA(coeff, smps[i + 6], work);
-            SubFilterB(coeff, smps[i + 7], work);
-            i += 8;
-            runLength -= 8;
-        }
-        filter.xn1 = work[0];
-        filter.xn2 = work[1];
-        filter.yn1 = work[2];
-        filter.yn2 = work[3];
-    }
-
-    for (; i < synth.sent_buffersize; ++i){
-        tmpout=smps[i] * filter.b0 + filter.b2 * filter.xn2
-               -filter.a1 * filter.yn1 - filter.a2 * filter.yn2;
-        filter.xn2=filter.xn1;
-        filter.xn1=smps[i];
-        filter.yn2=filter.yn1;
-        filter.yn1=tmpout;
-        smps[i]=tmpout;
-    }
-
-}
-
-
 // Init Parameters
 void SUBnote::initparameters(float freq)
 {
@@ -571,9 +492,10 @@ void SUBnote::computeallfiltercoefs()
                 gain = tmpgain;
             else
                 gain = 1.0f;
-            computefiltercoefs(lfilter[nph + n * numstages],
-                               lfilter[nph + n *numstages].freq * envfreq,
-                               lfilter[nph + n * numstages].bw * envbw, gain);
+            int idx = nph + n * numstages;
+            computefiltercoefs(lfilter[idx], lbank[idx].coef,
+                               lfilter[idx].freq * envfreq,
+                               lfilter[idx].bw * envbw, gain);
         }
     }
     if (stereo)
@@ -585,9 +507,10 @@ void SUBnote::computeallfiltercoefs()
                     gain = tmpgain;
                 else
                     gain = 1.0f;
-                computefiltercoefs(rfilter[nph + n * numstages],
-                                   rfilter[nph + n * numstages].freq * envfreq,
-                                   rfilter[nph + n * numstages].bw * envbw, gain);
+                int idx = nph + n * numstages;
+                computefiltercoefs(rfilter[idx], rbank[idx].coef,
+                                   rfilter[idx].freq * envfreq,
+                                   rfilter[idx].bw * envbw, gain);
             }
         }
     oldbandwidth = ctl.bandwidth.data;
@@ -636,8 +559,7 @@ void SUBnote::computecurrentparameters()
 // Note Output
 void SUBnote::noteout(float *outl, float *outr)
 {
-    assert(tmpsmp.get() == synth.getRuntime().genTmp1.get());
-    assert(tmprnd.get() == synth.getRuntime().genTmp2.get());
+    Samples& tmprnd = synth.scratch().genTmp2; // this is filled with random numbers
     memset(outl, 0, synth.sent_bufferbytes);
     memset(outr, 0, synth.sent_bufferbytes);
     if (noteStatus == NOTE_DISABLED) return;
@@ -651,15 +573,9 @@ void SUBnote::noteout(float *outl, float *outr)
     // left channel
     for (int i = 0; i < synth.sent_buffersize; ++i)
         tmprnd[i] = synth.numRandom() * 2.0f - 1.0f;
-    for (int n = 0; n < numharmonics; ++n)
-    {
-        float rolloff = overtone_rolloff[n];
-        memcpy(tmpsmp.get(), tmprnd.get(), synth.sent_bufferbytes);
-        for (int nph = 0; nph < numstages; ++nph)
-            filter(lfilter[nph + n * numstages], tmpsmp.get());
-        for (int i = 0; i < synth.sent_buffersize; ++i)
-            outl[i] += tmpsmp[i] * rolloff;
-    }
+    // all harmonics are filtered from the same noise, several at once
+    biquad::mixBank(tmprnd.get(), outl, synth.sent_buffersize,
+                    lbank.get(), overtone_rolloff, numharmonics, numstages);
 
     if (globalFilterL != NULL)
         globalFilterL->filterout(outl);
@@ -669,15 +585,8 @@ void SUBnote::noteout(float *outl, float *outr)
     {
         for (int i = 0; i < synth.sent_buffersize; ++i)
             tmprnd[i] = synth.numRandom() * 2.0f - 1.0f;
-        for (int n = 0; n < numharmonics; ++n)
-        {
-            float rolloff = overtone_rolloff[n];
-            memcpy(tmpsmp.get(), tmprnd.get(), synth.sent_bufferbytes);
-            for (int nph = 0; nph < numstages; ++nph)
-                filter(rfilter[nph + n * numstages], tmpsmp.get());
-            for (int i = 0; i < synth.sent_buffersize; ++i)
-                outr[i] += tmpsmp[i] * rolloff;
-        }
+        biquad::mixBank(tmprnd.get(), outr, synth.sent_buffersize,
+                        rbank.get(), overtone_rolloff, numharmonics, numstages);
         if (globalFilterR != NULL)
             globalFilterR->filterout(outr);
     }
@@ -755,6 +664,14 @@ void SUBnote::noteout(float *outl, float *outr)
         }
     }
 
+    // Stop a released note which stayed inaudible for a while
+    if (noteStatus == NOTE_ENABLED && ampEnvelope->released()
+        && cull.silent(synth.noteCull, outl, outr, synth.sent_buffersize))
+    {
+        killNote();
+        return;
+    }
+
     // Check if the note needs to be computed more
     if (ampEnvelope->finished() != 0)
     {
@@ -30,6 +30,9 @@
 
 #include "globals.h"
 #include "Misc/Alloc.h"
+#include "Misc/NotePool.h"
+#include "Synth/NoteCull.h"
+#include "DSP/BiquadBank.h"
 #include "Params/ParamCheck.h"
 
 #include <memory>
@@ -44,7 +47,7 @@ class Filter;
 
 class SynthEngine;
 
-class SUBnote
+class SUBnote : public NotePooled
 {
     public:
         SUBnote(SUBnoteParameters& parameters, Controller& ctl_, Note, bool portamento_);
@@ -64,6 +67,8 @@ class SUBnote
         void noteout(float* outl, float* outr);
         void releasekey();
         bool finished() const { return noteStatus == NOTE_DISABLED; }
+        float getLevel() const { return noteStatus == NOTE_ENABLED? newamplitude : 0.0f; } // of the amplitude envelope
+        bool culled() const { return cull.culled(); }
 
     private:
         void computecurrentparameters();
@@ -108,6 +113,7 @@ class SUBnote
             NOTE_ENABLED,
             NOTE_LEGATOFADEOUT
         } noteStatus;
+        NoteCull cull;
 
         int firsttick;
         float volume;
@@ -119,39 +125,28 @@ class SUBnote
             float freq;
             float bw;
             float amp;   // filter parameters
-            float a1;
-            float a2;
-            float b0;
-            float b2;    // filter coefs. b1=0
-            float xn1;
-            float xn2;
-            float yn1;
-            float yn2;   // filter internal values
         };
 
         // Returns the number of new filters created
         int createNewFilters();
 
         void initfilters(int startIndex);
-        void initfilter(bpfilter &filter, float mag);
+        void initfilter(bpfilter const& filter, biquad::State& state, float mag);
         float computerolloff(float freq);
         void computeallfiltercoefs();
-        void computefiltercoefs(bpfilter &filter, float freq, float bw, float gain);
+        void computefiltercoefs(bpfilter const& filter, biquad::Coeffs& coef, float freq, float bw, float gain);
         void computeNoteParameters();
         float computeRealFreq();
-        void filter(bpfilter &filter, float *smps);
-        void filterVarRun(bpfilter &filter, float *smps);
         float getHgain(int harmonic);
 
-        unique_ptr<bpfilter[]> lfilter;
-        unique_ptr<bpfilter[]> rfilter;
+        PooledArray<bpfilter> lfilter;
+        PooledArray<bpfilter> rfilter;
+        PooledArray<biquad::Section> lbank;  // the filters proper, as
+        PooledArray<biquad::Section> rbank;  // [harmonic * numstages + stage]
 
         float overtone_rolloff[MAX_SUB_HARMONICS];
         float overtone_freq[MAX_SUB_HARMONICS];
 
-        Samples& tmpsmp;
-        Samples& tmprnd; // this is filled with random numbers
-
         int oldpitchwheel;
         int oldbandwidth;
 
@@ -0,0 +1,248 @@
+/*
+    UnisonKernels.cpp - inner loops of the ADnote unison computation
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Synth/UnisonKernels.h"
+
+#include <cassert>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define HAVE_NEON_KERNEL
+#endif
+
+
+namespace { // implementation details
+
+    const int      ONE   = 1 << 24;   // fixed point 1.0 of the fraction
+    const uint32_t LANES = 8;         // samples per block; LANES << 24 still fits into 32 bit
+
+    /* Fixed point phase: (table slot << 24) + fraction.
+     * The former code advanced slot and fraction separately, carrying the overflow
+     * of the fraction into the slot, and wrapped the slot by mask. This is the same
+     * as advancing the combined phase modulo tableSize << 24, thus the phase of each
+     * sample within a block can be computed directly from the phase at block start.
+     */
+    struct Phase
+    {
+        uint64_t pos;
+        uint64_t step;
+        uint64_t wrap;
+
+        uint32_t hi()     const { return uint32_t(pos >> 24); }
+        uint32_t lo()     const { return uint32_t(pos & 0xffffff); }
+        uint32_t stepHi() const { return uint32_t(step >> 24); }
+        uint32_t stepLo() const { return uint32_t(step & 0xffffff); }
+
+        void advance(uint64_t cnt) { pos = (pos + cnt * step) & wrap; }
+    };
+
+    inline float interpolate(float const* wave, uint32_t hi, int frac)
+    {
+        return (wave[hi] * (ONE - frac) + wave[hi + 1] * frac) / (1.0f * ONE);
+    }
+
+
+    void blockPlain(float const* wave, Phase const& phase, uint32_t mask, float* out)
+    {
+        for (uint32_t j = 0; j < LANES; ++j)
+        {
+            uint32_t lo = phase.lo() + j * phase.stepLo();
+            uint32_t hi = (phase.hi() + j * phase.stepHi() + (lo >> 24)) & mask;
+            out[j] = interpolate(wave, hi, int(lo & 0xffffff));
+        }
+    }
+
+#ifdef HAVE_AVX2_KERNEL
+    __attribute__((target("avx2")))
+    void blockAVX2(float const* wave, Phase const& phase, uint32_t mask, float* out)
+    {
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i lo = _mm256_add_epi32(_mm256_set1_epi32(int(phase.lo())),
+                                      _mm256_mullo_epi32(lane, _mm256_set1_epi32(int(phase.stepLo()))));
+        __m256i hi = _mm256_add_epi32(_mm256_set1_epi32(int(phase.hi())),
+                                      _mm256_mullo_epi32(lane, _mm256_set1_epi32(int(phase.stepHi()))));
+        hi = _mm256_and_si256(_mm256_add_epi32(hi, _mm256_srli_epi32(lo, 24)), _mm256_set1_epi32(int(mask)));
+        lo = _mm256_and_si256(lo, _mm256_set1_epi32(0xffffff));
+
+        __m256 smp0  = _mm256_i32gather_ps(wave,     hi, sizeof(float));
+        __m256 smp1  = _mm256_i32gather_ps(wave + 1, hi, sizeof(float));
+        __m256 frac0 = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_set1_epi32(ONE), lo));
+        __m256 frac1 = _mm256_cvtepi32_ps(lo);
+        __m256 sum   = _mm256_add_ps(_mm256_mul_ps(smp0, frac0), _mm256_mul_ps(smp1, frac1));
+        // Note: multiplying by a power of 2 gives exactly the same as the division
+        _mm256_storeu_ps(out, _mm256_mul_ps(sum, _mm256_set1_ps(1.0f / ONE)));
+    }
+#endif
+
+#ifdef HAVE_NEON_KERNEL
+    /* NEON lacks gather, thus the table values are loaded lane by lane */
+    inline float32x4_t gather(float const* wave, uint32x4_t hi)
+    {
+        float32x4_t smp = vdupq_n_f32(0.0f);
+        smp = vld1q_lane_f32(wave + vgetq_lane_u32(hi, 0), smp, 0);
+        smp = vld1q_lane_f32(wave + vgetq_lane_u32(hi, 1), smp, 1);
+        smp = vld1q_lane_f32(wave + vgetq_lane_u32(hi, 2), smp, 2);
+        smp = vld1q_lane_f32(wave + vgetq_lane_u32(hi, 3), smp, 3);
+        return smp;
+    }
+
+    // always present on AArch64; the block is done as two halves of 4 lanes
+    void blockNEON(float const* wave, Phase const& phase, uint32_t mask, float* out)
+    {
+        static const uint32_t laneNum[LANES] = {0, 1, 2, 3, 4, 5, 6, 7};
+        for (uint32_t half = 0; half < LANES; half += 4)
+        {
+            uint32x4_t lane = vld1q_u32(laneNum + half);
+            uint32x4_t lo = vmlaq_u32(vdupq_n_u32(phase.lo()), lane, vdupq_n_u32(phase.stepLo()));
+            uint32x4_t hi = vmlaq_u32(vdupq_n_u32(phase.hi()), lane, vdupq_n_u32(phase.stepHi()));
+            hi = vandq_u32(vaddq_u32(hi, vshrq_n_u32(lo, 24)), vdupq_n_u32(mask));
+            lo = vandq_u32(lo, vdupq_n_u32(0xffffff));
+
+            float32x4_t smp0  = gather(wave,     hi);
+            float32x4_t smp1  = gather(wave + 1, hi);
+            float32x4_t frac0 = vcvtq_f32_u32(vsubq_u32(vdupq_n_u32(ONE), lo));
+            float32x4_t frac1 = vcvtq_f32_u32(lo);
+            // separate multiply and add; -ffp-contract=off keeps them from being fused into FMLA
+            float32x4_t sum   = vaddq_f32(vmulq_f32(smp0, frac0), vmulq_f32(smp1, frac1));
+            vst1q_f32(out + half, vmulq_f32(sum, vdupq_n_f32(1.0f / ONE)));
+        }
+    }
+#endif
+
+    using BlockKernel = void(*)(float const*, Phase const&, uint32_t, float*);
+
+    BlockKernel selectKernel()
+    {
+#ifdef HAVE_AVX2_KERNEL
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return blockAVX2;
+#endif
+#ifdef HAVE_NEON_KERNEL
+        return blockNEON;
+#endif
+        return blockPlain;
+    }
+
+    // decided once, when the program is loaded
+    BlockKernel const computeBlock = selectKernel();
+}
+
+
+namespace unison {
+
+void interpolateLinear(float const* wave, size_t tableSize,
+                       int& poshi, float& poslo, int freqhi, float freqlo,
+                       float* out, size_t cnt)
+{
+    assert(freqlo < 1.0f);
+    uint32_t mask = uint32_t(tableSize - 1);
+    Phase phase{ (uint64_t(uint32_t(poshi) & mask) << 24) + uint32_t(int(poslo * ONE))
+               , (uint64_t(uint32_t(freqhi)) << 24) + uint32_t(int(freqlo * ONE))
+               , (uint64_t(tableSize) << 24) - 1
+               };
+    size_t i = 0;
+    for ( ; i + LANES <= cnt; i += LANES)
+    {
+        computeBlock(wave, phase, mask, out + i);
+        phase.advance(LANES);
+    }
+    for ( ; i < cnt; ++i)
+    {
+        out[i] = interpolate(wave, phase.hi(), int(phase.lo()));
+        phase.advance(1);
+    }
+    poshi = int(phase.hi());
+    poslo = int(phase.lo()) / (1.0f * ONE);
+}
+
+
+void interpolateLinearScalar(float const* wave, size_t tableSize,
+                             int& poshi, float& poslo, int freqhi, float freqlo,
+                             float* out, size_t cnt)
+{
+    assert(freqlo < 1.0f);
+    int hi = poshi;
+    int lo = poslo * ONE;
+    int stepLo = freqlo * ONE;
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        out[i] = (wave[hi] * (ONE - lo) + wave[hi + 1] * lo) / (1.0f * ONE);
+        lo += stepLo;
+        hi += freqhi + (lo >> 24);
+        lo &= 0xffffff;
+        hi &= int(tableSize) - 1;
+    }
+    poshi = hi;
+    poslo = lo / (1.0f * ONE);
+}
+
+
+const char* kernelName()
+{
+#ifdef HAVE_AVX2_KERNEL
+    if (computeBlock == blockAVX2)
+        return "avx2";
+#endif
+#ifdef HAVE_NEON_KERNEL
+    if (computeBlock == blockNEON)
+        return "neon";
+#endif
+    return "plain";
+}
+
+
+void mixStereo(float const* smps, float gainL, float gainR, float* mixL, float* mixR, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        mixL[i] += smps[i] * gainL;
+        mixR[i] += smps[i] * gainR;
+    }
+}
+
+
+void mixMono(float const* smps, float* mix, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+        mix[i] += smps[i];
+}
+
+
+void mixStereoScalar(float const* smps, float gainL, float gainR, float* mixL, float* mixR, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+        mixL[i] += smps[i] * gainL;
+    for (size_t i = 0; i < cnt; ++i)
+        mixR[i] += smps[i] * gainR;
+}
+
+
+void mixMonoScalar(float const* smps, float* mix, size_t cnt)
+{
+    for (size_t i = 0; i < cnt; ++i)
+        mix[i] += smps[i];
+}
+
+}//(End)namespace unison
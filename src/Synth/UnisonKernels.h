@@ -0,0 +1,63 @@
+/*
+    UnisonKernels.h - inner loops of the ADnote unison computation
+
+    Copyright 2026, Will Godfrey & others
+
+    This file is part of yoshimi, which is free software: you can
+    redistribute it and/or modify it under the terms of the GNU General
+    Public License as published by the Free Software Foundation, either
+    version 2 of the License, or (at your option) any later version.
+
+    yoshimi is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with yoshimi.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef UNISON_KERNELS_H
+#define UNISON_KERNELS_H
+
+#include <cstddef>
+
+/* These loops dominate the cost of ADnote with large unison sizes.
+ * The wavetable is read in blocks of 8 samples, each computed independently of
+ * its predecessor; on x86 CPUs supporting AVX2 (detected at program start) a
+ * block is processed in parallel lanes, using gather to fetch the table values.
+ * On AArch64 NEON does the same, with the table values loaded lane by lane.
+ * Elsewhere the plain loop is left to the compiler's auto-vectorisation.
+ * All variants perform the same arithmetic as the former scalar code,
+ * sample by sample, thus results are bit identical. The scalar references are
+ * compiled alongside, with FMA contraction and fast-math disabled for this file,
+ * and test::KernelCheck compares both bit by bit (CLI test parameter "kernels").
+ */
+namespace unison {
+
+    /* Read the wavetable with linear interpolation for one unison subvoice.
+     * The phase is held in fixed point: poshi = table slot, poslo = fraction,
+     * and advanced by freqhi/freqlo for each sample; tableSize must be a power of 2 */
+    void interpolateLinear(float const* wave, size_t tableSize,
+                           int& poshi, float& poslo, int freqhi, float freqlo,
+                           float* out, size_t cnt);
+
+    /* the former scalar loop, sample by sample; reference for checking the above */
+    void interpolateLinearScalar(float const* wave, size_t tableSize,
+                                 int& poshi, float& poslo, int freqhi, float freqlo,
+                                 float* out, size_t cnt);
+
+    /* name of the block kernel selected for this CPU */
+    const char* kernelName();
+
+    /* add one unison subvoice into the voice mix */
+    void mixStereo(float const* smps, float gainL, float gainR, float* mixL, float* mixR, size_t cnt);
+    void mixMono(float const* smps, float* mix, size_t cnt);
+
+    /* the former per-channel loops; reference for checking the above */
+    void mixStereoScalar(float const* smps, float gainL, float gainR, float* mixL, float* mixR, size_t cnt);
+    void mixMonoScalar(float const* smps, float* mix, size_t cnt);
+}
+
+#endif /*UNISON_KERNELS_H*/
@@ -98,6 +98,11 @@ using ushort = unsigned short;
 #define MAX_OSCIL_SIZE 16384
 #define MIN_BUFFER_SIZE 16
 #define MAX_BUFFER_SIZE 8192
+#define MAX_RENDER_THREADS 16 // workers computing parts besides the audio thread
+#define MIN_NOTE_CULL_LEVEL -150 // dB, for released notes
+#define MAX_NOTE_CULL_LEVEL -60
+#define MAX_NOTE_CULL_TIME 5000 // ms, 0 = never cull
+#define MAX_INSTRUMENT_CACHE 4096 // MiB, 0 = no cache
 #define NO_MSG 255 // these two may become different
 #define UNUSED 255
 
@@ -106,7 +111,9 @@ using ushort = unsigned short;
 // Maximum in the UI is 50, but 64 unison size can happen for PWM
 // modulation. See ADnote.cpp for details.
 #define MAX_UNISON 64
-#define POLYPHONY 60 // per part!
+#define POLYPHONY 60 // per part! default voice capacity
+#define MIN_POLYPHONY 8
+#define MAX_POLYPHONY 240
 #define PART_DEFAULT_LIMIT 20
 #define NUM_SYS_EFX 4
 #define NUM_INS_EFX 8
@@ -364,6 +371,12 @@ namespace CONFIG // usage CONFIG::control::oscillatorSize
         showLearnEditor,
         enableOmni,
         enableNRPNs,
+        renderThreads,
+        noteCullLevel,  // dB below which released notes are inaudible
+        noteCullTime,   // ms spent below that level before they are stopped
+        instrumentCacheSize, // MiB of parsed bank instruments kept in memory
+        instrumentPreload,   // parse the whole current bank in the background
+        binaryState,         // save session state in compact binary form
         saveCurrentConfig,
         changeRoot, // dummy command - always save current root
         changeBank, // dummy command - always save current bank
@@ -653,6 +666,8 @@ namespace PART // usage PART::control::volume
         partToSystemEffect3,
         partToSystemEffect4,
         kitItemMute,
+        maxVoices,
+        voiceSteal,
         enableKitLine = 32, // first marked as instrument changed
         enableAdd,
         enableSub,
@@ -755,6 +770,14 @@ namespace PART // usage PART::control::volume
         };
     }
 
+    namespace stealType { // which voice makes way when all are in use
+        enum {
+            released = 0, // oldest released, else oldest
+            quietest,     // lowest amplitude envelope
+            sameKey       // already sounding this key, else as released
+        };
+    }
+
     namespace envelope
     {
         enum groupmode : int {
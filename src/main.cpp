@@ -154,6 +154,10 @@ static void* mainThread(void*)
         // Test runs single threaded and we do not want to persist test state.
         return NULL;
 
+    if (Config::primary().isOfflineRender())
+        // headless rendering leaves no traces in the persistent setup
+        return NULL;
+
     instanceManager.performShutdownActions();
 
     return NULL;